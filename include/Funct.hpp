@@ -10,8 +10,8 @@
 //
 // NOTES:
 //
-// - shift1 and shift2 need to
-//   be relatively prime to sizeof(HashKey)
+// - computeHash depends only on the set of pins
+//   in a hyperedge and costs O(len)
 //
 // ###
 
@@ -24,6 +24,7 @@
 
 #include "Macros.h"
 #include "data_structures/dynamic_array.hpp"
+#include "utility/random.hpp"
 
 #ifdef USE_SPRNG
 #define SIMPLE_SPRNG
@@ -33,33 +34,21 @@
 
 /* useful macros */
 
-#define RotateLeft(a, b)                                                       \
-  (b > (sizeof(HashKey)) ? (0) : ( ((a >> (sizeof(HashKey) - b))) | (a << b) ))
-
 template <typename T>
 T RANDOM(T a, T b) {
-#ifdef USE_SPRNG
-  return a == b ? a : (static_cast<int>(sprng() * ((b) - (a))) + (a));
-#else
-  return a == b ? a : (static_cast<int>(drand48() * ((b) - (a))) + (a));
-#endif
+  return a == b ? a : (static_cast<int>(parkway::utility::uniform() *
+                                        ((b) - (a))) + (a));
 }
 
 using parkway::data_structures::dynamic_array;
 
 class Funct {
-  static int shift1;
-  static int shift2;
-  static int maxHedgeLen;
-
   static int tableSizes[16];
 
  public:
   Funct();
   ~Funct();
 
-  inline static void setMaxHedgeLen(int m) { maxHedgeLen = m; }
-
   static void printIntro();
   static void printEnd();
 
@@ -11,6 +11,7 @@
 // ###
 
 #include "configurtion.h"
+#include "configuration.hpp"
 
 /* debug options */
 
@@ -27,15 +28,10 @@
 
 /* hash key parameters */
 
-#define KEY_UINT
-#ifdef KEY_UINT
+#ifdef PARKWAY_UINT_KEY
 #define HashKey unsigned int
-#define SLIDE1 0
-#define SLIDE2 16
 #else
 #define HashKey unsigned long long
-#define SLIDE1 16
-#define SLIDE2 48
 #endif
 
 // # random seed
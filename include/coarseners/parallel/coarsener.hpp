@@ -15,6 +15,7 @@
 #include "hypergraph/parallel/hypergraph.hpp"
 #include "hypergraph/parallel/loader.hpp"
 #include "data_structures/dynamic_array.hpp"
+#include "utility/thread_pool.hpp"
 
 namespace parkway {
 namespace parallel {
@@ -45,6 +46,20 @@ class coarsener : public loader, public parkway::base::coarsener {
     total_hypergraph_weight_ = total_weigtht;
   }
 
+  // When positive, a process with pins in a hyperedge stored elsewhere is
+  // only sent its own pins, at most this many of the remaining pins as
+  // candidates for matching, and the hyperedge's length. Hyperedges with no
+  // more candidates than that are still sent in full. The coarse hypergraph
+  // is contracted exactly by the process storing each hyperedge.
+  inline void set_summary_pins(int pins) {
+    summary_pins_ = pins;
+  }
+
+  // With more than one thread, coarsening work within the process (local
+  // matching where the coarsener supports it, and contraction) is shared
+  // between the threads of thread_pool_.
+  void set_threads(int threads);
+
  protected:
   int total_hypergraph_weight_;
   int stop_coarsening_;
@@ -52,8 +67,22 @@ class coarsener : public loader, public parkway::base::coarsener {
   int total_number_of_clusters_;
   int minimum_cluster_index_;
   double balance_constraint_;
+  int summary_pins_;
+  int threads_;
+  utility::thread_pool *thread_pool_;
 
   ds::dynamic_array<int> cluster_weights_;
+  // Length of each loaded hyperedge, only kept when summaries are sent.
+  ds::dynamic_array<int> hyperedge_lengths_;
+
+  // Length of the hyperedge in the hypergraph being coarsened, which is
+  // greater than its number of loaded pins if a summary was received.
+  inline int hyperedge_length(int hyperedge) const {
+    if (summary_pins_ > 0) {
+      return hyperedge_lengths_[hyperedge];
+    }
+    return hyperedge_offsets_[hyperedge + 1] - hyperedge_offsets_[hyperedge];
+  }
 
   void update_hypergraph_information(const hypergraph &h);
   void initialize_vertex_to_hyperedges();
@@ -67,6 +96,8 @@ class coarsener : public loader, public parkway::base::coarsener {
                             MPI_Comm comm,
                             bool check_limit = false,
                             int limit = INT_MAX);
+  void add_summary(int proc, int weight, const int *pins, int length,
+                   int vertices_per_processor);
 
   bool within_vertex_index_range(int value) const;
 };
@@ -27,6 +27,19 @@ class first_choice_coarsener : public coarsener {
   int divide_by_hyperedge_length_;
   int limit_on_index_during_coarsening_;
 
+  // If positive, match requests are sent in batches every this many local
+  // vertices visited and answered as they arrive, on match_comm_, instead of
+  // in two synchronous rounds once local matching is done.
+  int match_request_batch_;
+  int requests_sent_;
+  int replies_received_;
+  std::size_t entries_sent_;
+
+  MPI_Comm match_comm_;
+  dynamic_array<int> match_message_;
+  dynamic_array<dynamic_array<int> > match_buffers_;
+  dynamic_array<MPI_Request> match_requests_;
+
   ds::match_request_table *table_;
 
  public:
@@ -45,10 +58,25 @@ class first_choice_coarsener : public coarsener {
   void set_reply_arrays(int highToLow, int maxVertexWt);
   void process_request_replies();
   void permute_vertices_arrays(dynamic_array<int> &verts, int numLocVerts);
+  void match_locally_in_parallel(const dynamic_array<int> &verts,
+                                 int aveVertexWt);
   void set_cluster_indices(MPI_Comm comm);
+  void resolve_match_request(int vNonLocReq, int matchIndex, int cluWt);
 
   int accept(int _locV, int _nonLocCluWt, int hToLow, int _maxWt);
 
+  // ###
+  // asynchronous match requests
+  // ###
+
+  void send_match_requests();
+  void send_match_message(int proc, const int *data, int length, int tag);
+  int progress_match_requests();
+  int reply_to_match_requests(int proc, int length);
+  void finish_match_requests();
+  int accept_asynchronously(int _locV, int _nonLocCluWt, int _maxWt,
+                            int &claimed);
+
   void print_visit_order(int variable) const;
 
   inline void set_vertex_visit_order(int vO) {
@@ -62,6 +90,10 @@ class first_choice_coarsener : public coarsener {
   inline void set_divide_by_cluster_weight(int divBy) {
     divide_by_cluster_weight_ = divBy;
   }
+
+  inline void set_match_request_batch(int batch) {
+    match_request_batch_ = batch;
+  }
 };
 
 }  // namespace parallel
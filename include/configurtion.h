@@ -19,7 +19,6 @@
 //#  define LINK_HMETIS
 //#  define LINK_PATOH
 //#  define DEBUG_ALL
-#define KEY_UINT
 //#  define USE_SPRNG
 #define MEM_OPT
 //#  define MEM_CHECK
@@ -11,6 +11,7 @@
 // ###
 #include <ostream>
 #include <stack>
+#include <vector>
 #include "hypergraph/serial/hypergraph.hpp"
 #include "coarseners/serial/first_choice_coarsener.hpp"
 #include "controllers/serial/initial_bisector.hpp"
@@ -40,6 +41,13 @@ class bisection_controller {
   std::stack<serial::hypergraph *> hypergraphs_;
   ds::dynamic_array<int> best_partition_;
 
+  /* identically built controllers, each running a share of the
+     runs on its own thread - owned by this controller */
+  std::vector<bisection_controller *> workers_;
+
+  void set_bisection_weights(int totWt, int maxPartWt);
+  void bisect_in_parallel(serial::hypergraph *h, int threads);
+
  public:
   bisection_controller(int nRuns, double kT, double redFactor, int eeParam,
                        int percentile, int inc);
@@ -55,6 +63,8 @@ class bisection_controller {
 
   void bisect(serial::hypergraph *h, int maxPartWt);
 
+  inline void add_worker(bisection_controller *w) { workers_.push_back(w); }
+
   inline void set_number_of_serial_runs(int r) { number_of_serial_runs_ = r; }
 };
 
@@ -0,0 +1,97 @@
+#ifndef _BISECTION_TASK_QUEUE_HPP
+#define _BISECTION_TASK_QUEUE_HPP
+// ### bisection_task_queue.hpp ###
+//
+// Distributed queue of the pending sub-bisections of one recursive
+// bisection, for task based recursive bisection with work stealing.
+//
+// Each processor of the communicator keeps a deque of its own tasks. It
+// works on the newest (depth first, so that what it holds stays small), and
+// an idle processor asks the other processors in turn for their oldest, and
+// so largest, task. Tasks travel as a single packed int array: the
+// sub-hypergraph, its map to the original vertices, its part and depth.
+//
+// A task of depth d stands for 2^d - 1 bisections. Processors report the
+// bisections they carry out, or skip because their sub-hypergraph is empty,
+// to processor 0, which tells every processor to stop once every bisection
+// is accounted for. Steal requests still in flight
+// are then answered under a non-blocking barrier before the queue's
+// duplicate of the communicator is freed.
+//
+// Processors only answer steal requests between tasks, from run().
+//
+// ###
+#include <deque>
+#include <functional>
+#include "mpi.h"
+#include "controllers/serial/bisection.hpp"
+#include "data_structures/dynamic_array.hpp"
+
+namespace parkway {
+namespace serial {
+
+class bisection_task_queue {
+ public:
+  typedef std::function<void(bisection *)> handler;
+
+  // Collective over comm. 'bisections' is the total number of bisections
+  // that make up the recursive bisection.
+  bisection_task_queue(MPI_Comm comm, int bisections);
+  ~bisection_task_queue();
+
+  bisection_task_queue(const bisection_task_queue &) = delete;
+  bisection_task_queue &operator=(const bisection_task_queue &) = delete;
+
+  // The queue owns the task, and its hypergraph, until it is passed on.
+  inline void push(bisection *b) {
+    tasks_.push_back(b);
+  }
+
+  // Records that this processor has carried out (or skipped) n bisections.
+  inline void complete(int n) {
+    completed_ += n;
+  }
+
+  // Collective over comm. Passes tasks, this processor's and stolen ones,
+  // to 'bisect' until every bisection has been completed. 'bisect' takes
+  // ownership of the task, may push() new ones and must complete() those
+  // it carries out.
+  void run(const handler &bisect);
+
+ protected:
+  static const int steal_tag = 1;
+  static const int task_tag = 2;
+  static const int completed_tag = 3;
+  static const int stop_tag = 4;
+
+  void serve();
+  void report_completed();
+  void request_task();
+  void send_task(int processor);
+  void receive_task(const MPI_Status &status);
+  void drain();
+
+  void pack(const bisection &b, ds::dynamic_array<int> &packed) const;
+  bisection *unpack(const ds::dynamic_array<int> &packed) const;
+
+  MPI_Comm comm_;
+  int rank_;
+  int processors_;
+
+  int total_bisections_;
+  int completed_;
+  int reported_;
+  // processor 0 only: bisections reported by every processor
+  int all_completed_;
+
+  int next_victim_;
+  bool stealing_;
+  bool stopped_;
+
+  std::deque<bisection *> tasks_;
+};
+
+}  // namespace serial
+}  // namespace parkway
+
+#endif
@@ -20,6 +20,7 @@
 #include "controllers/serial/v_cycle_final.hpp"
 #include "controllers/serial/v_cycle_all.hpp"
 #include "controllers/serial/bisection.hpp"
+#include "controllers/serial/bisection_task_queue.hpp"
 #include "refiners/serial/greedy_k_way_refiner.hpp"
 #include "hypergraph/parallel/hypergraph.hpp"
 namespace parallel = parkway::parallel;
@@ -38,6 +39,14 @@ class recursive_bisection_contoller : public parkway::serial::controller {
   double average_part_weight_;
   double average_initial_bisection_weight_;
 
+  // ###
+  // with work stealing, sub-bisections left to single
+  // processors are queued as tasks shared by all replicas
+  // ###
+
+  bool work_stealing_;
+  parkway::serial::bisection_task_queue *tasks_;
+
   parkway::serial::bisection_controller *bisector_;
   parkway::serial::greedy_k_way_refiner *refiner_;
 
@@ -53,11 +62,14 @@ class recursive_bisection_contoller : public parkway::serial::controller {
 
   void display_options() const;
   void convToBisectionConstraints();
+  void run_on_replicas();
 
   void run(parallel::hypergraph &hgraph, MPI_Comm comm);
   void initialize_serial_partitions(parallel::hypergraph &hgraph,
                                         MPI_Comm comm);
   void recursively_bisect(const bisection &b, MPI_Comm comm);
+  void bisect_task(bisection *b);
+  void record_final_parts(const bisection &b);
 
   void split_bisection(const bisection &b, bisection *&newB,
                        MPI_Comm comm) const;
@@ -68,6 +80,7 @@ class recursive_bisection_contoller : public parkway::serial::controller {
   double recursively_compute_maximum(double ave, int depth) const;
 
   inline void set_number_of_bisections(int bRuns) { number_of_bisections_ = bRuns; }
+  inline void set_work_stealing(bool w) { work_stealing_ = w; }
 };
 
 #endif
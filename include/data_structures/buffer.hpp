@@ -0,0 +1,167 @@
+#ifndef DATA_STRUCTURES_BUFFER_HPP_
+#define DATA_STRUCTURES_BUFFER_HPP_
+// ### buffer.hpp ###
+//
+// Lightweight owning array for the hot per-vertex and per-hyperedge arrays.
+//
+// Unlike dynamic_array a buffer is not reference counted (it can be moved but
+// not copied), indexing is unchecked and never grows the array, and resize()
+// leaves new elements uninitialised for trivial types. Arrays that are always
+// filled (or explicitly zeroed) before being read therefore cost neither a
+// zero-fill on allocation nor a bounds check on every access.
+//
+// ###
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include "data_structures/span.hpp"
+
+namespace parkway {
+namespace data_structures {
+
+template <typename T> class buffer {
+  static_assert(std::is_trivial<T>::value,
+                "buffer only holds trivial types");
+
+ public:
+  typedef T value_type;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef T* iterator;
+  typedef const T* const_iterator;
+  typedef std::size_t size_type;
+
+  buffer() : size_(0), capacity_(0) {
+  }
+
+  // The elements are left uninitialised.
+  explicit buffer(size_type size) : size_(0), capacity_(0) {
+    resize(size);
+  }
+
+  buffer(size_type size, const_reference value) : size_(0), capacity_(0) {
+    assign(size, value);
+  }
+
+  buffer(buffer &&other)
+      : data_(std::move(other.data_)),
+        size_(other.size_),
+        capacity_(other.capacity_) {
+    other.size_ = 0;
+    other.capacity_ = 0;
+  }
+
+  buffer &operator=(buffer &&other) {
+    data_ = std::move(other.data_);
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.size_ = 0;
+    other.capacity_ = 0;
+    return *this;
+  }
+
+  buffer(const buffer &) = delete;
+  buffer &operator=(const buffer &) = delete;
+
+
+  // Access
+  inline reference operator[](size_type position) {
+    return data_[position];
+  }
+
+  inline const_reference operator[](size_type position) const {
+    return data_[position];
+  }
+
+  inline T *data() {
+    return data_.get();
+  }
+
+  inline const T *data() const {
+    return data_.get();
+  }
+
+  inline span<T> view() {
+    return span<T>(data_.get(), size_);
+  }
+
+  inline span<const T> view() const {
+    return span<const T>(data_.get(), size_);
+  }
+
+
+  // Iterators
+  inline iterator begin() {
+    return data_.get();
+  }
+
+  inline const_iterator begin() const {
+    return data_.get();
+  }
+
+  inline iterator end() {
+    return data_.get() + size_;
+  }
+
+  inline const_iterator end() const {
+    return data_.get() + size_;
+  }
+
+
+  // Capacity
+  inline bool empty() const {
+    return size_ == 0;
+  }
+
+  inline size_type size() const {
+    return size_;
+  }
+
+  inline size_type capacity() const {
+    return capacity_;
+  }
+
+
+  // Modifiers
+
+  // Keeps the first min(size(), count) elements; any new elements are left
+  // uninitialised. Only reallocates when growing beyond the capacity.
+  inline void resize(size_type count) {
+    if (count > capacity_) {
+      // new T[] without an initialiser default-initialises, which leaves
+      // trivial types uninitialised.
+      std::unique_ptr<T[]> grown(new T[count]);
+      std::copy(data_.get(), data_.get() + size_, grown.get());
+      data_ = std::move(grown);
+      capacity_ = count;
+    }
+    size_ = count;
+  }
+
+  inline void assign(size_type count, const_reference value) {
+    size_ = 0;
+    resize(count);
+    std::fill(data_.get(), data_.get() + size_, value);
+  }
+
+  inline void fill(const_reference value) {
+    std::fill(data_.get(), data_.get() + size_, value);
+  }
+
+  inline void clear_and_shrink() {
+    data_.reset();
+    size_ = 0;
+    capacity_ = 0;
+  }
+
+ private:
+  std::unique_ptr<T[]> data_;
+  size_type size_;
+  size_type capacity_;
+};
+
+}  // namespace data_structures
+}  // namespace parkway
+
+#endif  // DATA_STRUCTURES_BUFFER_HPP_
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include "data_structures/span.hpp"
 #include "utility/sorting.hpp"
 #include "utility/random.hpp"
 
@@ -111,6 +112,15 @@ template <typename T> class dynamic_array {
     return data_->data();
   }
 
+  // Unchecked view of the current contents; see span.hpp.
+  inline span<value_type> view() {
+    return span<value_type>(data_->data(), data_->size());
+  }
+
+  inline span<const value_type> view() const {
+    return span<const value_type>(data_->data(), data_->size());
+  }
+
 
   // Iterators
   inline iterator begin() {
@@ -0,0 +1,156 @@
+#ifndef DATA_STRUCTURES_GAIN_BUCKET_QUEUE_HPP_
+#define DATA_STRUCTURES_GAIN_BUCKET_QUEUE_HPP_
+// ### gain_bucket_queue.hpp ###
+//
+// Bucket priority queue of items (vertices) keyed by an integer gain in
+// [-max_gain, max_gain], as used by the gain-ordered refiners.
+//
+// Unlike the pointer-linked bucket_node arrays it replaced, every bucket is a
+// doubly linked list threaded through flat per-item next/previous index
+// arrays, so the queue is three int arrays plus two per bucket and is
+// allocated once.
+// Items are inserted at the front of their bucket (taken last in, first out)
+// or, with insert_back(), at its back (first in, first out).
+//
+// Non-empty buckets are marked in a two level bitmap: one bit per bucket,
+// and one bit per 64 bucket word that has any bit set. When the highest
+// bucket empties the next one down is found from the bitmap with a couple of
+// leading zero counts instead of a scan over the empty buckets, which is what
+// keeps top() constant time when gains are spread over a wide range.
+//
+// ###
+#include <climits>
+#include <cstdint>
+#include "data_structures/buffer.hpp"
+
+namespace parkway {
+namespace data_structures {
+
+class gain_bucket_queue {
+ public:
+  // Returned by next_key_below() when there is no lower non-empty bucket.
+  static const int no_key = INT_MIN;
+
+  gain_bucket_queue() : max_gain_(0), max_bucket_(-1), size_(0) {
+  }
+
+  // Empty queue for items [0, items) with gains in [-max_gain, max_gain].
+  void reset(int items, int max_gain);
+  void clear_and_shrink();
+
+  inline bool empty() const {
+    return size_ == 0;
+  }
+
+  inline int size() const {
+    return size_;
+  }
+
+  inline bool contains(int item) const {
+    return previous_[item] != not_queued;
+  }
+
+  inline int key(int item) const {
+    return key_[item];
+  }
+
+  // The item with the highest gain. The queue must not be empty.
+  inline int top() const {
+    return head_[max_bucket_];
+  }
+
+  inline int top_key() const {
+    return max_bucket_ - max_gain_;
+  }
+
+  // Walks a bucket in the order items would be taken from it: first(gain)
+  // is its front item, next(item) the one after, and -1 ends the bucket.
+  inline int first(int gain) const {
+    return head_[gain + max_gain_];
+  }
+
+  inline int next(int item) const {
+    return next_[item];
+  }
+
+  // The highest gain below 'gain' whose bucket is not empty, or no_key.
+  inline int next_key_below(int gain) const {
+    int bucket = highest_bucket_below(gain + max_gain_);
+    return bucket < 0 ? no_key : bucket - max_gain_;
+  }
+
+  void insert(int item, int gain);
+  void insert_back(int item, int gain);
+  void remove(int item);
+
+  // Inserts the item, or moves it to the bucket of its new gain.
+  inline void update(int item, int gain) {
+    if (contains(item)) {
+      if (key_[item] == gain) {
+        return;
+      }
+      remove(item);
+    }
+    insert(item, gain);
+  }
+
+  inline int pop() {
+    int item = top();
+    remove(item);
+    return item;
+  }
+
+  // Removes every item, in time proportional to the number queued.
+  void clear();
+
+ protected:
+  static const int not_queued = -2;
+  static const int word_bits = 64;
+
+  inline static int highest_bit(std::uint64_t word) {
+#ifdef __GNUC__
+    return word_bits - 1 - __builtin_clzll(word);
+#else
+    int bit = 0;
+    while (word >>= 1) {
+      ++bit;
+    }
+    return bit;
+#endif
+  }
+
+  inline void mark(int bucket) {
+    int word = bucket / word_bits;
+    occupied_[word] |= std::uint64_t(1) << (bucket % word_bits);
+    summary_[word / word_bits] |= std::uint64_t(1) << (word % word_bits);
+  }
+
+  inline void unmark(int bucket) {
+    int word = bucket / word_bits;
+    occupied_[word] &= ~(std::uint64_t(1) << (bucket % word_bits));
+    if (occupied_[word] == 0) {
+      summary_[word / word_bits] &= ~(std::uint64_t(1) << (word % word_bits));
+    }
+  }
+
+  // The highest non-empty bucket below 'bucket', or -1.
+  int highest_bucket_below(int bucket) const;
+
+  int max_gain_;
+  int max_bucket_;
+  int size_;
+
+  buffer<int> head_;
+  buffer<int> tail_;
+  buffer<int> next_;
+  buffer<int> previous_;
+  buffer<int> key_;
+
+  buffer<std::uint64_t> occupied_;
+  buffer<std::uint64_t> summary_;
+};
+
+}  // namespace data_structures
+}  // namespace parkway
+
+#endif  // DATA_STRUCTURES_GAIN_BUCKET_QUEUE_HPP_
@@ -1,49 +1,82 @@
 #ifndef _DATA_SRUCTURES_INTERNAL_TABLE_UTILS_HPP
 #define _DATA_SRUCTURES_INTERNAL_TABLE_UTILS_HPP
 
-#include "data_structures/dynamic_array.hpp"
-#include "data_structures/complete_binary_tree.hpp"
 
 namespace parkway {
 namespace data_structures {
 namespace internal {
 namespace hashes {
 
-template<typename Type> Type primary(const Type a, const Type b) {
-  return a % b;
+// The tables are open addressed with linear probing over a power of two
+// number of slots, so neither the home slot nor the next slot costs a
+// division and consecutive probes stay in the same cache line. Keys are
+// either scattered (table_utils::scatter_key) or hash keys, so their low
+// bits are already well mixed.
+template<typename Type> int home(const Type key, const int capacity) {
+  return static_cast<int>(key & static_cast<Type>(capacity - 1));
 }
 
-template<typename Type> Type secondary(const Type a, const Type b) {
-  return 1 + (a % (b - 1));
-}
-
-template<typename Type> Type chained(const int slot, Type a, Type b) {
-  return (slot + secondary(a, b)) % b;
+inline int next(const int slot, const int capacity) {
+  return (slot + 1) & (capacity - 1);
 }
 
 }  // namespace hashes
 
 class table_utils {
  protected:
-  static complete_binary_tree<int> table_size_tree_;
-  static dynamic_array<int> scatter_array_;
   static int scatter_size_;
+  static unsigned int scatter_mask_;
+  static unsigned int scatter_seed_;
+  static int scatter_shift_;
+
+  // One round of a seeded multiply-xorshift mixer modulo scatter_mask_ + 1.
+  // Every step is invertible, so the round is a bijection on
+  // [0, scatter_mask_].
+  static inline unsigned int scatter_round(unsigned int x) {
+    x ^= scatter_seed_;
+    x ^= x >> scatter_shift_;
+    x = (x * 0x45d9f3bu) & scatter_mask_;
+    x ^= x >> scatter_shift_;
+    x = (x * 0x2c1b3c6du) & scatter_mask_;
+    x ^= x >> scatter_shift_;
+    return x;
+  }
 
  public:
   table_utils() {}
   ~table_utils() {}
 
-  static void set_scatter_array(int size);
+  // Scatter the keys [0, size) of the hash tables with a fixed permutation,
+  // or every key to 0 when size is SCATTER_KEY_NOT_SET. The permutation is
+  // computed, not stored, so this takes constant time and memory.
+  static void set_scatter_key(int size);
 
+  // The image of 0 <= i < size under the permutation. The mixer permutes the
+  // smallest power of two range covering [0, size); images outside of
+  // [0, size) are mixed again until they fall inside it (cycle walking),
+  // which takes fewer than two rounds on average.
   static inline int scatter_key(int i) {
-    return (scatter_size_ == SCATTER_ARRAY_NOT_SET) ? 0 : scatter_array_[i];
+    if (scatter_size_ == SCATTER_KEY_NOT_SET) {
+      return 0;
+    }
+    unsigned int x = static_cast<unsigned int>(i);
+    do {
+      x = scatter_round(x);
+    } while (x >= static_cast<unsigned int>(scatter_size_));
+    return static_cast<int>(x);
   }
 
-  static inline int table_size(int n) {
-    return table_size_tree_.root_value(n);
-  }
+  // Number of slots for a table of up to n entries: the smallest power of
+  // two keeping the load at most 1 / MAX_LOAD_INVERSE, and no less than
+  // MIN_TABLE_SIZE. Tables stop growing at MAX_TABLE_SIZE slots, which
+  // still holds any n below it; larger n abort the run.
+  static int table_size(int n);
+
+  static const int MIN_TABLE_SIZE;
+  static const int MAX_TABLE_SIZE;
+  static const int MAX_LOAD_INVERSE;
 
-  static const int SCATTER_ARRAY_NOT_SET;
+  static const int SCATTER_KEY_NOT_SET;
 };
 
 }  // namespace internal
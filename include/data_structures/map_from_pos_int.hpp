@@ -1,7 +1,7 @@
 #ifndef _DATA_STRUCTURES_MAP_FROM_POS_INT_HPP
 #define _DATA_STRUCTURES_MAP_FROM_POS_INT_HPP
 
-#include "data_structures/dynamic_array.hpp"
+#include "data_structures/buffer.hpp"
 #include "data_structures/internal/table_utils.hpp"
 
 namespace parkway {
@@ -9,13 +9,18 @@ namespace data_structures {
 
 /* New MapFromPosInt Class */
 /* requires positive int keys */
+/* Key and value share a slot so that a probe touches a single cache line. */
 template<typename Type> class map_from_pos_int {
  protected:
+  struct slot {
+    int key;
+    Type value;
+  };
+
   int size_;
   int capacity_;
 
-  dynamic_array<Type> table_;
-  dynamic_array<int> keys_;
+  buffer<slot> slots_;
 
  public:
   map_from_pos_int() : map_from_pos_int(0) {
@@ -37,37 +42,36 @@ template<typename Type> class map_from_pos_int {
     assert(size >= _size);
     #endif
 
-    keys_.assign(capacity_, -1);
-    table_.resize(capacity_);
+    recover();
   }
 
   void destroy() {
     size_ = 0;
-    table_.reserve(0);
-    keys_.reserve(0);
+    slots_.clear_and_shrink();
   }
 
   void recover() {
-    table_.resize(capacity_);
-    keys_.assign(capacity_, -1);
+    slots_.resize(capacity_);
+    for (int i = 0; i < capacity_; ++i) {
+      slots_[i].key = -1;
+    }
     size_ = 0;
   }
 
   bool insert(int key, Type value) {
     int indepKey = internal::table_utils::scatter_key(key);
-    int slot = internal::hashes::primary(indepKey, capacity_);
+    int s = internal::hashes::home(indepKey, capacity_);
 
-    while (keys_[slot] != -1 && keys_[slot] != indepKey)
-      slot = (slot + internal::hashes::secondary(indepKey, capacity_)) %
-             capacity_;
+    while (slots_[s].key != -1 && slots_[s].key != indepKey)
+      s = internal::hashes::next(s, capacity_);
 
-    if (keys_[slot] == -1) {
-      table_[slot] = value;
-      keys_[slot] = indepKey;
+    if (slots_[s].key == -1) {
+      slots_[s].value = value;
+      slots_[s].key = indepKey;
       ++size_;
       return false;
     } else {
-      table_[slot] = value;
+      slots_[s].value = value;
       return true;
     }
   }
@@ -75,15 +79,14 @@ template<typename Type> class map_from_pos_int {
 
   Type &get(int key) {
     int indepKey = internal::table_utils::scatter_key(key);
-    int slot = internal::hashes::primary(indepKey, capacity_);
-    while (keys_[slot] != indepKey) {
-      slot = (slot + internal::hashes::secondary(indepKey, capacity_)) %
-             capacity_;
+    int s = internal::hashes::home(indepKey, capacity_);
+    while (slots_[s].key != indepKey) {
+      s = internal::hashes::next(s, capacity_);
       #ifdef DEBUG_TABLES
-      assert(keys[slot] != -1);
+      assert(slots_[s].key != -1);
       #endif
     }
-    return table_[slot];
+    return slots_[s].value;
   }
 
   Type &operator[](int key) {
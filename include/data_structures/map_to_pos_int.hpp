@@ -1,12 +1,15 @@
 #ifndef _DATA_STRUCTURES_MAP_TO_POS_INT_HPP
 #define _DATA_STRUCTURES_MAP_TO_POS_INT_HPP
 
+#include "data_structures/buffer.hpp"
 #include "data_structures/dynamic_array.hpp"
 
 namespace parkway {
 namespace data_structures {
 
 /* requires positive int keys */
+/* Without hashing, keys index the table directly. With hashing, key and */
+/* value share a slot so that a probe touches a single cache line. */
 class map_to_pos_int {
  public:
   map_to_pos_int();
@@ -37,13 +40,20 @@ class map_to_pos_int {
   }
 
  protected:
+  struct slot {
+    int key;
+    int value;
+  };
+
+  void clear_slots();
+
   int size_;
   int capacity_;
   bool use_hash_;
 
   dynamic_array<int> entries;
   dynamic_array<int> table;
-  dynamic_array<int> keys;
+  buffer<slot> slots;
 };
 
 
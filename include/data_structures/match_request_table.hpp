@@ -16,6 +16,7 @@ class match_request_table {
   int cluster_weight(int _vertex) const;
   int cluster_index(int _vertex) const;
   int local_count(int _vertex) const;
+  bool requested(int _vertex) const;
 
   inline std::size_t size() const {
     return size_;
@@ -54,6 +55,7 @@ class match_request_table::entry {
   // TODO(gb610): procress or processors?
   int non_local_process_;
   int number_local_;
+  bool requested_;
 
   dynamic_array<int> local_vertices_;
   entry *next_;
@@ -65,6 +67,7 @@ class match_request_table::entry {
         cluster_index_(-1),
         non_local_process_(_proc),
         number_local_(1),
+        requested_(false),
         next_(_next) {
     local_vertices_[0] = _local;
   }
@@ -89,6 +92,12 @@ class match_request_table::entry {
     return number_local_;
   }
 
+  // Whether the match request has been sent to the non-local process. The
+  // local vertices of a requested entry no longer change.
+  inline bool requested() const {
+    return requested_;
+  }
+
   inline dynamic_array<int> local_vertices_array() const {
     return local_vertices_;
   }
@@ -105,6 +114,10 @@ class match_request_table::entry {
     cluster_index_ = _index;
   }
 
+  inline void set_requested() {
+    requested_ = true;
+  }
+
   inline void set_non_local_process(int _proc) {
     non_local_process_ = _proc;
   }
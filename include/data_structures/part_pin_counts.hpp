@@ -0,0 +1,207 @@
+#ifndef DATA_STRUCTURES_PART_PIN_COUNTS_HPP_
+#define DATA_STRUCTURES_PART_PIN_COUNTS_HPP_
+// ### part_pin_counts.hpp ###
+//
+// Number of pins of each hyperedge in each part, as used by the k-way
+// refiners. There are two layouts.
+//
+// Dense: counts are stored as one byte per (hyperedge, part) and each
+// hyperedge's row is padded so that rows can be swept a full SIMD register at
+// a time. A count that does not fit in a byte saturates at 'saturated' and its
+// exact value is kept in a side table; this only happens for parts holding
+// more than 254 pins of one hyperedge, so the side table stays small. The
+// tests the refiners make on the hot path (is the count 0, is it 1) never need
+// the side table.
+//
+// Sparse: each hyperedge only stores the parts it spans, as a list of (part,
+// count) pairs sorted by part. A hyperedge of length l spans at most
+// min(l, parts) parts, and one more while a pin's new part is added before
+// its old part is removed, so the refiners reserve min(l + 1, parts) for it.
+// Memory therefore scales with the number of pins rather than with the number
+// of parts.
+//
+// add_where_present() is the gain kernel: it adds a hyperedge's weight to the
+// entry of every part the hyperedge has pins in, covering all parts in one
+// sweep of the hyperedge's row (or list of spanned parts).
+//
+// ###
+#include <algorithm>
+#include <unordered_map>
+#include "data_structures/buffer.hpp"
+#include "data_structures/span.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace parkway {
+namespace data_structures {
+
+class part_pin_counts {
+ public:
+  typedef unsigned char count_type;
+
+  static const int saturated = 255;
+  static const int simd_width = 16;
+
+  part_pin_counts()
+      : number_of_hyperedges_(0), parts_(0), stride_(0), sparse_(false) {
+  }
+
+  // Sets every count of 'hyperedges' hyperedges over 'parts' parts to zero,
+  // using the dense layout.
+  void reset(int hyperedges, int parts);
+  // As above, using the sparse layout. Hyperedge i spans at most
+  // capacities[i] parts.
+  void reset(int hyperedges, int parts, const int *capacities);
+  void clear_and_shrink();
+
+  inline bool sparse() const {
+    return sparse_;
+  }
+
+  // Number of parts rounded up to the row padding. This is the length of the
+  // gain array passed to add_where_present().
+  inline int stride() const {
+    return stride_;
+  }
+
+  inline int parts() const {
+    return parts_;
+  }
+
+  inline int operator()(int hyperedge, int part) const {
+    if (sparse_) {
+      long i = find(hyperedge, part);
+      return i < 0 ? 0 : sparse_counts_[i];
+    }
+    int count = counts_[index(hyperedge, part)];
+    return count == saturated ? overflow_.at(index(hyperedge, part)) : count;
+  }
+
+  inline bool empty(int hyperedge, int part) const {
+    if (sparse_) {
+      return find(hyperedge, part) < 0;
+    }
+    return counts_[index(hyperedge, part)] == 0;
+  }
+
+  inline bool single(int hyperedge, int part) const {
+    if (sparse_) {
+      long i = find(hyperedge, part);
+      return i >= 0 && sparse_counts_[i] == 1;
+    }
+    return counts_[index(hyperedge, part)] == 1;
+  }
+
+  // Add or remove a pin and return the new count.
+  inline int add(int hyperedge, int part) {
+    if (sparse_) {
+      return add_sparse(hyperedge, part);
+    }
+    long i = index(hyperedge, part);
+    if (counts_[i] < saturated - 1) {
+      return ++counts_[i];
+    }
+    return add_saturated(i);
+  }
+
+  inline int remove(int hyperedge, int part) {
+    if (sparse_) {
+      return remove_sparse(hyperedge, part);
+    }
+    long i = index(hyperedge, part);
+    if (counts_[i] < saturated) {
+      return --counts_[i];
+    }
+    return remove_saturated(i);
+  }
+
+  // Dense layout only.
+  inline const count_type *row(int hyperedge) const {
+    return counts_.data() + static_cast<long>(hyperedge) * stride_;
+  }
+
+  // Sparse layout only: the parts the hyperedge spans, in increasing order.
+  inline span<const int> spanned_parts(int hyperedge) const {
+    return span<const int>(sparse_parts_.data() + offsets_[hyperedge],
+                           sizes_[hyperedge]);
+  }
+
+  // gains[p] += weight for every part p with pins of the hyperedge. gains
+  // must have stride() entries; the entries past parts() are meaningless.
+  inline void add_where_present(int hyperedge, int weight, int *gains) const {
+    if (sparse_) {
+      for (int part : spanned_parts(hyperedge)) {
+        gains[part] += weight;
+      }
+      return;
+    }
+
+    const count_type *counts = row(hyperedge);
+    int p = 0;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_set1_epi32(weight);
+
+    for (; p + simd_width <= stride_; p += simd_width) {
+      __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(counts + p));
+      // 0xff in every byte of a part with no pins
+      __m128i empty = _mm_cmpeq_epi8(c, zero);
+      __m128i lo = _mm_unpacklo_epi8(empty, empty);
+      __m128i hi = _mm_unpackhi_epi8(empty, empty);
+      __m128i m[4] = {_mm_unpacklo_epi16(lo, lo), _mm_unpackhi_epi16(lo, lo),
+                      _mm_unpacklo_epi16(hi, hi), _mm_unpackhi_epi16(hi, hi)};
+
+      for (int i = 0; i < 4; ++i) {
+        __m128i *g = reinterpret_cast<__m128i *>(gains + p + 4 * i);
+        __m128i sum = _mm_add_epi32(_mm_loadu_si128(g), _mm_andnot_si128(m[i], w));
+        _mm_storeu_si128(g, sum);
+      }
+    }
+#endif
+
+    for (; p < stride_; ++p) {
+      gains[p] += counts[p] != 0 ? weight : 0;
+    }
+  }
+
+ protected:
+  inline long index(int hyperedge, int part) const {
+    return static_cast<long>(hyperedge) * stride_ + part;
+  }
+
+  // Position of the part in the hyperedge's sparse list, or -1.
+  inline long find(int hyperedge, int part) const {
+    const int *first = sparse_parts_.data() + offsets_[hyperedge];
+    const int *last = first + sizes_[hyperedge];
+    const int *it = std::lower_bound(first, last, part);
+    return it != last && *it == part ? it - sparse_parts_.data() : -1;
+  }
+
+  int add_saturated(long i);
+  int remove_saturated(long i);
+  int add_sparse(int hyperedge, int part);
+  int remove_sparse(int hyperedge, int part);
+
+  int number_of_hyperedges_;
+  int parts_;
+  int stride_;
+  bool sparse_;
+
+  // dense layout
+  buffer<count_type> counts_;
+  std::unordered_map<long, int> overflow_;
+
+  // sparse layout
+  buffer<long> offsets_;
+  buffer<int> sizes_;
+  buffer<int> sparse_parts_;
+  buffer<int> sparse_counts_;
+};
+
+}  // namespace data_structures
+}  // namespace parkway
+
+#endif  // DATA_STRUCTURES_PART_PIN_COUNTS_HPP_
@@ -0,0 +1,93 @@
+#ifndef DATA_STRUCTURES_PART_SET_TABLE_HPP_
+#define DATA_STRUCTURES_PART_SET_TABLE_HPP_
+// ### part_set_table.hpp ###
+//
+// A set of parts for each of a number of items, such as the parts a vertex is
+// adjacent to. Like part_pin_counts there are two layouts.
+//
+// Dense: one byte per (item, part).
+//
+// Sparse: each item stores its members as a sorted list, in space reserved
+// from a bound on the set's size given when the table is reset. Memory then
+// scales with the sizes of the sets rather than with the number of parts.
+//
+// ###
+#include <algorithm>
+#include "data_structures/buffer.hpp"
+#include "data_structures/span.hpp"
+
+namespace parkway {
+namespace data_structures {
+
+class part_set_table {
+ public:
+  part_set_table() : parts_(0), sparse_(false) {
+  }
+
+  // Empties the sets of 'sets' items over 'parts' parts, using the dense
+  // layout.
+  void reset(int sets, int parts);
+  // As above, using the sparse layout. Set i never holds more than
+  // capacities[i] parts.
+  void reset(int sets, int parts, const int *capacities);
+  void clear_and_shrink();
+
+  inline bool sparse() const {
+    return sparse_;
+  }
+
+  inline bool contains(int set, int part) const {
+    if (sparse_) {
+      span<const int> m = members(set);
+      return std::binary_search(m.begin(), m.end(), part);
+    }
+    return flags_[static_cast<long>(set) * parts_ + part] != 0;
+  }
+
+  // Returns true if the part was not already in the set.
+  inline bool insert(int set, int part) {
+    if (sparse_) {
+      return insert_sparse(set, part);
+    }
+    unsigned char &flag = flags_[static_cast<long>(set) * parts_ + part];
+    bool added = flag == 0;
+    flag = 1;
+    return added;
+  }
+
+  // Returns true if the part was in the set.
+  inline bool erase(int set, int part) {
+    if (sparse_) {
+      return erase_sparse(set, part);
+    }
+    unsigned char &flag = flags_[static_cast<long>(set) * parts_ + part];
+    bool removed = flag != 0;
+    flag = 0;
+    return removed;
+  }
+
+  // Sparse layout only: the members of the set in increasing order.
+  inline span<const int> members(int set) const {
+    return span<const int>(members_.data() + offsets_[set], sizes_[set]);
+  }
+
+ protected:
+  bool insert_sparse(int set, int part);
+  bool erase_sparse(int set, int part);
+
+  int parts_;
+  bool sparse_;
+
+  // dense layout
+  buffer<unsigned char> flags_;
+
+  // sparse layout
+  buffer<long> offsets_;
+  buffer<int> sizes_;
+  buffer<int> members_;
+};
+
+}  // namespace data_structures
+}  // namespace parkway
+
+#endif  // DATA_STRUCTURES_PART_SET_TABLE_HPP_
@@ -0,0 +1,72 @@
+#ifndef DATA_STRUCTURES_SPAN_HPP_
+#define DATA_STRUCTURES_SPAN_HPP_
+// ### span.hpp ###
+//
+// Non-owning view of a contiguous array. Unlike dynamic_array, taking a span
+// does not touch a reference count and indexing it is unchecked, so loops over
+// a span compile down to plain pointer arithmetic. A span is only valid while
+// the array it views is neither freed nor reallocated.
+//
+// ###
+#include <cstddef>
+#include <type_traits>
+
+namespace parkway {
+namespace data_structures {
+
+template <typename T> class span {
+ public:
+  typedef T value_type;
+  typedef T& reference;
+  typedef T* iterator;
+  typedef std::size_t size_type;
+
+  span() : data_(nullptr), size_(0) {
+  }
+
+  span(T *data, size_type size) : data_(data), size_(size) {
+  }
+
+  // Allows a span<T> to be passed where a span<const T> is expected.
+  template <typename U, typename = typename std::enable_if<
+      std::is_same<const U, T>::value>::type>
+  span(const span<U> &other) : data_(other.data()), size_(other.size()) {
+  }
+
+  inline reference operator[](size_type position) const {
+    return data_[position];
+  }
+
+  inline T *data() const {
+    return data_;
+  }
+
+  inline size_type size() const {
+    return size_;
+  }
+
+  inline bool empty() const {
+    return size_ == 0;
+  }
+
+  inline iterator begin() const {
+    return data_;
+  }
+
+  inline iterator end() const {
+    return data_ + size_;
+  }
+
+  inline span subspan(size_type offset, size_type count) const {
+    return span(data_ + offset, count);
+  }
+
+ private:
+  T *data_;
+  size_type size_;
+};
+
+}  // namespace data_structures
+}  // namespace parkway
+
+#endif  // DATA_STRUCTURES_SPAN_HPP_
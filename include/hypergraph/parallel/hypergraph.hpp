@@ -26,8 +26,8 @@
 #include "internal/global_communicator.hpp"
 #include "data_structures/dynamic_array.hpp"
 #include "data_structures/complete_binary_tree.hpp"
-#include "data_structures/new_hyperedge_index_table.hpp"
 #include "internal/base/hypergraph.hpp"
+#include "utility/thread_pool.hpp"
 
 namespace parkway {
 namespace parallel {
@@ -47,17 +47,25 @@ class hypergraph :
              ds::dynamic_array<int> part_array);
 
   hypergraph(int rank, int number_of_processors, const char *filename,
-             MPI_Comm comm);
+             MPI_Comm comm, bool single_file = false);
 
   ~hypergraph();
 
   void load_from_file(const char *filename, MPI_Comm comm);
 
+  // Loads this processor's share of an unsplit binary hypergraph file (the
+  // format read by the converter's bin2para option) by memory mapping it and
+  // building the local pin list directly from the mapped pages.
+  void load_from_mapped_file(const char *filename, MPI_Comm comm);
+
   void initalize_partition_from_file(const char *filename, int numParts,
                                      MPI_Comm comm);
 
   void allocate_hyperedge_memory(int numHedges, int numLocPins);
-  void contract_hyperedges(hypergraph &coarse, MPI_Comm comm);
+  // With a thread pool, the coarse hyperedges are sorted and checked for
+  // duplicates by its threads.
+  void contract_hyperedges(hypergraph &coarse, MPI_Comm comm,
+                           utility::thread_pool *pool = nullptr);
   void contractRestrHyperedges(hypergraph &coarse, MPI_Comm comm);
   void project_partitions(hypergraph &coarse, MPI_Comm comm);
   void reset_vectors();
@@ -175,12 +183,11 @@ class hypergraph :
 
   void send_coarse_hyperedges(
       ds::dynamic_array<int> original_contracted_pin_list,
-      ds::dynamic_array<int> copy_of_requests,
-      int &total_to_send, int &total_to_receive, MPI_Comm comm);
+      int &total_to_send, int &total_to_receive, MPI_Comm comm,
+      utility::thread_pool *pool);
 
-  void process_new_hyperedges(hypergraph &coarse,
-                              ds::new_hyperedge_index_table &table,
-                              int total_to_receive);
+  void process_new_hyperedges(hypergraph &coarse, int total_to_receive,
+                              utility::thread_pool *pool);
 
 };
 
@@ -12,6 +12,7 @@
 #include "hypergraph/parallel/hypergraph.hpp"
 #include <iostream>
 #include "data_structures/bit_field.hpp"
+#include "data_structures/buffer.hpp"
 #include "data_structures/dynamic_array.hpp"
 
 namespace parkway {
@@ -47,7 +48,71 @@ class loader : public global_communicator {
     percentile_ = p;
   }
 
+  // When positive, the hyperedges to load are chosen by
+  // compute_hyperedges_within_budget() rather than by percentile: the
+  // longest length cutoff whose hyperedges are sent in at most this many
+  // bytes in total over all processors, at each level.
+  inline long communication_budget() const {
+    return communication_budget_;
+  }
+
+  inline void set_communication_budget(long bytes) {
+    communication_budget_ = bytes;
+  }
+
  protected:
+  // Number of bins of the hyperedge length histogram. Lengths below
+  // 2^exact_length_bits have a bin each, longer ones share a bin with the
+  // lengths having the same top length_bin_bits bits.
+  static const int exact_length_bits = 8;
+  static const int length_bin_bits = 3;
+  static const int number_of_length_bins =
+      (1 << exact_length_bits) +
+      (31 - exact_length_bits) * (1 << length_bin_bits);
+
+  static int length_bin(int length);
+  static int maximum_length_in_bin(int bin);
+
+  // Sets to_load to the hyperedges shorter than a global length cutoff. The
+  // cutoff is the longest that keeps the bytes sent to other processors,
+  // when each hyperedge is sent in full to every processor owning one of its
+  // pins, within the communication budget. It is chosen from a histogram of
+  // those bytes over hyperedge lengths, summed over all processors, rather
+  // than by sorting the hyperedges. Hyperedges sending nothing are always
+  // loaded, and so are the shortest if they alone exceed the budget.
+  // processor_of(v) is the processor owning vertex v.
+  template <typename ProcessorOf>
+  void compute_hyperedges_within_budget(ds::bit_field &to_load,
+                                        int number_of_hyperedges,
+                                        dynamic_array<int> &hyperedge_offsets,
+                                        dynamic_array<int> &pins,
+                                        ProcessorOf processor_of,
+                                        MPI_Comm comm) {
+    ds::buffer<long> volumes(number_of_hyperedges);
+    ds::buffer<int> seen_by(processors_, -1);
+
+    for (int i = 0; i < number_of_hyperedges; ++i) {
+      int length = hyperedge_offsets[i + 1] - hyperedge_offsets[i];
+      int destinations = 0;
+
+      for (int j = hyperedge_offsets[i]; j < hyperedge_offsets[i + 1]; ++j) {
+        int proc = processor_of(pins[j]);
+        if (proc != rank_ && seen_by[proc] != i) {
+          seen_by[proc] = i;
+          ++destinations;
+        }
+      }
+      volumes[i] = static_cast<long>(destinations) * (length + 2) * sizeof(int);
+    }
+
+    select_within_budget(to_load, number_of_hyperedges, hyperedge_offsets,
+                         volumes, comm);
+  }
+
+  void select_within_budget(ds::bit_field &to_load, int number_of_hyperedges,
+                            dynamic_array<int> &hyperedge_offsets,
+                            ds::buffer<long> &volumes, MPI_Comm comm);
+
   // Hypergraph variables
   int number_of_parts_;
   int number_of_hyperedges_;
@@ -63,14 +128,15 @@ class loader : public global_communicator {
 
   // Member for approximate coarsening and refinement
   int percentile_;
+  long communication_budget_;
 
   ds::dynamic_array<int> vertex_weights_;
   ds::dynamic_array<int> match_vector_;
   ds::dynamic_array<int> hyperedge_weights_;
   ds::dynamic_array<int> hyperedge_offsets_;
   ds::dynamic_array<int> local_pin_list_;
-  ds::dynamic_array<int> vertex_to_hyperedges_offset_;
-  ds::dynamic_array<int> vertex_to_hyperedges_;
+  ds::buffer<int> vertex_to_hyperedges_offset_;
+  ds::buffer<int> vertex_to_hyperedges_;
   ds::dynamic_array<int> allocated_hyperedges_;
 };
 
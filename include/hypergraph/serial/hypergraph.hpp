@@ -19,6 +19,7 @@
 #include "Macros.h"
 #include "Funct.hpp"
 #include "data_structures/dynamic_array.hpp"
+#include "data_structures/span.hpp"
 #include "internal/base/hypergraph.hpp"
 
 namespace parkway {
@@ -28,11 +29,30 @@ namespace ds = parkway::data_structures;
 
 class hypergraph : public parkway::base::hypergraph {
  public:
+  // The arrays describing a hypergraph, held in memory that the hypergraph
+  // viewing them does not own (e.g. the MPI shared memory window of a shared
+  // replica).
+  struct shared_structure {
+    ds::span<int> vertex_weights;
+    ds::span<int> hyperedge_weights;
+    ds::span<int> hyperedge_offsets;
+    ds::span<int> pin_list;
+    ds::span<int> vertex_to_hyperedges;
+    ds::span<int> vertex_offsets;
+  };
+
   hypergraph(ds::dynamic_array<int> vWts, int numV);
+  // Views the arrays of structure in place; their memory must outlive the
+  // hypergraph and any shallow copies of it.
+  hypergraph(const shared_structure &structure, int numV);
   hypergraph(ds::dynamic_array<int> vWts, ds::dynamic_array<int> pVector,
              int numV, int cut);
   ~hypergraph();
 
+  // A hypergraph sharing this one's vertices, hyperedges and pins but with
+  // its own match vector and no partitions.
+  hypergraph *shallow_copy() const;
+
   void load_from_file(const char *filename);
   void buildVtoHedges();
 
@@ -53,12 +73,43 @@ class hypergraph : public parkway::base::hypergraph {
   inline int total_weight() const { return total_weight_; }
   inline int cut(int pNo) const { return partition_cuts_[pNo]; }
 
-  inline ds::dynamic_array<int> vertex_to_hyperedges() const {
-    return vertex_to_hyperedges_;
+  // The arrays describing the hypergraph, either its own or those of the
+  // shared_structure it views. Readers go through these rather than the
+  // base class accessors, which are hidden below.
+  inline ds::span<const int> vertex_weight_view() const {
+    if (shared_)
+      return structure_.vertex_weights;
+    return vertex_weights_.view();
+  }
+
+  inline ds::span<const int> hyperedge_weight_view() const {
+    if (shared_)
+      return structure_.hyperedge_weights;
+    return hyperedge_weights_.view();
+  }
+
+  inline ds::span<const int> hyperedge_offset_view() const {
+    if (shared_)
+      return structure_.hyperedge_offsets;
+    return hyperedge_offsets_.view();
   }
 
-  inline ds::dynamic_array<int> vertex_offsets() const {
-    return vertex_offsets_;
+  inline ds::span<const int> pin_list_view() const {
+    if (shared_)
+      return structure_.pin_list;
+    return pin_list_.view();
+  }
+
+  inline ds::span<const int> vertex_to_hyperedge_view() const {
+    if (shared_)
+      return structure_.vertex_to_hyperedges;
+    return vertex_to_hyperedges_.view();
+  }
+
+  inline ds::span<const int> vertex_offset_view() const {
+    if (shared_)
+      return structure_.vertex_offsets;
+    return vertex_offsets_.view();
   }
 
   inline void set_total_weight(int newWt) {
@@ -87,9 +138,19 @@ class hypergraph : public parkway::base::hypergraph {
   ds::dynamic_array<int> vertex_to_hyperedges_;
   ds::dynamic_array<int> vertex_offsets_;
 
+  bool shared_;
+  shared_structure structure_;
+
   void convert_to_DOMACS_graph_file(const char *fName);
   void check_part_weights_are_less_than(ds::dynamic_array<int> &part_weights,
                                         const int number, int maximum) const;
+
+ private:
+  // Empty while viewing a shared_structure - use the views above.
+  using parkway::base::hypergraph::vertex_weights;
+  using parkway::base::hypergraph::hyperedge_weights;
+  using parkway::base::hypergraph::hyperedge_offsets;
+  using parkway::base::hypergraph::pin_list;
 };
 
 }  // serial
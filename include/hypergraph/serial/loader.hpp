@@ -27,13 +27,14 @@ class loader {
   int numPins;
   int numPartitions;
 
-  ds::dynamic_array<int> vWeight;
-  ds::dynamic_array<int> hEdgeWeight;
+  // Views of the loaded hypergraph, which may be a shared replica.
+  ds::span<const int> vWeight;
+  ds::span<const int> hEdgeWeight;
   ds::dynamic_array<int> matchVector;
-  ds::dynamic_array<int> pinList;
-  ds::dynamic_array<int> hEdgeOffsets;
-  ds::dynamic_array<int> vToHedges;
-  ds::dynamic_array<int> vOffsets;
+  ds::span<const int> pinList;
+  ds::span<const int> hEdgeOffsets;
+  ds::span<const int> vToHedges;
+  ds::span<const int> vOffsets;
 
   ds::dynamic_array<int> partitionVectors;
   ds::dynamic_array<int> partitionOffsets;
@@ -44,12 +45,12 @@ class loader {
     numHedges = h.number_of_hyperedges();
     numPins = h.number_of_pins();
 
-    vWeight = h.vertex_weights();
-    hEdgeWeight = h.hyperedge_weights();
-    pinList = h.pin_list();
-    hEdgeOffsets = h.hyperedge_offsets();
-    vToHedges = h.vertex_to_hyperedges();
-    vOffsets = h.vertex_offsets();
+    vWeight = h.vertex_weight_view();
+    hEdgeWeight = h.hyperedge_weight_view();
+    pinList = h.pin_list_view();
+    hEdgeOffsets = h.hyperedge_offset_view();
+    vToHedges = h.vertex_to_hyperedge_view();
+    vOffsets = h.vertex_offset_view();
   }
 
  public:
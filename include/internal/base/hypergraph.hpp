@@ -47,7 +47,7 @@ class hypergraph {
   }
 
 
-  inline dynamic_array<int> vertex_weights() const {
+  inline const dynamic_array<int> &vertex_weights() const {
     return vertex_weights_;
   }
 
@@ -56,7 +56,7 @@ class hypergraph {
   }
 
 
-  inline dynamic_array<int> hyperedge_weights() const {
+  inline const dynamic_array<int> &hyperedge_weights() const {
     return hyperedge_weights_;
   }
 
@@ -65,7 +65,7 @@ class hypergraph {
   }
 
 
-  inline dynamic_array<int> partition_vector() const {
+  inline const dynamic_array<int> &partition_vector() const {
     return partition_vector_;
   }
 
@@ -74,12 +74,12 @@ class hypergraph {
   }
 
 
-  inline dynamic_array<int> partition_offsets() const {
+  inline const dynamic_array<int> &partition_offsets() const {
     return partition_vector_offsets_;
   }
 
 
-  inline dynamic_array<int> partition_cuts() const {
+  inline const dynamic_array<int> &partition_cuts() const {
     return partition_cuts_;
   }
 
@@ -88,12 +88,12 @@ class hypergraph {
   }
 
 
-  inline dynamic_array<int> match_vector() const {
+  inline const dynamic_array<int> &match_vector() const {
     return match_vector_;
   }
 
 
-  inline dynamic_array<int> pin_list() const {
+  inline const dynamic_array<int> &pin_list() const {
     return pin_list_;
   }
 
@@ -102,7 +102,7 @@ class hypergraph {
   }
 
 
-  inline dynamic_array<int> hyperedge_offsets() const {
+  inline const dynamic_array<int> &hyperedge_offsets() const {
     return hyperedge_offsets_;
   }
 
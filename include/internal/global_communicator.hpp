@@ -9,6 +9,8 @@
 // 4/1/2005: Last Modified
 //
 // ###
+#include <algorithm>
+#include <utility>
 #include "mpi.h"
 #include "Funct.hpp"
 #include "data_structures/dynamic_array.hpp"
@@ -22,7 +24,10 @@ class global_communicator {
   ~global_communicator();
 
   void free_memory();
-  void send_from_data_out(MPI_Comm comm);
+  // Sends the first send_lens_[p] values of data_out_sets_[p] to each
+  // processor p, returning the number of values received into
+  // receive_array_.
+  int send_from_data_out(MPI_Comm comm);
 
   inline int rank() const {
     return rank_;
@@ -32,7 +37,52 @@ class global_communicator {
     return processors_;
   }
 
+  // When enabled, the count exchanges only communicate with the processors
+  // that data is sent to (a non-blocking consensus, see
+  // finish_count_exchange()) instead of an all-to-all over every processor.
+  // Must be set identically on every processor, all of which must then carry
+  // out the same sequence of count exchanges, as with any collective.
+  static void enable_sparse_exchange() {
+    sparse_exchange_ = true;
+  }
+
+  static void disable_sparse_exchange() {
+    sparse_exchange_ = false;
+  }
+
+  static bool sparse_exchange_enabled() {
+    return sparse_exchange_;
+  }
+
 protected:
+  // Non-blocking replacement for the MPI_Alltoall/MPI_Alltoallv pairs.
+  //
+  // start_count_exchange() posts the exchange of send_lens_ so that it can
+  // proceed while send_array_ is being packed. finish_count_exchange() waits
+  // for it, sets receive_displs_, sizes receive_array_ and returns the number
+  // of elements to receive. exchange() then moves send_array_ (laid out by
+  // send_lens_ and send_displs_) into receive_array_ with one point-to-point
+  // message per non-empty block, starting with processor rank_ + 1 so that
+  // not every processor sends to processor 0 first.
+  void start_count_exchange(MPI_Comm comm);
+  int finish_count_exchange();
+  void receive_sparse_counts();
+  static int next_sparse_exchange(MPI_Comm comm);
+  void exchange(MPI_Comm comm);
+
+  // Answers the requests held in receive_array_ after an exchange(). Each
+  // request is answered by width values written by reply(request, out).
+  // The replies to a processor are packed and sent before moving on to the
+  // next processor, so packing overlaps the transfer of earlier replies. On
+  // return receive_array_ holds the answers to this processor's requests,
+  // width values per request, in the order they were sent.
+  template <typename Reply>
+  void reply_to_requests(int width, Reply reply, MPI_Comm comm);
+
+  void receive_block(int processor, int *data, int length, MPI_Comm comm);
+  void send_block(int processor, const int *data, int length, MPI_Comm comm);
+  void wait_for_exchange();
+
   const int rank_;
   const int processors_;
 
@@ -43,8 +93,64 @@ protected:
   ds::dynamic_array<int> receive_displs_;
   ds::dynamic_array<int> send_array_;
   ds::dynamic_array<int> receive_array_;
+
+  // Kept between exchanges (and so between levels of the V-cycle, as the
+  // coarseners, refiners and hypergraphs communicating are long lived).
+  ds::dynamic_array<int> reply_array_;
+  ds::dynamic_array<MPI_Request> requests_;
+  MPI_Request count_request_;
+  MPI_Comm count_comm_;
+  int count_tag_;
+  int number_of_requests_;
+
+  static bool sparse_exchange_;
+
+  // Attribute counting the sparse count exchanges carried out on a
+  // communicator, shared by every instance exchanging on it.
+  static int sparse_exchanges_key_;
 };
 
+template <typename Reply>
+void global_communicator::reply_to_requests(int width, Reply reply,
+                                            MPI_Comm comm) {
+  int total_requests = 0;
+  int total_replies = 0;
+  for (int i = 0; i < processors_; ++i) {
+    total_requests += receive_lens_[i];
+    total_replies += send_lens_[i];
+  }
+  send_array_.resize(total_requests * width);
+  reply_array_.resize(total_replies * width);
+
+  for (int i = 1; i < processors_; ++i) {
+    int p = (rank_ + i) % processors_;
+    receive_block(p, reply_array_.data() + send_displs_[p] * width,
+                  send_lens_[p] * width, comm);
+  }
+
+  for (int i = 0; i < processors_; ++i) {
+    int p = (rank_ + i) % processors_;
+    int start = receive_displs_[p];
+    int end = start + receive_lens_[p];
+    int *out = send_array_.data() + start * width;
+    for (int j = start; j < end; ++j) {
+      reply(receive_array_[j], out);
+      out += width;
+    }
+
+    if (p == rank_) {
+      std::copy(send_array_.data() + start * width, out,
+                reply_array_.data() + send_displs_[p] * width);
+    } else {
+      send_block(p, send_array_.data() + start * width,
+                 receive_lens_[p] * width, comm);
+    }
+  }
+
+  wait_for_exchange();
+  std::swap(receive_array_, reply_array_);
+}
+
 }  // namespace parkway
 
 #endif
@@ -75,6 +75,12 @@ class controller : public parkway::global_communicator {
   serial::controller &serial_controller_;
   std::stack<parallel::hypergraph *> hypergraphs_;
 
+  void write_gathered(const char *filename, const char *data, int length,
+                      MPI_Comm comm) const;
+  void write_collective(const char *filename, const char *data,
+                        long long length, long long total,
+                        MPI_Comm comm) const;
+
  public:
   controller(coarsener &c, refiner &r,
              serial::controller &ref, int rank, int nP, int percentile,
@@ -109,7 +115,12 @@ class controller : public parkway::global_communicator {
   void initialize_map_to_orig_verts();
   void set_prescribed_partition(const char *filename, MPI_Comm comm);
   void store_best_partition(int numV, const dynamic_array<int> array, MPI_Comm comm);
-  void partition_to_file(const char *filename, MPI_Comm comm) const;
+  // Writes the partition of the original vertices, in order, as binary ints
+  // or as text with one part per line. Partitions of at most gather_limit
+  // vertices are gathered to and written by processor 0; larger ones are
+  // written collectively with MPI-IO, each processor at its own offset.
+  void partition_to_file(const char *filename, bool text, int gather_limit,
+                         MPI_Comm comm) const;
   void copy_out_partition(int numVertices, int *pVector) const;
   void display_partition_info(MPI_Comm comm) const;
 };
@@ -35,6 +35,24 @@ class controller {
 
   serial::hypergraph *hypergraph_;
 
+  /* The coarsest hypergraph is gathered onto the leader of each group of
+     processors. Without a shared replica the leaders are the replicas and
+     the other processors take no part in serial partitioning. With a shared
+     replica the groups are shared memory nodes, the leader stores the
+     hypergraph in a window read by the whole node and every processor is a
+     replica. */
+  int replicas_;
+  bool shared_replica_;
+  int group_rank_;
+  int replica_rank_;
+  int number_of_replicas_;
+  MPI_Comm group_comm_;
+  MPI_Comm leader_comm_;
+  MPI_Comm replica_comm_;
+  MPI_Win window_;
+  /* processors in the order their data is gathered onto the leaders */
+  ds::dynamic_array<int> gather_order_;
+
   ds::dynamic_array<int> partition_vector_;
   ds::dynamic_array<int> partition_vector_cuts_;
   ds::dynamic_array<int> partition_vector_offsets_;
@@ -50,6 +68,11 @@ class controller {
   virtual void initialize_coarsest_hypergraph(parallel::hypergraph &hgraph,
                                               MPI_Comm comm);
 
+  void setup_replicas(MPI_Comm comm);
+  void gather_onto_leaders(const int *local, int length, int *all,
+                           MPI_Comm comm) const;
+  void free_shared_replica();
+
   int choose_best_partition() const;
   int accept_cut() const;
 
@@ -58,6 +81,10 @@ class controller {
   inline void set_hypergraph(serial::hypergraph *hGraph) { hypergraph_ = hGraph; }
   inline void set_k_way_constraint(double c) { k_way_constraint_ = c; }
   inline void set_accept_proportion(double p) { accept_proportion_ = p; }
+  inline void set_replicas(int r) { replicas_ = r; }
+  inline void set_shared_replica(bool s) { shared_replica_ = s; }
+  inline bool is_leader() const { return group_rank_ == 0; }
+  inline bool is_replica() const { return replica_rank_ >= 0; }
 };
 
 }  // namespace serial
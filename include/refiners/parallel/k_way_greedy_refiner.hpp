@@ -12,9 +12,14 @@
 
 #include <iostream>
 #include "data_structures/bit_field.hpp"
+#include "data_structures/buffer.hpp"
+#include "data_structures/gain_bucket_queue.hpp"
 #include "data_structures/movement_set_table.hpp"
+#include "data_structures/part_pin_counts.hpp"
+#include "data_structures/part_set_table.hpp"
 #include "hypergraph/parallel/hypergraph.hpp"
 #include "refiners/parallel/refiner.hpp"
+#include "utility/thread_pool.hpp"
 
 namespace parkway {
 namespace parallel {
@@ -29,22 +34,30 @@ class k_way_greedy_refiner : public refiner {
 
   // data_ structures from point of view of vertices
 
-  ds::dynamic_array<int> number_of_neighbor_parts_;
-  ds::dynamic_array<int> neighbors_of_vertices_;
-  ds::dynamic_array<int> neighbors_of_vertices_offsets_;
+  ds::buffer<int> number_of_neighbor_parts_;
+  ds::part_set_table neighbors_of_vertices_;
 
   // data_ structures from point of view of hyperedges
 
-  ds::dynamic_array<int> hyperedge_vertices_in_part_;
-  ds::dynamic_array<int> hyperedge_vertices_in_part_offsets_;
+  ds::part_pin_counts hyperedge_vertices_in_part_;
+
+  // with many parts, the two tables above only store the parts
+  // each hyperedge spans and each vertex is adjacent to, in the
+  // space bounded by these capacities
+
+  bool sparse_connectivity_;
+  ds::buffer<int> hyperedge_part_capacities_;
+  ds::buffer<int> vertex_part_capacities_;
 
   // auxiliary structures
 
-  ds::dynamic_array<int> vertices_;
+  ds::buffer<int> vertices_;
   ds::dynamic_array<int> moved_vertices_;
-  ds::dynamic_array<int> seen_vertices_;
-  ds::dynamic_array<int> number_of_parts_spanned_;
-  ds::dynamic_array<int> spanned_parts_;
+  ds::buffer<int> seen_vertices_;
+  ds::buffer<int> number_of_parts_spanned_;
+  ds::buffer<int> spanned_parts_;
+  // per-thread scratch for the gains computed by sweep_gains()
+  ds::buffer<int> part_gains_;
 
   ds::bit_field locked_;
   ds::bit_field vertices_seen_;
@@ -58,9 +71,27 @@ class k_way_greedy_refiner : public refiner {
 
   ds::movement_set_table *movement_sets_;
 
+  // threaded gain computation: with more than one thread, greedy_pass draws
+  // batches of vertices, computes their best moves in parallel against the
+  // state at the start of the batch and then commits them one at a time
+
+  int threads_;
+  utility::thread_pool *thread_pool_;
+
+  ds::buffer<int> batch_vertices_;
+  ds::buffer<int> batch_moves_;
+  ds::buffer<int> batch_gains_;
+
+  // gain-ordered passes: boundary vertices are queued by the gain
+  // of their best move and visited highest gain first
+
+  bool gain_ordered_;
+  ds::gain_bucket_queue gain_queue_;
+
  public:
   k_way_greedy_refiner(int rank, int nProcs, int nParts, int numVperP,
-                       int eExit, double lim);
+                       int eExit, double lim, int nThreads = 1,
+                       bool gainOrdered = false);
   ~k_way_greedy_refiner();
 
   void display_options() const override;
@@ -72,13 +103,24 @@ class k_way_greedy_refiner : public refiner {
 
   int greedy_k_way_refinement(parallel::hypergraph &h, int pNo, MPI_Comm comm);
   int greedy_pass(int lowToHigh, MPI_Comm comm);
+  int threaded_greedy_pass(int lowToHigh, MPI_Comm comm);
+  int gain_ordered_pass(int lowToHigh, MPI_Comm comm);
+  void queue_best_move(int v, int lowToHigh, double currImbalance);
+  int best_move(int v, int lowToHigh, double currImbalance, int &vGain,
+                double &bestImbalance, int *gains) const;
+  int move_gain(int v, int sP, int to) const;
+  int sweep_gains(int v, int sP, int *gains) const;
+  bool use_sweep(int candidates) const;
+  double move_imbalance(int sP, int to, int vertexWt,
+                        double currImbalance) const;
+  int commit_move(int v, int sP, int bestMove, int vGain, int vertexWt);
   int compute_cutsize(MPI_Comm comm);
 
   void manage_balance_constraint(MPI_Comm comm);
   void undo_pass_moves();
 
   void update_vertex_move_info(MPI_Comm comm);
-  void update_adjacent_vertex_status(int v, int sP, int bestMove);
+  int update_adjacent_vertex_status(int v, int sP, int bestMove);
   void undo_move(int indexIntoMoveSets, int from, int to);
 
   void sanity_hyperedge_check() const;
@@ -21,7 +21,7 @@
 #include <ostream>
 #include "refiner.hpp"
 #include "data_structures/bit_field.hpp"
-#include "data_structures/bucket_node.hpp"
+#include "data_structures/gain_bucket_queue.hpp"
 #include "hypergraph/serial/hypergraph.hpp"
 
 namespace parkway {
@@ -36,22 +36,17 @@ protected:
   // auxiliary members
   // ###
 
-  int bucket_arrays_length_;
   int maximum_possible_gain_;
   int insert_method_;
   int ee_threshold_;
   int maximum_non_positive_moves_;
 
   // ###
-  // bucket arrays
+  // gain buckets of the vertices in each part
   // ###
 
-  NodePtrArray buckets_;
-  ds::dynamic_array<NodeArray *> bucket_arrays_;
+  ds::gain_bucket_queue buckets_[2];
 
-  ds::dynamic_array<int> maximum_gains_;
-  ds::dynamic_array<int> maximum_gain_entries_;
-  ds::dynamic_array<int> number_of_buckets_in_array_;
   ds::dynamic_array<int> vertex_in_part_;
   ds::dynamic_array<int> vertex_gains_;
   ds::dynamic_array<int> move_list_;
@@ -78,9 +73,8 @@ public:
   void remove_buckets_from_0();
   void remove_unlocked_from_bucket_arrays();
   void move_to_bucket_array(int vPart, int vGain, int v);
-  void remove_from_bucket_array(int v, int vPart, int vGain);
+  void remove_from_bucket_array(int v, int vPart);
 
-  void adjust_maximum_gain_pointer(int dP);
   void update_gains(int v);
   void update_gains_1_to_0(int v);
   void update_gains_0_to_1(int v);
@@ -99,22 +93,6 @@ public:
   }
 
   inline void remove_ee_threshold() { maximum_non_positive_moves_ = numVertices; }
-
-  inline int checker_high(int array) {
-    int i;
-    for (i = (maximum_possible_gain_ << 1); i > 0; --i) {
-      if ((*bucket_arrays_[array])[i].next)
-        return i;
-    }
-    return i;
-  }
-
-  inline void sanity_check() {
-    for (int i = 0; i < 2; ++i) {
-      assert(maximum_gains_[i] == maximum_gain_entries_[i] - maximum_possible_gain_);
-      assert(maximum_gain_entries_[i] == checker_high(i));
-    }
-  }
 };
 
 }  // namespace serial
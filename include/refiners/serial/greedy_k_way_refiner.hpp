@@ -9,6 +9,9 @@
 // 25/4/2004: Last Modified
 //
 // ###
+#include "data_structures/bit_field.hpp"
+#include "data_structures/buffer.hpp"
+#include "data_structures/part_pin_counts.hpp"
 #include "refiners/serial/refiner.hpp"
 #include "hypergraph/VertexNode.hpp"
 #include "hypergraph/serial/hypergraph.hpp"
@@ -21,6 +24,7 @@ class greedy_k_way_refiner : public refiner {
  protected:
   int number_of_non_positive_moves_;
   double limit_;
+  bool cache_gains_;
 
   // ###
   // data_ structures from point of view of vertices
@@ -34,8 +38,7 @@ class greedy_k_way_refiner : public refiner {
   // data_ structures from point of view of hyperedges
   // ###
 
-  ds::dynamic_array<int> hyperedge_vertices_in_part_;
-  ds::dynamic_array<int> hyperedge_vertices_in_part_offsets_;
+  ds::part_pin_counts hyperedge_vertices_in_part_;
 
   // ###
   // auxiliary structures
@@ -45,6 +48,19 @@ class greedy_k_way_refiner : public refiner {
   ds::dynamic_array<int> vertex_seen_;
   ds::dynamic_array<int> seen_vertices_;
   ds::dynamic_array<int> parts_spanned_;
+  ds::buffer<int> part_gains_;
+
+  // ###
+  // cached move gains: while gains_cached_(v) is set, the
+  // gain of moving v to part p is cached_gains_[v] plus
+  // cached_part_gains_[v * stride + p]. A vertex's entry is
+  // dropped whenever it or a vertex sharing a hyperedge with
+  // it moves
+  // ###
+
+  ds::bit_field gains_cached_;
+  ds::buffer<int> cached_gains_;
+  ds::buffer<int> cached_part_gains_;
 
  public:
   greedy_k_way_refiner(int max, int nparts, double ave, double limit);
@@ -56,12 +72,21 @@ class greedy_k_way_refiner : public refiner {
   int initialize_data_structures();
   void update_adjacent_vertex_stats(int v, int sP, int bestDP);
 
+  int move_gain(int v, int sP, int to) const;
+  int sweep_gains(int v, int sP, int *gains);
+  const int *cached_sweep_gains(int v, int sP, int &gainFromSP);
+  bool use_sweep(int candidates) const;
+
   void refine(hypergraph &h) override;
   void rebalance(hypergraph &h);
 
   int greedy_pass();
   int rebalancing_pass();
 
+  inline void set_cache_gains(bool cache) {
+    cache_gains_ = cache;
+  }
+
   inline void set_limit() {
     double a = static_cast<double>(numVertices) * limit_;
     number_of_non_positive_moves_ = static_cast<int>(floor(a));
@@ -1,20 +1,61 @@
 #ifndef UTILITY_RANDOM_HPP_
 #define UTILITY_RANDOM_HPP_
+#include <cstdlib>
+#include <utility>
 
 namespace parkway {
 namespace utility {
 
-inline int random(const int lower, const int upper) {
-  if (lower == upper) {
-    return lower;
+// The calling thread's random stream. Unless a random_stream is in scope the
+// process wide stream (drand48 or SPRNG) is used.
+inline unsigned short *&thread_random_state() {
+  static thread_local unsigned short *state = nullptr;
+  return state;
+}
+
+// Gives the constructing thread its own erand48 stream until destroyed, so
+// that threads working in parallel neither share nor race on drand48's state.
+class random_stream {
+ public:
+  explicit random_stream(long seed) : previous_(thread_random_state()) {
+    state_[0] = 0x330e;
+    state_[1] = static_cast<unsigned short>(seed);
+    state_[2] = static_cast<unsigned short>(seed >> 16);
+    thread_random_state() = state_;
+  }
+
+  ~random_stream() {
+    thread_random_state() = previous_;
+  }
+
+  random_stream(const random_stream &) = delete;
+  random_stream &operator=(const random_stream &) = delete;
+
+ private:
+  unsigned short state_[3];
+  unsigned short *previous_;
+};
+
+// Uniform in [0, 1).
+inline double uniform() {
+  unsigned short *state = thread_random_state();
+  if (state) {
+    return erand48(state);
   }
 #ifdef USE_SPRNG
-  return static_cast<int>(sprng() * (upper - lower) + lower);
+  return sprng();
 #else
-  return static_cast<int>(drand48() * (upper - lower) + lower);
+  return drand48();
 #endif
 }
 
+inline int random(const int lower, const int upper) {
+  if (lower == upper) {
+    return lower;
+  }
+  return static_cast<int>(uniform() * (upper - lower) + lower);
+}
+
 
 template <typename Type>
 inline void random_permutation(Type *array, int size) {
@@ -1,6 +1,11 @@
 #ifndef UTILITY_PARKWAY_HPP_
 #define UTILITY_PARKWAY_HPP_
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "utility/thread_pool.hpp"
+
 namespace parkway {
 namespace utility {
 
@@ -92,6 +97,136 @@ inline void quick_sort_by_another_array(const int left, const int right,
   }
 }
 
+// Runs no longer than this are insertion sorted by sort_short().
+const int insertion_sort_length = 16;
+
+template <typename Type>
+inline void insertion_sort(Type *first, Type *last) {
+  for (Type *i = first + 1; i < last; ++i) {
+    Type value = *i;
+    Type *j = i;
+
+    for (; j > first && value < *(j - 1); --j) {
+      *j = *(j - 1);
+    }
+    *j = value;
+  }
+}
+
+// Sorts the first length values of array. Most hyperedges are short, and an
+// insertion sort beats quick_sort's recursion on them.
+template <typename Type>
+inline void sort_short(Type *array, int length) {
+  if (length <= insertion_sort_length) {
+    insertion_sort(array, array + length);
+  } else {
+    quick_sort(0, length - 1, array);
+  }
+}
+
+// Values counted and scattered by each task of a threaded radix_sort() pass.
+const int radix_sort_task_length = 1 << 14;
+
+// Stable LSD radix sort of the first length values by the unsigned integer
+// key(value), a byte at a time, using scratch (of at least length values).
+// Bytes that are the same in every key are skipped. With a thread pool, each
+// pass counts and scatters the values in tasks shared between its threads.
+template <typename Type, typename Key>
+inline void radix_sort(Type *values, Type *scratch, int length, Key key,
+                       thread_pool *pool = nullptr) {
+  typedef decltype(key(*values)) key_type;
+  const int buckets = 256;
+
+  if (length < 2) {
+    return;
+  }
+
+  int tasks = pool ? (length + radix_sort_task_length - 1) /
+                         radix_sort_task_length
+                   : 1;
+  int task_length = (length + tasks - 1) / tasks;
+
+  auto for_each_task = [&](const thread_pool::work_type &work) {
+    if (pool && tasks > 1) {
+      pool->run(tasks, work);
+    } else {
+      for (int t = 0; t < tasks; ++t) {
+        work(t, 0);
+      }
+    }
+  };
+
+  // ###
+  // find the bytes that differ between the keys
+  // ###
+
+  key_type first_key = key(values[0]);
+  std::vector<key_type> task_differences(tasks, 0);
+
+  for_each_task([&](int task, int) {
+    int end = std::min(length, (task + 1) * task_length);
+    key_type differences = 0;
+
+    for (int i = task * task_length; i < end; ++i) {
+      differences |= key(values[i]) ^ first_key;
+    }
+    task_differences[task] = differences;
+  });
+
+  key_type differences = 0;
+  for (int t = 0; t < tasks; ++t) {
+    differences |= task_differences[t];
+  }
+
+  std::vector<int> counts(tasks * buckets);
+  Type *from = values;
+  Type *to = scratch;
+
+  for (unsigned shift = 0; shift < 8 * sizeof(key_type); shift += 8) {
+    if (((differences >> shift) & 0xff) == 0) {
+      continue;
+    }
+
+    for_each_task([&](int task, int) {
+      int *count = counts.data() + task * buckets;
+      int end = std::min(length, (task + 1) * task_length);
+
+      std::fill(count, count + buckets, 0);
+      for (int i = task * task_length; i < end; ++i) {
+        ++count[(key(from[i]) >> shift) & 0xff];
+      }
+    });
+
+    // ###
+    // each task scatters its values of a byte after those of
+    // the earlier tasks, which keeps the sort stable
+    // ###
+
+    int offset = 0;
+    for (int b = 0; b < buckets; ++b) {
+      for (int t = 0; t < tasks; ++t) {
+        int count = counts[t * buckets + b];
+        counts[t * buckets + b] = offset;
+        offset += count;
+      }
+    }
+
+    for_each_task([&](int task, int) {
+      int *position = counts.data() + task * buckets;
+      int end = std::min(length, (task + 1) * task_length);
+
+      for (int i = task * task_length; i < end; ++i) {
+        to[position[(key(from[i]) >> shift) & 0xff]++] = from[i];
+      }
+    });
+
+    std::swap(from, to);
+  }
+
+  if (from != values) {
+    std::copy(from, from + length, values);
+  }
+}
 
 }
 }
@@ -0,0 +1,62 @@
+#ifndef UTILITY_THREAD_POOL_HPP_
+#define UTILITY_THREAD_POOL_HPP_
+// ### thread_pool.hpp ###
+//
+// Fixed set of worker threads for the intra-process parallel parts of the
+// partitioner. run(tasks, work) calls work(task, thread) for every task in
+// [0, tasks), spread over the workers and the calling thread (which is
+// thread 0), and returns once every task has completed. Tasks are handed out
+// one at a time, so uneven tasks balance themselves.
+//
+// The workers are created once and sleep between calls, so a pool can be kept
+// for the lifetime of the component using it.
+//
+// ###
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parkway {
+namespace utility {
+
+class thread_pool {
+ public:
+  typedef std::function<void(int task, int thread)> work_type;
+
+  // A pool of 'threads' threads in total, including the calling thread.
+  explicit thread_pool(int threads);
+  ~thread_pool();
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  inline int size() const {
+    return static_cast<int>(workers_.size()) + 1;
+  }
+
+  void run(int tasks, const work_type &work);
+
+ private:
+  void work_loop(int thread);
+  void take_tasks(int thread);
+
+  std::vector<std::thread> workers_;
+  std::mutex lock_;
+  std::condition_variable wake_;
+  std::condition_variable finished_;
+
+  const work_type *work_;
+  int tasks_;
+  std::atomic<int> next_task_;
+  int busy_workers_;
+  unsigned long generation_;
+  bool stopping_;
+};
+
+}  // namespace utility
+}  // namespace parkway
+
+#endif  // UTILITY_THREAD_POOL_HPP_
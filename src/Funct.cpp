@@ -13,9 +13,19 @@
 #include <cstring>
 #include <cassert>
 
-int Funct::shift1 = 7;
-int Funct::shift2 = 13;
-int Funct::maxHedgeLen = 0;
+namespace {
+
+// 64-bit finaliser from SplitMix64 -- a bijective mixer with full avalanche.
+inline unsigned long long mix(unsigned long long x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+}  // namespace
 
 Funct::Funct() {}
 
@@ -107,30 +117,25 @@ double Funct::toRecurBal(double e, int nP) {
 }
 
 HashKey Funct::computeHash(const int *vs, int len) {
-  HashKey key = 0;
-
-  unsigned int slide1 = SLIDE1;
-  unsigned int slide2 = SLIDE2;
-
-  int sum = 0;
-  int i;
-
-  for (i = 0; i < maxHedgeLen; ++i) {
-    if (i < len) {
-      sum += vs[i];
-      key ^= RotateLeft(vs[i], slide1);
-    } else {
-      sum += 1;
-      key ^= RotateLeft(1, slide1);
-    }
-
-    key ^= RotateLeft(sum, slide2);
-
-    slide1 = (slide1 + shift1) % sizeof(HashKey);
-    slide2 = (slide2 + shift2) % sizeof(HashKey);
+  // Each pin is mixed independently and the results are combined with two
+  // commutative operations, so the key does not depend on the pin order and
+  // the loop carries no dependency other than the accumulators.
+  unsigned long long sum = 0;
+  unsigned long long parity = 0;
+
+  for (int i = 0; i < len; ++i) {
+    unsigned long long m =
+        mix(static_cast<unsigned int>(vs[i]) + 0x9e3779b97f4a7c15ULL);
+    sum += m;
+    parity ^= m * 0xff51afd7ed558ccdULL;
   }
 
+  unsigned long long key = mix(sum ^ mix(parity + static_cast<unsigned>(len)));
+#ifdef PARKWAY_UINT_KEY
+  return static_cast<HashKey>(key ^ (key >> 32));
+#else
   return key;
+#endif
 }
 
 
@@ -65,10 +65,11 @@ void approximate_first_choice_coarsener::buildAuxiliaryStructs(
 void approximate_first_choice_coarsener::release_memory() {
   hyperedge_weights_.reserve(0);
   hyperedge_offsets_.reserve(0);
+  hyperedge_lengths_.reserve(0);
   local_pin_list_.reserve(0);
 
-  vertex_to_hyperedges_offset_.reserve(0);
-  vertex_to_hyperedges_.reserve(0);
+  vertex_to_hyperedges_offset_.clear_and_shrink();
+  vertex_to_hyperedges_.clear_and_shrink();
   allocated_hyperedges_.reserve(0);
   cluster_weights_.reserve(0);
 
@@ -162,7 +163,7 @@ parallel::hypergraph *approximate_first_choice_coarsener::coarsen(
       for (i = vertex_to_hyperedges_offset_[vertex]; i < endOffset1; ++i) {
         hEdge = vertex_to_hyperedges_[i];
         endOffset2 = hyperedge_offsets_[hEdge + 1];
-        hEdgeLen = endOffset2 - hyperedge_offsets_[hEdge];
+        hEdgeLen = hyperedge_length(hEdge);
 
         for (j = hyperedge_offsets_[hEdge]; j < endOffset2; ++j) {
 
@@ -15,6 +15,7 @@
 #include "coarseners/parallel/coarsener.hpp"
 #include "utility/array.hpp"
 #include "utility/logging.hpp"
+#include <cstdlib>
 #include <iostream>
 
 namespace parkway {
@@ -28,10 +29,24 @@ coarsener::coarsener(int rank, int number_of_processors, int number_of_parts)
       cluster_index_(0),
       total_number_of_clusters_(0),
       minimum_cluster_index_(0),
-      balance_constraint_(0) {
+      balance_constraint_(0),
+      summary_pins_(0),
+      threads_(1),
+      thread_pool_(nullptr) {
 }
 
 coarsener::~coarsener() {
+  delete thread_pool_;
+}
+
+void coarsener::set_threads(int threads) {
+  delete thread_pool_;
+  thread_pool_ = nullptr;
+  threads_ = threads;
+
+  if (threads_ > 1) {
+    thread_pool_ = new utility::thread_pool(threads_);
+  }
 }
 
 
@@ -65,7 +80,7 @@ void coarsener::load(const hypergraph &h, MPI_Comm comm) {
   // Use the request sets to send local hyperedges to other processors and to
   // receive hyperedges from processors.
   int limit = INT_MAX;
-  bool check_limit = percentile_ <= 0;
+  bool check_limit = communication_budget_ == 0 && percentile_ <= 0;
   if (check_limit) {
     // Compute a fixed limit on hyperedges to be communicated.
     //  - first try maximum_total_hyperedge_length/2
@@ -168,7 +183,7 @@ hypergraph *coarsener::contract_hyperedges(hypergraph &h, MPI_Comm comm) {
                                stop_coarsening_,
                                cluster_weights);
 
-  h.contract_hyperedges(*coarseGraph, comm);
+  h.contract_hyperedges(*coarseGraph, comm, thread_pool_);
 
   if (parkway::utility::status::handler::progress_enabled()) {
     int numTotCoarseVerts = coarseGraph->total_number_of_vertices();
@@ -229,10 +244,17 @@ void coarsener::load_non_local_hyperedges() {
 
   int i = 0;
   while (i < receive_length) {
-    int end_offset = i + receive_array_[i];
+    // A summary's length is negated, see add_summary().
+    bool summary = receive_array_[i] < 0;
+    int end_offset = i + std::abs(receive_array_[i]);
     ++i;
 
     hyperedge_weights_[number_of_hyperedges_] = receive_array_[i++];
+    if (summary) {
+      hyperedge_lengths_[number_of_hyperedges_] = receive_array_[i++];
+    } else if (summary_pins_ > 0) {
+      hyperedge_lengths_[number_of_hyperedges_] = end_offset - i;
+    }
     hyperedge_offsets_[number_of_hyperedges_++] = number_of_local_pins_;
 
     for (; i < end_offset; ++i) {
@@ -254,7 +276,14 @@ void coarsener::prepare_data_to_send(
     dynamic_array<int> &local_pins,
     MPI_Comm comm, bool check_limit, int limit) {
   ds::bit_field to_load(n_local_hyperedges);
-  if (percentile_ == 100 || check_limit) {
+  if (communication_budget_ > 0) {
+    compute_hyperedges_within_budget(
+        to_load, n_local_hyperedges, local_hyperedge_offsets, local_pins,
+        [this, vertices_per_processor](int vertex) {
+          return std::min(vertex / vertices_per_processor, processors_ - 1);
+        },
+        comm);
+  } else if (percentile_ == 100 || check_limit) {
     to_load.set();
   } else {
     compute_hyperedges_to_load(to_load, n_local_hyperedges,
@@ -279,6 +308,9 @@ void coarsener::prepare_data_to_send(
           if (!sent_to_processor[proc]) {
             if (proc == rank_) {
               hyperedge_weights_[number_of_hyperedges_] = local_hyperedge_weights[i];
+              if (summary_pins_ > 0) {
+                hyperedge_lengths_[number_of_hyperedges_] = hyperedge_length;
+              }
               hyperedge_offsets_[number_of_hyperedges_++] = number_of_local_pins_;
 
               for (int l = start_offset; l < end_offset; ++l) {
@@ -288,6 +320,10 @@ void coarsener::prepare_data_to_send(
                   ++vertex_to_hyperedges_offset_[index];
                 }
               }
+            } else if (summary_pins_ > 0) {
+              add_summary(proc, local_hyperedge_weights[i],
+                          &local_pins[start_offset], hyperedge_length,
+                          vertices_per_processor);
             } else {
               data_out_sets_[proc][send_lens_[proc]++] = hyperedge_length + 2;
               data_out_sets_[proc][send_lens_[proc]++] = local_hyperedge_weights[i];
@@ -304,5 +340,49 @@ void coarsener::prepare_data_to_send(
   }
 }
 
+void coarsener::add_summary(int proc, int weight, const int *pins, int length,
+                            int vertices_per_processor) {
+  // Count the pins that proc stores, the rest are candidates.
+  int own_pins = 0;
+  for (int j = 0; j < length; ++j) {
+    if (std::min(pins[j] / vertices_per_processor, processors_ - 1) == proc) {
+      ++own_pins;
+    }
+  }
+
+  int candidates = length - own_pins;
+  if (candidates <= summary_pins_) {
+    data_out_sets_[proc][send_lens_[proc]++] = length + 2;
+    data_out_sets_[proc][send_lens_[proc]++] = weight;
+    for (int j = 0; j < length; ++j) {
+      data_out_sets_[proc][send_lens_[proc]++] = pins[j];
+    }
+    return;
+  }
+
+  // [-summary length, weight, hyperedge length, pins...]. The negative
+  // length tells the summary apart from a full hyperedge. The candidates are
+  // spread evenly over the hyperedge and the pins keep their order.
+  int kept = summary_pins_;
+  data_out_sets_[proc][send_lens_[proc]++] = -(own_pins + kept + 3);
+  data_out_sets_[proc][send_lens_[proc]++] = weight;
+  data_out_sets_[proc][send_lens_[proc]++] = length;
+
+  int candidate = 0;
+  int next = 0;
+  for (int j = 0; j < length; ++j) {
+    if (std::min(pins[j] / vertices_per_processor, processors_ - 1) == proc) {
+      data_out_sets_[proc][send_lens_[proc]++] = pins[j];
+    } else {
+      if (next < kept &&
+          candidate == static_cast<long>(next) * candidates / kept) {
+        data_out_sets_[proc][send_lens_[proc]++] = pins[j];
+        ++next;
+      }
+      ++candidate;
+    }
+  }
+}
+
 }  // namespace parallel
 }  // namespace parkway
@@ -8,6 +8,10 @@
 //
 // ###
 #include "coarseners/parallel/first_choice_coarsener.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include "data_structures/internal/table_utils.hpp"
 #include "data_structures/match_request_table.hpp"
 #include "data_structures/map_to_pos_int.hpp"
@@ -16,6 +20,21 @@
 namespace parkway {
 namespace parallel {
 
+namespace {
+// Asynchronous match requests and their replies are sent on a duplicate of
+// the coarsening communicator, so that they cannot be mistaken for other
+// messages.
+const int match_request_tag = 1;
+const int match_reply_tag = 2;
+
+// Threaded local matching hands out the visit order in tasks of this many
+// vertices.
+const int vertices_per_task = 256;
+
+// State of a vertex while a thread chooses its match.
+const int claimed_vertex = -2;
+}
+
 first_choice_coarsener::first_choice_coarsener(
     int rank, int nProcs, int nParts, int vertVisOrder, int matchReqOrder,
     int divByWt, int divByLen)
@@ -26,10 +45,21 @@ first_choice_coarsener::first_choice_coarsener(
   divide_by_hyperedge_length_ = divByLen;
   limit_on_index_during_coarsening_ = 0;
 
+  match_request_batch_ = 0;
+  requests_sent_ = 0;
+  replies_received_ = 0;
+  entries_sent_ = 0;
+  match_comm_ = MPI_COMM_NULL;
+
   table_ = nullptr;
 }
 
 first_choice_coarsener::~first_choice_coarsener() {
+  int finalized;
+  MPI_Finalized(&finalized);
+
+  if (!finalized && match_comm_ != MPI_COMM_NULL)
+    MPI_Comm_free(&match_comm_);
 }
 
 void first_choice_coarsener::display_options() const {
@@ -39,8 +69,13 @@ void first_choice_coarsener::display_options() const {
   print_visit_order(vertex_visit_order_);
   info(" mvo = ");
   print_visit_order(match_request_visit_order_);
-  info(" divWt = %i divLen = %i\n|\n", divide_by_cluster_weight_,
+  info(" divWt = %i divLen = %i\n", divide_by_cluster_weight_,
        divide_by_hyperedge_length_);
+  if (match_request_batch_ > 0)
+    info("|- async match requests: batch = %i\n", match_request_batch_);
+  if (threads_ > 1)
+    info("|- threads = %i\n", threads_);
+  info("|\n");
 }
 
 void first_choice_coarsener::build_auxiliary_structures(int numTotPins,
@@ -57,10 +92,11 @@ void first_choice_coarsener::build_auxiliary_structures(int numTotPins,
 void first_choice_coarsener::release_memory() {
   hyperedge_weights_.reserve(0);
   hyperedge_offsets_.reserve(0);
+  hyperedge_lengths_.reserve(0);
   local_pin_list_.reserve(0);
 
-  vertex_to_hyperedges_offset_.reserve(0);
-  vertex_to_hyperedges_.reserve(0);
+  vertex_to_hyperedges_offset_.clear_and_shrink();
+  vertex_to_hyperedges_.clear_and_shrink();
   allocated_hyperedges_.reserve(0);
   cluster_weights_.reserve(0);
 
@@ -136,6 +172,25 @@ hypergraph *first_choice_coarsener::coarsen(hypergraph &h, MPI_Comm comm) {
   cluster_index_ = 0;
   stop_coarsening_ = 0;
 
+  if (match_request_batch_ > 0) {
+    if (match_comm_ == MPI_COMM_NULL)
+      MPI_Comm_dup(comm, &match_comm_);
+
+    requests_sent_ = 0;
+    replies_received_ = 0;
+    entries_sent_ = 0;
+  }
+
+  // ###
+  // threaded matching builds the whole request table first, so
+  // batched requests are only sent once it has finished
+  // ###
+
+  if (threads_ > 1) {
+    match_locally_in_parallel(vertices, aveVertexWt);
+    index = number_of_local_vertices_;
+  }
+
   for (; index < number_of_local_vertices_; ++index) {
     if (match_vector_[vertices[index]] == -1) {
       vertex = vertices[index];
@@ -148,7 +203,7 @@ hypergraph *first_choice_coarsener::coarsen(hypergraph &h, MPI_Comm comm) {
       for (i = vertex_to_hyperedges_offset_[vertex]; i < endOffset1; ++i) {
         hEdge = vertex_to_hyperedges_[i];
         endOffset2 = hyperedge_offsets_[hEdge + 1];
-        hEdgeLen = endOffset2 - hyperedge_offsets_[hEdge];
+        hEdgeLen = hyperedge_length(hEdge);
 
         for (j = hyperedge_offsets_[hEdge]; j < endOffset2; ++j) {
 
@@ -184,6 +239,14 @@ hypergraph *first_choice_coarsener::coarsen(hypergraph &h, MPI_Comm comm) {
                          NON_LOCAL_MATCH) {
                   nonLocV =
                       match_vector_[candidatV - minimum_vertex_index_] - NON_LOCAL_MATCH;
+
+                  // ###
+                  // a request already sent cannot take more vertices
+                  // ###
+
+                  if (match_request_batch_ > 0 && table_->requested(nonLocV))
+                    continue;
+
                   cluWeight = vertex_weights_[vertex] +
                               table_->cluster_weight(nonLocV) + aveVertexWt;
                 } else
@@ -197,6 +260,9 @@ hypergraph *first_choice_coarsener::coarsen(hypergraph &h, MPI_Comm comm) {
                 // vertex matched with a non-local one
                 // ###
 
+                if (match_request_batch_ > 0 && table_->requested(candidatV))
+                  continue;
+
                 candVwt = table_->cluster_weight(candidatV);
 
                 if (candVwt != -1)
@@ -311,6 +377,11 @@ hypergraph *first_choice_coarsener::coarsen(hypergraph &h, MPI_Comm comm) {
         break;
       }
     }
+
+    if (match_request_batch_ > 0 && (index + 1) % match_request_batch_ == 0) {
+      send_match_requests();
+      numNotMatched -= progress_match_requests();
+    }
   }
 
   matchInfoLoc.destroy();
@@ -332,12 +403,17 @@ hypergraph *first_choice_coarsener::coarsen(hypergraph &h, MPI_Comm comm) {
   // now need to prepare and send out the matching requests
   // ###
 
-  for (i = 0; i < 2; ++i) {
-    set_request_arrays(i);
-    send_from_data_out(comm); // actually sending requests
-    set_reply_arrays(i, maximum_vertex_weight_);
-    send_from_data_out(comm); // actually sending replies
-    process_request_replies();
+  if (match_request_batch_ > 0) {
+    send_match_requests();
+    finish_match_requests();
+  } else {
+    for (i = 0; i < 2; ++i) {
+      set_request_arrays(i);
+      send_from_data_out(comm); // actually sending requests
+      set_reply_arrays(i, maximum_vertex_weight_);
+      send_from_data_out(comm); // actually sending replies
+      process_request_replies();
+    }
   }
 
   set_cluster_indices(comm);
@@ -355,6 +431,304 @@ hypergraph *first_choice_coarsener::coarsen(hypergraph &h, MPI_Comm comm) {
   return (contract_hyperedges(h, comm));
 }
 
+void first_choice_coarsener::match_locally_in_parallel(
+    const dynamic_array<int> &vertices, int aveVertexWt) {
+  int i;
+  int v;
+  int nonLocV;
+  int numVertices = number_of_local_vertices_;
+  int numVisited = std::min(numVertices,
+                            limit_on_index_during_coarsening_ + 2);
+  int numTasks = (numVertices + vertices_per_task - 1) / vertices_per_task;
+  int vPerProc = number_of_vertices_ / processors_;
+  int threads = thread_pool_->size();
+
+  // ###
+  // matches[v] is -1 while v is unmatched, claimed_vertex while
+  // a thread is choosing its match, NON_LOCAL_MATCH + the
+  // non-local vertex it requests, or otherwise the local vertex
+  // leading its cluster. weights[l] is the weight of the cluster
+  // led by l
+  // ###
+
+  std::unique_ptr<std::atomic<int>[]> matches(
+      new std::atomic<int>[numVertices]);
+  std::unique_ptr<std::atomic<int>[]> weights(
+      new std::atomic<int>[numVertices]);
+
+  std::vector<ds::map_to_pos_int> matchInfoLoc(threads);
+  std::vector<dynamic_array<int> > neighVerts(threads);
+  std::vector<dynamic_array<int> > neighCluWts(threads);
+  std::vector<dynamic_array<double> > connectVals(threads);
+
+  for (i = 0; i < threads; ++i) {
+    if (number_of_local_pins_ < number_of_vertices_ / 2)
+      matchInfoLoc[i].create(number_of_local_pins_, 1);
+    else
+      matchInfoLoc[i].create(number_of_vertices_, 0);
+  }
+
+  thread_pool_->run(numTasks, [&](int task, int) {
+    int first = task * vertices_per_task;
+    int last = std::min(first + vertices_per_task, numVertices);
+
+    for (int u = first; u < last; ++u) {
+      matches[u].store(match_vector_[u], std::memory_order_relaxed);
+      weights[u].store(vertex_weights_[u], std::memory_order_relaxed);
+    }
+  });
+
+  // ###
+  // each thread takes the vertices of a task in visit order.
+  // A vertex is claimed before its neighbours are scanned, so
+  // that it is not matched by another thread meanwhile, and its
+  // best match is then joined with compare-and-swap, falling
+  // back on a singleton if the match was taken first
+  // ###
+
+  int visitTasks = (numVisited + vertices_per_task - 1) / vertices_per_task;
+
+  thread_pool_->run(visitTasks, [&](int task, int thread) {
+    int first = task * vertices_per_task;
+    int last = std::min(first + vertices_per_task, numVisited);
+
+    ds::map_to_pos_int &neighbours = matchInfoLoc[thread];
+    dynamic_array<int> &verts = neighVerts[thread];
+    dynamic_array<int> &cluWts = neighCluWts[thread];
+    dynamic_array<double> &connect = connectVals[thread];
+
+    for (int k = first; k < last; ++k) {
+      int vertex = vertices[k];
+      int expected = -1;
+
+      if (!matches[vertex].compare_exchange_strong(expected, claimed_vertex))
+        continue;
+
+      int globalVertexIndex = vertex + minimum_vertex_index_;
+      int vertexWt = vertex_weights_[vertex];
+      int numNeighbours = 0;
+      int bestMatch = -1;
+      int bestMatchWt = -1;
+      double maxMatchMetric = 0.0;
+
+      for (int i = vertex_to_hyperedges_offset_[vertex];
+           i < vertex_to_hyperedges_offset_[vertex + 1]; ++i) {
+        int hEdge = vertex_to_hyperedges_[i];
+        int hEdgeLen = hyperedge_length(hEdge);
+        double connectVal = static_cast<double>(hyperedge_weights_[hEdge]);
+
+        if (divide_by_hyperedge_length_)
+          connectVal /= (hEdgeLen - 1);
+
+        for (int j = hyperedge_offsets_[hEdge];
+             j < hyperedge_offsets_[hEdge + 1]; ++j) {
+          int candidatV = local_pin_list_[j];
+
+          if (candidatV == globalVertexIndex)
+            continue;
+
+          int neighbourLoc = neighbours.get_careful(candidatV);
+
+          if (neighbourLoc >= 0) {
+            connect[neighbourLoc] += connectVal;
+            continue;
+          }
+
+          // ###
+          // the weight of a non-local request is not known
+          // until the request table is built, so the average
+          // vertex weight stands in for the non-local vertex
+          // ###
+
+          int cluWeight;
+
+          if (candidatV >= minimum_vertex_index_ &&
+              candidatV < maximum_vertex_index_) {
+            int candidate = candidatV - minimum_vertex_index_;
+            int state = matches[candidate].load();
+
+            if (state == claimed_vertex)
+              continue;
+
+            if (state == -1)
+              cluWeight = vertexWt + vertex_weights_[candidate];
+            else if (state >= NON_LOCAL_MATCH)
+              cluWeight = vertexWt + vertex_weights_[candidate] + aveVertexWt;
+            else
+              cluWeight = vertexWt + weights[state].load();
+          } else {
+            cluWeight = vertexWt + aveVertexWt;
+          }
+
+          neighbours.insert(candidatV, numNeighbours);
+          verts[numNeighbours] = candidatV;
+          cluWts[numNeighbours] = cluWeight;
+          connect[numNeighbours++] = connectVal;
+        }
+      }
+
+      for (int i = 0; i < numNeighbours; ++i) {
+        if (cluWts[i] <= maximum_vertex_weight_) {
+          double metric = connect[i];
+
+          if (divide_by_cluster_weight_)
+            metric /= cluWts[i];
+
+          if (metric > maxMatchMetric) {
+            maxMatchMetric = metric;
+            bestMatch = verts[i];
+            bestMatchWt = cluWts[i];
+          }
+        }
+      }
+
+      neighbours.clear();
+
+      if (bestMatch >= minimum_vertex_index_ &&
+          bestMatch < maximum_vertex_index_) {
+        int candidate = bestMatch - minimum_vertex_index_;
+        int state = matches[candidate].load();
+
+        if (state == -1) {
+          // ###
+          // vertex leads a new cluster with the candidate
+          // ###
+
+          weights[vertex].store(bestMatchWt);
+
+          if (matches[candidate].compare_exchange_strong(state, vertex)) {
+            matches[vertex].store(vertex);
+            continue;
+          }
+
+          weights[vertex].store(vertexWt);
+        }
+
+        if (state >= NON_LOCAL_MATCH) {
+          matches[vertex].store(state);
+          continue;
+        }
+
+        if (state >= 0) {
+          // ###
+          // join the candidate's cluster if it is still light enough
+          // ###
+
+          int cluWt = weights[state].load();
+
+          while (cluWt + vertexWt <= maximum_vertex_weight_) {
+            if (weights[state].compare_exchange_weak(cluWt, cluWt + vertexWt)) {
+              matches[vertex].store(state);
+              break;
+            }
+          }
+
+          if (matches[vertex].load() == state)
+            continue;
+        }
+      } else if (bestMatch != -1) {
+        matches[vertex].store(NON_LOCAL_MATCH + bestMatch);
+        continue;
+      }
+
+      // ###
+      // match as singleton
+      // ###
+
+      matches[vertex].store(vertex);
+    }
+  });
+
+  // ###
+  // the request table is built in visit order, as by the
+  // serial matching. The threads did not know the weights of
+  // the requests, so a vertex that would make its request too
+  // heavy is left as a singleton instead
+  // ###
+
+  for (i = 0; i < numVisited; ++i) {
+    v = vertices[i];
+    nonLocV = matches[v].load(std::memory_order_relaxed) - NON_LOCAL_MATCH;
+
+    if (nonLocV >= 0) {
+      int cluWt = table_->cluster_weight(nonLocV);
+
+      if (cluWt == -1 || cluWt + vertex_weights_[v] + aveVertexWt <=
+                             maximum_vertex_weight_)
+        table_->add_local(nonLocV, v + minimum_vertex_index_,
+                          vertex_weights_[v],
+                          std::min(nonLocV / vPerProc, processors_ - 1));
+      else
+        matches[v].store(v, std::memory_order_relaxed);
+    }
+  }
+
+  // ###
+  // number the clusters: count the leaders of each task, take
+  // the prefix sums and give the leaders of each task
+  // consecutive cluster indices
+  // ###
+
+  dynamic_array<int> taskOffsets(numTasks + 1, 0);
+
+  thread_pool_->run(numTasks, [&](int task, int) {
+    int first = task * vertices_per_task;
+    int last = std::min(first + vertices_per_task, numVertices);
+    int leaders = 0;
+
+    for (int u = first; u < last; ++u) {
+      int state = matches[u].load(std::memory_order_relaxed);
+
+      if (state == -1 || state == u)
+        ++leaders;
+    }
+
+    taskOffsets[task + 1] = leaders;
+  });
+
+  for (i = 0; i < numTasks; ++i)
+    taskOffsets[i + 1] += taskOffsets[i];
+
+  cluster_index_ = taskOffsets[numTasks];
+
+  if (static_cast<int>(cluster_weights_.size()) < cluster_index_)
+    cluster_weights_.resize(cluster_index_);
+
+  thread_pool_->run(numTasks, [&](int task, int) {
+    int first = task * vertices_per_task;
+    int last = std::min(first + vertices_per_task, numVertices);
+    int index = taskOffsets[task];
+
+    for (int u = first; u < last; ++u) {
+      int state = matches[u].load(std::memory_order_relaxed);
+
+      // ###
+      // vertices left unmatched become singletons
+      // ###
+
+      if (state == -1 || state == u) {
+        match_vector_[u] = index;
+        cluster_weights_[index++] = weights[u].load(std::memory_order_relaxed);
+      } else if (state >= NON_LOCAL_MATCH) {
+        match_vector_[u] = state;
+      }
+    }
+  });
+
+  thread_pool_->run(numTasks, [&](int task, int) {
+    int first = task * vertices_per_task;
+    int last = std::min(first + vertices_per_task, numVertices);
+
+    for (int u = first; u < last; ++u) {
+      int state = matches[u].load(std::memory_order_relaxed);
+
+      if (state >= 0 && state != u && state < NON_LOCAL_MATCH)
+        match_vector_[u] = match_vector_[state];
+    }
+  });
+
+}
+
 void first_choice_coarsener::set_request_arrays(int highToLow) {
   int numRequests = table_->size();
   int nonLocVertex;
@@ -489,54 +863,57 @@ void first_choice_coarsener::set_reply_arrays(int highToLow, int maxVWt) {
 void first_choice_coarsener::process_request_replies() {
   int i;
   int j;
-  int index;
 
   int startOffset = 0;
   int vNonLocReq;
   int cluWt;
   int matchIndex;
-  int numLocals;
-
-  ds::match_request_table::entry *entry_;
 
   for (i = 0; i < processors_; ++i) {
     j = 0;
     while (j < receive_lens_[i]) {
       vNonLocReq = receive_array_[startOffset + (j++)];
       matchIndex = receive_array_[startOffset + (j++)];
+      cluWt = matchIndex != NO_MATCH ? receive_array_[startOffset + (j++)] : 0;
 
-      if (matchIndex != NO_MATCH) {
-        // ###
-        // match successful - set the clusterIndex
-        // ###
+      resolve_match_request(vNonLocReq, matchIndex, cluWt);
+    }
+    startOffset += receive_lens_[i];
+  }
+}
+
+void first_choice_coarsener::resolve_match_request(int vNonLocReq,
+                                                   int matchIndex, int cluWt) {
+  int index;
+  int numLocals;
 
-        cluWt = receive_array_[startOffset + (j++)];
-        entry_ = table_->get_entry(vNonLocReq);
+  ds::match_request_table::entry *entry_ = table_->get_entry(vNonLocReq);
 
 #ifdef DEBUG_COARSENER
-        assert(entry_);
+  assert(entry_);
 #endif
 
-        entry_->set_cluster_index(matchIndex);
-        entry_->set_cluster_weight(cluWt);
-      } else {
-        // ###
-        // match not successful - match requesting
-        // vertices into a cluster
-        // ###
+  if (matchIndex != NO_MATCH) {
+    // ###
+    // match successful - set the clusterIndex
+    // ###
+
+    entry_->set_cluster_index(matchIndex);
+    entry_->set_cluster_weight(cluWt);
+  } else {
+    // ###
+    // match not successful - match requesting
+    // vertices into a cluster
+    // ###
 
-        entry_ = table_->get_entry(vNonLocReq);
-        auto locals = entry_->local_vertices_array();
-        numLocals = entry_->number_local();
-        entry_->set_cluster_index(MATCHED_LOCALLY);
+    auto locals = entry_->local_vertices_array();
+    numLocals = entry_->number_local();
+    entry_->set_cluster_index(MATCHED_LOCALLY);
 
-        for (index = 0; index < numLocals; ++index)
-          match_vector_[locals[index] - minimum_vertex_index_] = cluster_index_;
+    for (index = 0; index < numLocals; ++index)
+      match_vector_[locals[index] - minimum_vertex_index_] = cluster_index_;
 
-        cluster_weights_[cluster_index_++] = entry_->cluster_weight();
-      }
-    }
-    startOffset += receive_lens_[i];
+    cluster_weights_[cluster_index_++] = entry_->cluster_weight();
   }
 }
 
@@ -727,6 +1104,233 @@ int first_choice_coarsener::accept(int locVertex, int nonLocCluWt, int highToLow
   }
 }
 
+void first_choice_coarsener::send_match_requests() {
+  int i;
+  int proc;
+  int numEntries = table_->size();
+
+  ds::match_request_table::entry *entry_;
+  ds::dynamic_array<ds::match_request_table::entry *> entryArray = table_->get_entries();
+
+  for (i = 0; i < processors_; ++i)
+    send_lens_[i] = 0;
+
+  // ###
+  // the entries added since the last batch are those not yet requested
+  // ###
+
+  for (; entries_sent_ < static_cast<std::size_t>(numEntries); ++entries_sent_) {
+    entry_ = entryArray[entries_sent_];
+    entry_->set_requested();
+
+    if (entry_->number_local() == 0) {
+      // ###
+      // all of the requesting vertices have since been
+      // matched with vertices that requested them
+      // ###
+
+      entry_->set_cluster_index(MATCHED_LOCALLY);
+      continue;
+    }
+
+    proc = entry_->non_local_process();
+    data_out_sets_[proc][send_lens_[proc]++] = entry_->non_local_vertex();
+    data_out_sets_[proc][send_lens_[proc]++] = entry_->cluster_weight();
+    ++requests_sent_;
+  }
+
+  for (i = 1; i < processors_; ++i) {
+    proc = (rank_ + i) % processors_;
+
+    if (send_lens_[proc] > 0)
+      send_match_message(proc, data_out_sets_[proc].data(), send_lens_[proc],
+                         match_request_tag);
+  }
+}
+
+void first_choice_coarsener::send_match_message(int proc, const int *data,
+                                                int length, int tag) {
+  // ###
+  // the message is copied as it is only sent once the
+  // receiving process gets round to it
+  // ###
+
+  dynamic_array<int> buffer(length);
+  std::copy(data, data + length, buffer.data());
+
+  match_buffers_.push_back(buffer);
+  match_requests_.push_back(MPI_REQUEST_NULL);
+  MPI_Isend(buffer.data(), length, MPI_INT, proc, tag, match_comm_,
+            &match_requests_.back());
+}
+
+int first_choice_coarsener::progress_match_requests() {
+  int j;
+  int arrived;
+  int length;
+  int vNonLocReq;
+  int matchIndex;
+  int cluWt;
+  int claimed = 0;
+
+  MPI_Status status;
+
+  for (;;) {
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, match_comm_, &arrived, &status);
+
+    if (!arrived)
+      break;
+
+    MPI_Get_count(&status, MPI_INT, &length);
+    match_message_.resize(length);
+    MPI_Recv(match_message_.data(), length, MPI_INT, status.MPI_SOURCE,
+             status.MPI_TAG, match_comm_, MPI_STATUS_IGNORE);
+
+    if (status.MPI_TAG == match_request_tag) {
+      claimed += reply_to_match_requests(status.MPI_SOURCE, length);
+    } else {
+      for (j = 0; j < length;) {
+        vNonLocReq = match_message_[j++];
+        matchIndex = match_message_[j++];
+        cluWt = matchIndex != NO_MATCH ? match_message_[j++] : 0;
+
+        resolve_match_request(vNonLocReq, matchIndex, cluWt);
+        ++replies_received_;
+      }
+    }
+  }
+
+  return claimed;
+}
+
+int first_choice_coarsener::reply_to_match_requests(int proc, int length) {
+  int j;
+  int l;
+  int vLocReq;
+  int reqCluWt;
+  int matchIndex;
+  int visitOrderLen = length >> 1;
+  int claimed = 0;
+
+  dynamic_array<int> visitOrder(visitOrderLen);
+
+  for (l = 0; l < visitOrderLen; ++l)
+    visitOrder[l] = l;
+
+  if (match_request_visit_order_ == RANDOM_ORDER)
+    visitOrder.random_permutation();
+
+  send_lens_[proc] = 0;
+
+  for (l = 0; l < visitOrderLen; ++l) {
+    j = visitOrder[l] << 1;
+
+    vLocReq = match_message_[j];
+    reqCluWt = match_message_[j + 1];
+
+    if (accept_asynchronously(vLocReq, reqCluWt, maximum_vertex_weight_,
+                              claimed)) {
+      matchIndex = match_vector_[vLocReq - minimum_vertex_index_];
+      data_out_sets_[proc][send_lens_[proc]++] = vLocReq;
+      data_out_sets_[proc][send_lens_[proc]++] = matchIndex;
+      data_out_sets_[proc][send_lens_[proc]++] = cluster_weights_[matchIndex];
+    } else {
+      data_out_sets_[proc][send_lens_[proc]++] = vLocReq;
+      data_out_sets_[proc][send_lens_[proc]++] = NO_MATCH;
+    }
+  }
+
+  send_match_message(proc, data_out_sets_[proc].data(), send_lens_[proc],
+                     match_reply_tag);
+
+  return claimed;
+}
+
+void first_choice_coarsener::finish_match_requests() {
+  // ###
+  // Non-blocking consensus: keep answering requests until every
+  // process has had all of its own requests answered, which is the
+  // case once all processes have entered the barrier. No request
+  // can then still be on its way.
+  // ###
+
+  MPI_Request barrier = MPI_REQUEST_NULL;
+  bool in_barrier = false;
+  int done = 0;
+
+  while (!done) {
+    progress_match_requests();
+
+    if (in_barrier) {
+      MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+    } else if (replies_received_ == requests_sent_) {
+      MPI_Ibarrier(match_comm_, &barrier);
+      in_barrier = true;
+    }
+  }
+
+  MPI_Waitall(match_requests_.size(), match_requests_.data(),
+              MPI_STATUSES_IGNORE);
+  match_requests_.clear();
+  match_buffers_.clear();
+}
+
+int first_choice_coarsener::accept_asynchronously(int locVertex,
+                                                  int nonLocCluWt, int maxWt,
+                                                  int &claimed) {
+  int locVertexIndex = locVertex - minimum_vertex_index_;
+  int matchValue = match_vector_[locVertexIndex];
+  int cluWt;
+
+  if (matchValue == -1) {
+    // ###
+    // locVertex has not been visited yet, it forms a new
+    // cluster with the requesting vertices
+    // ###
+
+    cluWt = vertex_weights_[locVertexIndex] + nonLocCluWt;
+
+    if (cluWt >= maxWt)
+      return 0;
+
+    match_vector_[locVertexIndex] = cluster_index_;
+    cluster_weights_[cluster_index_++] = cluWt;
+    ++claimed;
+
+    return 1;
+  }
+
+  if (matchValue < NON_LOCAL_MATCH) {
+    if (cluster_weights_[matchValue] + nonLocCluWt >= maxWt)
+      return 0;
+
+    cluster_weights_[matchValue] += nonLocCluWt;
+    return 1;
+  }
+
+  // ###
+  // locVertex has requested a non-local vertex itself. Unless the
+  // request has been sent it is withdrawn, so that no vertex ends
+  // up in two clusters and no two requests can wait on each other
+  // ###
+
+  int nonLocReq = matchValue - NON_LOCAL_MATCH;
+
+  if (table_->requested(nonLocReq))
+    return 0;
+
+  cluWt = vertex_weights_[locVertexIndex] + nonLocCluWt;
+
+  if (cluWt >= maxWt)
+    return 0;
+
+  table_->remove_local(nonLocReq, locVertex, vertex_weights_[locVertexIndex]);
+  match_vector_[locVertexIndex] = cluster_index_;
+  cluster_weights_[cluster_index_++] = cluWt;
+
+  return 1;
+}
+
 void first_choice_coarsener::print_visit_order(int variable) const {
   switch (variable) {
   case INCREASING_ORDER:
@@ -59,10 +59,11 @@ void model_coarsener_2d::build_auxiliary_structures(int numTotPins,
 void model_coarsener_2d::release_memory() {
   hyperedge_weights_.reserve(0);
   hyperedge_offsets_.reserve(0);
+  hyperedge_lengths_.reserve(0);
   local_pin_list_.reserve(0);
 
-  vertex_to_hyperedges_offset_.reserve(0);
-  vertex_to_hyperedges_.reserve(0);
+  vertex_to_hyperedges_offset_.clear_and_shrink();
+  vertex_to_hyperedges_.clear_and_shrink();
   allocated_hyperedges_.reserve(0);
   cluster_weights_.reserve(0);
 
@@ -173,7 +174,7 @@ parallel::hypergraph *model_coarsener_2d::parallel_first_choice_coarsen(
       for (i = vertex_to_hyperedges_offset_[vertex]; i < endOffset1; ++i) {
         hEdge = vertex_to_hyperedges_[i];
         endOffset2 = hyperedge_offsets_[hEdge + 1];
-        hEdgeLen = endOffset2 - hyperedge_offsets_[hEdge];
+        hEdgeLen = hyperedge_length(hEdge);
 
         for (j = hyperedge_offsets_[hEdge]; j < endOffset2; ++j) {
 
@@ -449,7 +450,7 @@ parallel::hypergraph *model_coarsener_2d::parallel_hyperedge_coarsen(
 
   for (i = 0; i < number_of_hyperedges_; ++i) {
     hEdges[i] = i;
-    hEdgeLens[i] = hyperedge_offsets_[i + 1] - hyperedge_offsets_[i];
+    hEdgeLens[i] = hyperedge_length(i);
   }
 
   // sort hedges in increasing order of capacity_
@@ -41,9 +41,7 @@ void restrictive_coarsening::load(const hypergraph &h, MPI_Comm comm) {
   partition_vector_offsets_ = h.partition_offsets();
   partition_cuts_ = h.partition_cuts();
 
-  vertex_to_hyperedges_offset_.reserve(number_of_local_vertices_ + 1);
-  utility::set_to_zero<int>(vertex_to_hyperedges_offset_.data(),
-                            number_of_local_vertices_ + 1);
+  vertex_to_hyperedges_offset_.assign(number_of_local_vertices_ + 1, 0);
 
   // ###
   // use the data_out_sets_ to send local hyperedges to other
@@ -119,7 +117,14 @@ void restrictive_coarsening::prepare_data_to_send(
   utility::set_to_zero<int>(send_lens_.data(), processors_);
 
   ds::bit_field to_load(n_local_hyperedges);
-  if (percentile_ == 100) {
+  if (communication_budget_ > 0) {
+    compute_hyperedges_within_budget(
+        to_load, n_local_hyperedges, local_hyperedge_offsets, local_pins,
+        [&vertex_to_processor](int vertex) {
+          return vertex_to_processor.root_value(vertex);
+        },
+        comm);
+  } else if (percentile_ == 100) {
     to_load.set();
   } else {
     compute_hyperedges_to_load(to_load, n_local_hyperedges,
@@ -214,7 +219,7 @@ void restrictive_coarsening::initialize_vertex_to_hyperedges() {
   }
 
   vertex_to_hyperedges_offset_[number_of_local_vertices_] = j;
-  vertex_to_hyperedges_.reserve(j);
+  vertex_to_hyperedges_.resize(j);
 
   for (int k = 0; k < number_of_hyperedges_; ++k) {
     int endOffset = hyperedge_offsets_[k + 1];
@@ -42,8 +42,8 @@ void restrictive_first_choice_coarsening::release_memory() {
   hyperedge_offsets_.reserve(0);
   local_pin_list_.reserve(0);
 
-  vertex_to_hyperedges_offset_.reserve(0);
-  vertex_to_hyperedges_.reserve(0);
+  vertex_to_hyperedges_offset_.clear_and_shrink();
+  vertex_to_hyperedges_.clear_and_shrink();
   allocated_hyperedges_.reserve(0);
 
   free_memory();
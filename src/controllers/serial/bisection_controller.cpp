@@ -7,8 +7,11 @@
 // 4/1/2005: Last Modified
 //
 // ###
+#include <algorithm>
+#include <thread>
 #include "controllers/serial/bisection_controller.hpp"
 #include "utility/logging.hpp"
+#include "utility/random.hpp"
 
 namespace parkway {
 namespace serial {
@@ -30,6 +33,9 @@ bisection_controller::bisection_controller(int nRuns, double kT, double redFacto
 }
 
 bisection_controller::~bisection_controller() {
+  for (auto worker : workers_) {
+    delete worker;
+  }
 }
 
 
@@ -137,25 +143,37 @@ void bisection_controller::compute_bisection() {
                                bestCut);
 }
 
+void bisection_controller::set_bisection_weights(int totWt, int _maxPartWt) {
+  double avePartWt = static_cast<double>(totWt) / 2;
+
+  maximum_part_weight_ = _maxPartWt;
+  int maxVertWt =
+      static_cast<int>(floor(static_cast<double>(maximum_part_weight_) - avePartWt));
+
+  coarsener_->set_maximum_vertex_weight(maxVertWt);
+  refiner_->set_maximum_part_weight(maximum_part_weight_);
+  initial_bisector_->set_maximum_part_weight(maximum_part_weight_);
+}
+
 void bisection_controller::bisect(serial::hypergraph *h, int _maxPartWt) {
 #ifdef DEBUG_CONTROLLER
   assert(hGraphs.getNumElem() == 0);
 #endif
 
-  hypergraphs_.push(h);
+  int threads = std::min(static_cast<int>(workers_.size()) + 1,
+                         number_of_serial_runs_);
 
-  int totWt = h->total_weight();
-  int maxVertWt;
+  set_bisection_weights(h->total_weight(), _maxPartWt);
 
-  double avePartWt = static_cast<double>(totWt) / 2;
+  if (threads > 1) {
+    for (int t = 0; t < threads - 1; ++t)
+      workers_[t]->set_bisection_weights(h->total_weight(), _maxPartWt);
 
-  maximum_part_weight_ = _maxPartWt;
-  maxVertWt =
-      static_cast<int>(floor(static_cast<double>(maximum_part_weight_) - avePartWt));
+    bisect_in_parallel(h, threads);
+    return;
+  }
 
-  coarsener_->set_maximum_vertex_weight(maxVertWt);
-  refiner_->set_maximum_part_weight(maximum_part_weight_);
-  initial_bisector_->set_maximum_part_weight(maximum_part_weight_);
+  hypergraphs_.push(h);
 
   compute_bisection();
 
@@ -166,5 +184,63 @@ void bisection_controller::bisect(serial::hypergraph *h, int _maxPartWt) {
 #endif
 }
 
+void bisection_controller::bisect_in_parallel(serial::hypergraph *h,
+                                              int threads) {
+  int t;
+  int numVertices = h->number_of_vertices();
+  int numRuns = number_of_serial_runs_;
+  int bestThread = 0;
+
+  std::vector<bisection_controller *> controllers(threads);
+  std::vector<serial::hypergraph *> copies(threads);
+  std::vector<long> seeds(threads);
+  std::vector<std::thread> pool;
+
+  // ###
+  // split the runs between the threads, each
+  // bisects its own copy of the hypergraph with
+  // its own random stream, seeded from the
+  // process wide stream so that the result only
+  // depends on the number of threads
+  // ###
+
+  for (t = 0; t < threads; ++t) {
+    controllers[t] = t == 0 ? this : workers_[t - 1];
+    controllers[t]->number_of_serial_runs_ =
+        numRuns / threads + (t < numRuns % threads ? 1 : 0);
+    copies[t] = h->shallow_copy();
+    seeds[t] = utility::random(0, 1 << 30);
+  }
+
+  auto run = [&](int i) {
+    utility::random_stream stream(seeds[i]);
+    controllers[i]->hypergraphs_.push(copies[i]);
+    controllers[i]->compute_bisection();
+    controllers[i]->hypergraphs_.pop();
+  };
+
+  for (t = 1; t < threads; ++t)
+    pool.emplace_back(run, t);
+
+  run(0);
+
+  for (auto &thread : pool)
+    thread.join();
+
+  for (t = 1; t < threads; ++t) {
+    if (copies[t]->cut(0) < copies[bestThread]->cut(0))
+      bestThread = t;
+  }
+
+  number_of_serial_runs_ = numRuns;
+
+  h->set_number_of_partitions(1);
+  h->copy_in_partition(copies[bestThread]->partition_vector(), numVertices,
+                       0, copies[bestThread]->cut(0));
+
+  for (t = 0; t < threads; ++t)
+    delete copies[t];
+}
+
 }  // namespace serial
 }  // namespace parkway
@@ -0,0 +1,265 @@
+// ### bisection_task_queue.cpp ###
+//
+// Task based recursive bisection: pending sub-bisections are kept in
+// per-processor deques and idle processors steal from the others.
+//
+// ###
+#include "controllers/serial/bisection_task_queue.hpp"
+#include <algorithm>
+#include <thread>
+#include "hypergraph/serial/hypergraph.hpp"
+
+namespace parkway {
+namespace serial {
+
+const int bisection_task_queue::steal_tag;
+const int bisection_task_queue::task_tag;
+const int bisection_task_queue::completed_tag;
+const int bisection_task_queue::stop_tag;
+
+bisection_task_queue::bisection_task_queue(MPI_Comm comm, int bisections)
+    : total_bisections_(bisections), completed_(0), reported_(0),
+      all_completed_(0), stealing_(false), stopped_(false) {
+  MPI_Comm_dup(comm, &comm_);
+  MPI_Comm_rank(comm_, &rank_);
+  MPI_Comm_size(comm_, &processors_);
+  next_victim_ = (rank_ + 1) % processors_;
+}
+
+bisection_task_queue::~bisection_task_queue() {
+  MPI_Comm_free(&comm_);
+}
+
+void bisection_task_queue::run(const handler &bisect) {
+  while (!stopped_) {
+    serve();
+
+    if (!tasks_.empty()) {
+      bisection *b = tasks_.back();
+      tasks_.pop_back();
+      bisect(b);
+      continue;
+    }
+
+    report_completed();
+
+    if (rank_ == 0 && all_completed_ == total_bisections_) {
+      for (int p = 1; p < processors_; ++p) {
+        MPI_Send(nullptr, 0, MPI_INT, p, stop_tag, comm_);
+      }
+      stopped_ = true;
+    } else if (!stealing_ && processors_ > 1) {
+      request_task();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  drain();
+}
+
+void bisection_task_queue::serve() {
+  int arrived = 1;
+  MPI_Status status;
+
+  while (arrived) {
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm_, &arrived, &status);
+
+    if (!arrived)
+      break;
+
+    switch (status.MPI_TAG) {
+      case steal_tag:
+        MPI_Recv(nullptr, 0, MPI_INT, status.MPI_SOURCE, steal_tag, comm_,
+                 MPI_STATUS_IGNORE);
+        send_task(status.MPI_SOURCE);
+        break;
+
+      case task_tag:
+        receive_task(status);
+        break;
+
+      case completed_tag: {
+        int n;
+        MPI_Recv(&n, 1, MPI_INT, status.MPI_SOURCE, completed_tag, comm_,
+                 MPI_STATUS_IGNORE);
+        all_completed_ += n;
+        break;
+      }
+
+      case stop_tag:
+        MPI_Recv(nullptr, 0, MPI_INT, status.MPI_SOURCE, stop_tag, comm_,
+                 MPI_STATUS_IGNORE);
+        stopped_ = true;
+        break;
+    }
+  }
+}
+
+void bisection_task_queue::report_completed() {
+  int n = completed_ - reported_;
+
+  if (n == 0)
+    return;
+
+  if (rank_ == 0)
+    all_completed_ += n;
+  else
+    MPI_Send(&n, 1, MPI_INT, 0, completed_tag, comm_);
+
+  reported_ = completed_;
+}
+
+void bisection_task_queue::request_task() {
+  if (next_victim_ == rank_)
+    next_victim_ = (next_victim_ + 1) % processors_;
+
+  MPI_Send(nullptr, 0, MPI_INT, next_victim_, steal_tag, comm_);
+  next_victim_ = (next_victim_ + 1) % processors_;
+  stealing_ = true;
+}
+
+void bisection_task_queue::send_task(int processor) {
+  // ###
+  // only give a task away if there is another one left
+  // to work on, otherwise an answer of no task is sent
+  // ###
+
+  if (tasks_.size() < 2) {
+    MPI_Send(nullptr, 0, MPI_INT, processor, task_tag, comm_);
+    return;
+  }
+
+  bisection *b = tasks_.front();
+  tasks_.pop_front();
+
+  ds::dynamic_array<int> packed;
+  pack(*b, packed);
+  MPI_Send(packed.data(), packed.size(), MPI_INT, processor, task_tag,
+           comm_);
+
+  delete b->hypergraph();
+  delete b;
+}
+
+void bisection_task_queue::receive_task(const MPI_Status &status) {
+  int length;
+  MPI_Get_count(&status, MPI_INT, &length);
+
+  ds::dynamic_array<int> packed(length);
+  MPI_Recv(packed.data(), length, MPI_INT, status.MPI_SOURCE, task_tag, comm_,
+           MPI_STATUS_IGNORE);
+
+  if (length > 0)
+    tasks_.push_back(unpack(packed));
+
+  stealing_ = false;
+}
+
+void bisection_task_queue::drain() {
+  // ###
+  // wait for the answer to this processor's own steal
+  // request, answering those of the others, then keep
+  // answering until every processor has had its answer
+  // ###
+
+  while (stealing_)
+    serve();
+
+  MPI_Request barrier;
+  int done = 0;
+
+  MPI_Ibarrier(comm_, &barrier);
+
+  while (!done) {
+    serve();
+    MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+  }
+}
+
+void bisection_task_queue::pack(const bisection &b,
+                                ds::dynamic_array<int> &packed) const {
+  hypergraph *h = b.hypergraph();
+
+  int numVertices = h->number_of_vertices();
+  int numHedges = h->number_of_hyperedges();
+  int numPins = h->number_of_pins();
+  int i;
+  int j = 0;
+
+  auto vertexWts = h->vertex_weight_view();
+  auto mapToOrig = b.map_to_orig_vertices();
+  auto hedgeWts = h->hyperedge_weight_view();
+  auto hedgeOffsets = h->hyperedge_offset_view();
+  auto pinList = h->pin_list_view();
+
+  packed.resize(6 + 2 * numVertices + 2 * numHedges + 1 + numPins);
+
+  packed[j++] = b.bisect_again();
+  packed[j++] = b.part_id();
+  packed[j++] = numVertices;
+  packed[j++] = numHedges;
+  packed[j++] = numPins;
+  packed[j++] = h->total_weight();
+
+  for (i = 0; i < numVertices; ++i)
+    packed[j++] = vertexWts[i];
+
+  for (i = 0; i < numVertices; ++i)
+    packed[j++] = mapToOrig[i];
+
+  for (i = 0; i < numHedges; ++i)
+    packed[j++] = hedgeWts[i];
+
+  for (i = 0; i <= numHedges; ++i)
+    packed[j++] = hedgeOffsets[i];
+
+  for (i = 0; i < numPins; ++i)
+    packed[j++] = pinList[i];
+}
+
+bisection *bisection_task_queue::unpack(
+    const ds::dynamic_array<int> &packed) const {
+  const int *p = packed.data();
+
+  int bisectAgain = *p++;
+  int partID = *p++;
+  int numVertices = *p++;
+  int numHedges = *p++;
+  int numPins = *p++;
+  int totWt = *p++;
+
+  ds::dynamic_array<int> vertexWts(numVertices);
+  ds::dynamic_array<int> mapToOrig(numVertices);
+  ds::dynamic_array<int> hedgeWts(numHedges);
+  ds::dynamic_array<int> hedgeOffsets(numHedges + 1);
+  ds::dynamic_array<int> pinList(numPins);
+
+  std::copy(p, p + numVertices, vertexWts.data());
+  p += numVertices;
+  std::copy(p, p + numVertices, mapToOrig.data());
+  p += numVertices;
+  std::copy(p, p + numHedges, hedgeWts.data());
+  p += numHedges;
+  std::copy(p, p + numHedges + 1, hedgeOffsets.data());
+  p += numHedges + 1;
+  std::copy(p, p + numPins, pinList.data());
+
+  hypergraph *h = new hypergraph(vertexWts, numVertices);
+
+  h->set_number_of_hyperedges(numHedges);
+  h->set_number_of_pins(numPins);
+  h->set_total_weight(totWt);
+  h->set_hyperedge_weights(hedgeWts);
+  h->set_pin_list(pinList);
+  h->set_hyperedge_offsets(hedgeOffsets);
+
+  h->buildVtoHedges();
+
+  bisection *b = new bisection(h, bisectAgain, partID);
+  b->setMap(mapToOrig);
+  return b;
+}
+
+}  // namespace serial
+}  // namespace parkway
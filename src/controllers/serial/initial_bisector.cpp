@@ -89,10 +89,10 @@ int initial_bisector::set_base_vertex() {
 
 int initial_bisector::choose_best_vertex_1_to_0() {
 #ifdef DEBUG_REFINER
-  assert((*bucketArrays[1])[maxGainEntries[1]].next);
+  assert(!buckets_[1].empty());
 #endif
 
-  return ((*bucket_arrays_[1])[maximum_gain_entries_[1]].next->vertex_id);
+  return buckets_[1].top();
 }
 
 int initial_bisector::greedy_pass() {
@@ -108,7 +108,7 @@ int initial_bisector::greedy_pass() {
 
     gain += vertex_gains_[bestVertex];
 
-    remove_from_bucket_array(bestVertex, 1, vertex_gains_[bestVertex]);
+    remove_from_bucket_array(bestVertex, 1);
     update_gains_1_to_0(bestVertex);
   }
 
@@ -12,6 +12,7 @@
 #include "hypergraph/serial/hypergraph.hpp"
 #include "utility/logging.hpp"
 #include "utility/math.hpp"
+#include <algorithm>
 
 namespace parallel = parkway::parallel;
 namespace serial = parkway::serial;
@@ -31,6 +32,8 @@ recursive_bisection_contoller::recursive_bisection_contoller(
   bisection_constraint_ = 0;
   average_part_weight_ = 0;
   average_initial_bisection_weight_ = 0;
+  work_stealing_ = false;
+  tasks_ = nullptr;
 
   local_vertex_partition_info_.reserve(0);
   all_partition_info_.reserve(0);
@@ -77,20 +80,20 @@ void recursive_bisection_contoller::convToBisectionConstraints() {
 
   // ###
   // now determine how many of the serial
-  // runs' partitions  the processor should
+  // runs' partitions  the replica should
   // k-way refine
   // ###
 
-  if (number_of_runs_ <= number_of_processors_) {
-    if (rank_ < number_of_runs_)
+  if (number_of_runs_ <= number_of_replicas_) {
+    if (replica_rank_ < number_of_runs_)
       number_of_partitions_ = 1;
     else
       number_of_partitions_ = 0;
   } else {
-    i = number_of_runs_ % number_of_processors_;
-    j = number_of_runs_ / number_of_processors_;
+    i = number_of_runs_ % number_of_replicas_;
+    j = number_of_runs_ / number_of_replicas_;
 
-    if (rank_ < i)
+    if (replica_rank_ < i)
       number_of_partitions_ = j + 1;
     else
       number_of_partitions_ = j;
@@ -112,10 +115,34 @@ void recursive_bisection_contoller::convToBisectionConstraints() {
 void recursive_bisection_contoller::run(parallel::hypergraph &hgraph,
                                         MPI_Comm comm) {
   initialize_coarsest_hypergraph(hgraph, comm);
-  convToBisectionConstraints();
 
   progress("[R-B]: %i |", number_of_runs_);
 
+  // ###
+  // only the replicas of the coarsest
+  // hypergraph take part in the runs
+  // ###
+
+  if (is_replica())
+    run_on_replicas();
+  else
+    number_of_partitions_ = 0;
+
+  // ###
+  // project partitions
+  // ###
+
+  initialize_serial_partitions(hgraph, comm);
+  free_shared_replica();
+
+#ifdef DEBUG_CONTROLLER
+  hgraph.checkPartitions(numParts, maxPartWt, comm);
+#endif
+}
+
+void recursive_bisection_contoller::run_on_replicas() {
+  convToBisectionConstraints();
+
   int i;
   int j;
   int ij;
@@ -126,41 +153,52 @@ void recursive_bisection_contoller::run(parallel::hypergraph &hgraph,
   int myPartitionIdx = 0;
   int v;
 
-  dynamic_array<int> recvLens(number_of_processors_);
-  dynamic_array<int> recvDispls(number_of_processors_);
+  dynamic_array<int> recvLens(number_of_replicas_);
+  dynamic_array<int> recvDispls(number_of_replicas_);
 
   bisection *b;
 
   all_partition_info_.resize(numVertices << 1);
 
   for (i = 0; i < number_of_runs_; ++i) {
-    destProcessor = i % number_of_processors_;
+    destProcessor = i % number_of_replicas_;
     sum_of_cuts_ = 0;
     local_vertex_part_info_length_ = 0;
 
-    if (rank_ == destProcessor) {
+    if (replica_rank_ == destProcessor) {
       pVector = &partition_vector_[partition_vector_offsets_[myPartitionIdx]];
     }
 
     b = new bisection(hypergraph_, log_k_, 0);
     b->initMap();
 
-    recursively_bisect(*b, comm);
+    if (work_stealing_)
+      tasks_ = new serial::bisection_task_queue(replica_comm_,
+                                                (1 << log_k_) - 1);
+
+    recursively_bisect(*b, replica_comm_);
+
+    if (tasks_) {
+      tasks_->run([this](bisection *task) { bisect_task(task); });
+      delete tasks_;
+      tasks_ = nullptr;
+    }
 
     // ###
     // now recover the partition and
     // partition cutsize
     // ###
 
-    MPI_Reduce(&sum_of_cuts_, &ij, 1, MPI_INT, MPI_SUM, destProcessor, comm);
+    MPI_Reduce(&sum_of_cuts_, &ij, 1, MPI_INT, MPI_SUM, destProcessor,
+               replica_comm_);
     MPI_Gather(&local_vertex_part_info_length_, 1, MPI_INT, recvLens.data(), 1, MPI_INT,
-               destProcessor, comm);
+               destProcessor, replica_comm_);
 
-    if (rank_ == destProcessor) {
+    if (replica_rank_ == destProcessor) {
       partition_vector_cuts_[myPartitionIdx] = ij;
       ij = 0;
 
-      for (j = 0; j < number_of_processors_; ++j) {
+      for (j = 0; j < number_of_replicas_; ++j) {
         recvDispls[j] = ij;
         ij += recvLens[j];
       }
@@ -168,9 +206,9 @@ void recursive_bisection_contoller::run(parallel::hypergraph &hgraph,
 
     MPI_Gatherv(local_vertex_partition_info_.data(), local_vertex_part_info_length_, MPI_INT,
                 all_partition_info_.data(), recvLens.data(),
-                recvDispls.data(), MPI_INT, destProcessor, comm);
+                recvDispls.data(), MPI_INT, destProcessor, replica_comm_);
 
-    if (rank_ == destProcessor) {
+    if (replica_rank_ == destProcessor) {
       ij = numVertices << 1;
 
       for (j = 0; j < ij;) {
@@ -198,16 +236,6 @@ void recursive_bisection_contoller::run(parallel::hypergraph &hgraph,
 
     refiner_->rebalance(*hypergraph_);
   }
-
-  // ###
-  // project partitions
-  // ###
-
-  initialize_serial_partitions(hgraph, comm);
-
-#ifdef DEBUG_CONTROLLER
-  hgraph.checkPartitions(numParts, maxPartWt, comm);
-#endif
 }
 
 void recursive_bisection_contoller::initialize_serial_partitions(
@@ -217,7 +245,7 @@ void recursive_bisection_contoller::initialize_serial_partitions(
   int j;
   int ij;
 
-  int numTotVertices = hypergraph_->number_of_vertices();
+  int numTotVertices = hgraph.total_number_of_vertices();
   int ijk;
   int startOffset;
   int endOffset;
@@ -227,9 +255,15 @@ void recursive_bisection_contoller::initialize_serial_partitions(
   ds::dynamic_array<int> hGraphPartVectorOffsets;
   ds::dynamic_array<int> hGraphPartCuts;
 
-  auto hPartitionVector = hypergraph_->partition_vector();
-  auto hPartOffsetsVector = hypergraph_->partition_offsets();
-  auto hPartitionCutsArray = hypergraph_->partition_cuts();
+  dynamic_array<int> hPartitionVector;
+  dynamic_array<int> hPartOffsetsVector;
+  dynamic_array<int> hPartitionCutsArray;
+
+  if (hypergraph_) {
+    hPartitionVector = hypergraph_->partition_vector();
+    hPartOffsetsVector = hypergraph_->partition_offsets();
+    hPartitionCutsArray = hypergraph_->partition_cuts();
+  }
 
   dynamic_array<int> numVperProc(number_of_processors_);
   dynamic_array<int> procDispls(number_of_processors_);
@@ -339,13 +373,23 @@ void recursive_bisection_contoller::recursively_bisect(const bisection &b,
 
   serial::hypergraph *h = b.hypergraph();
 
-  if (h->number_of_vertices() == 0)
-    return;
-
   MPI_Comm_size(comm, &nProcs);
   MPI_Comm_rank(comm, &rank);
 
-  if (nProcs == 1) {
+  if (h->number_of_vertices() == 0) {
+    if (tasks_ && rank == 0)
+      tasks_->complete((1 << bisectAgain) - 1);
+    return;
+  }
+
+  if (nProcs == 1 && tasks_) {
+    // ###
+    // leave the rest of the recursion to the
+    // task queue, where idle replicas can steal it
+    // ###
+
+    tasks_->push(new bisection(b));
+  } else if (nProcs == 1) {
     bisection *left = nullptr;
     bisection *right = nullptr;
 
@@ -359,24 +403,7 @@ void recursive_bisection_contoller::recursively_bisect(const bisection &b,
     sum_of_cuts_ += h->keep_best_partition();
 
     if (bisectAgain == 1) {
-      int numVerts = h->number_of_vertices();
-      auto partV = h->partition_vector();
-      auto toOrigVmap = b.map_to_orig_vertices();
-      int bisectionPart = b.part_id();
-
-      int i;
-
-      for (i = 0; i < numVerts; ++i) {
-        local_vertex_partition_info_[local_vertex_part_info_length_++] =
-            toOrigVmap[i];
-
-        if (partV[i] == 0)
-          local_vertex_partition_info_[local_vertex_part_info_length_++] =
-              bisectionPart;
-        else
-          local_vertex_partition_info_[local_vertex_part_info_length_++] =
-              (bisectionPart | (1 << (log_k_ - 1)));
-      }
+      record_final_parts(b);
     } else {
       split_bisection(b, left, right);
       recursively_bisect(*left, comm);
@@ -407,27 +434,20 @@ void recursive_bisection_contoller::recursively_bisect(const bisection &b,
     if (rank == bestCutProc)
       sum_of_cuts_ += cut;
 
-    if (bisectAgain == 1) {
-      if (rank == bestCutProc) {
-        int numVerts = h->number_of_vertices();
-        auto partV = h->partition_vector();
-        auto toOrigVmap = b.map_to_orig_vertices();
-        int bisectionPart = b.part_id();
-
-        int i;
+    if (tasks_ && rank == 0)
+      tasks_->complete(1);
 
-        for (i = 0; i < numVerts; ++i) {
-          local_vertex_partition_info_[local_vertex_part_info_length_++] = toOrigVmap[i];
-
-          if (partV[i] == 0)
-            local_vertex_partition_info_[local_vertex_part_info_length_++] = bisectionPart;
-          else
-            local_vertex_partition_info_[local_vertex_part_info_length_++] = (bisectionPart | (1 << (log_k_ - 1)));
-        }
-      }
+    if (bisectAgain == 1) {
+      if (rank == bestCutProc)
+        record_final_parts(b);
     } else {
-      MPI_Bcast(h->partition_vector().data(), h->number_of_vertices(),
-                MPI_INT, bestCutProc, comm);
+      const dynamic_array<int> &current = h->partition_vector();
+      dynamic_array<int> partition(current.size());
+      std::copy(current.data(), current.data() + current.size(),
+                partition.data());
+      MPI_Bcast(partition.data(), h->number_of_vertices(), MPI_INT,
+                bestCutProc, comm);
+      h->set_partition_vector(partition);
 
       MPI_Comm new_comm;
       MPI_Comm_split(comm, (rank & 0x1), 0, &new_comm);
@@ -445,6 +465,69 @@ void recursive_bisection_contoller::recursively_bisect(const bisection &b,
   }
 }
 
+void recursive_bisection_contoller::bisect_task(bisection *b) {
+  serial::hypergraph *h = b->hypergraph();
+  int bisectAgain = b->bisect_again();
+
+  if (h->number_of_vertices() == 0) {
+    tasks_->complete((1 << bisectAgain) - 1);
+  } else {
+    bisector_->set_number_of_serial_runs(number_of_bisections_);
+
+    if (bisectAgain == 1)
+      bisector_->bisect(h, maximum_part_weight_);
+    else
+      bisector_->bisect(h, compute_maximum_weight(log_k_ - bisectAgain));
+
+    sum_of_cuts_ += h->keep_best_partition();
+    tasks_->complete(1);
+
+    if (bisectAgain == 1) {
+      record_final_parts(*b);
+    } else {
+      bisection *left = nullptr;
+      bisection *right = nullptr;
+
+      // ###
+      // the left half is pushed last so that it is
+      // bisected first, as in the serial recursion
+      // ###
+
+      split_bisection(*b, left, right);
+      tasks_->push(right);
+      tasks_->push(left);
+    }
+  }
+
+  if (h != hypergraph_)
+    delete h;
+
+  delete b;
+}
+
+void recursive_bisection_contoller::record_final_parts(const bisection &b) {
+  serial::hypergraph *h = b.hypergraph();
+
+  int numVerts = h->number_of_vertices();
+  auto partV = h->partition_vector();
+  auto toOrigVmap = b.map_to_orig_vertices();
+  int bisectionPart = b.part_id();
+
+  int i;
+
+  for (i = 0; i < numVerts; ++i) {
+    local_vertex_partition_info_[local_vertex_part_info_length_++] =
+        toOrigVmap[i];
+
+    if (partV[i] == 0)
+      local_vertex_partition_info_[local_vertex_part_info_length_++] =
+          bisectionPart;
+    else
+      local_vertex_partition_info_[local_vertex_part_info_length_++] =
+          (bisectionPart | (1 << (log_k_ - 1)));
+  }
+}
+
 void recursive_bisection_contoller::split_bisection(const bisection &b,
                                                     bisection *&newB,
                                                     MPI_Comm comm) const {
@@ -471,10 +554,10 @@ void recursive_bisection_contoller::split_bisection(const bisection &b,
 
   auto mapToOrig = b.map_to_orig_vertices();
   auto hPartVector = h->partition_vector();
-  auto hVertWt = h->vertex_weights();
-  auto hHedgeWt = h->hyperedge_weights();
-  auto hHedgeOffsets = h->hyperedge_offsets();
-  auto hPinList = h->pin_list();
+  auto hVertWt = h->vertex_weight_view();
+  auto hHedgeWt = h->hyperedge_weight_view();
+  auto hHedgeOffsets = h->hyperedge_offset_view();
+  auto hPinList = h->pin_list_view();
 
   // ###
   // newH data_
@@ -673,10 +756,10 @@ void recursive_bisection_contoller::split_bisection(const bisection &b,
 
   auto mapToOrig = b.map_to_orig_vertices();
   auto hPartVector = h->partition_vector();
-  auto hVertWt = h->vertex_weights();
-  auto hHedgeWt = h->hyperedge_weights();
-  auto hHedgeOffsets = h->hyperedge_offsets();
-  auto hPinList = h->pin_list();
+  auto hVertWt = h->vertex_weight_view();
+  auto hHedgeWt = h->hyperedge_weight_view();
+  auto hHedgeOffsets = h->hyperedge_offset_view();
+  auto hPinList = h->pin_list_view();
 
   // ###
   // leftH data_
@@ -45,119 +45,7 @@ vertices.
 
   ************************/
 
-  int i;
-  int j;
-  int ij;
-
-  int recvArrayLen;
-  int index;
-  int numLocalVertices = hgraph.number_of_vertices();
-  int numLocalHedges = hgraph.number_of_hyperedges();
-  int numLocalPins = hgraph.number_of_pins();
-  int localVertexWt = hgraph.vertex_weight();
-
-  auto localVertWeight = hgraph.vertex_weights();
-  auto localHedgeOffsets = hgraph.hyperedge_offsets();
-  auto localHedgeWeights = hgraph.hyperedge_weights();
-  auto localPins = hgraph.pin_list();
-
-  int numVertices = hgraph.total_number_of_vertices();
-  int numHedges;
-  int numPins;
-  int totVertexWt;
-
-  dynamic_array<int> vWeights;
-  dynamic_array<int> hEdgeWeights;
-  dynamic_array<int> hEdgeOffsets;
-  dynamic_array<int> pinList;
-  dynamic_array<int> recvDispls(number_of_processors_);
-  dynamic_array<int> recvLens(number_of_processors_);
-  dynamic_array<int> recvArray;
-
-  MPI_Allgather(&numLocalVertices, 1, MPI_INT, recvLens.data(), 1, MPI_INT,
-                comm);
-
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ij += recvLens[i];
-  }
-
-#ifdef DEBUG_CONTROLLER
-  assert(numVertices == ij);
-#endif
-
-  vWeights.resize(numVertices);
-  MPI_Allreduce(&localVertexWt, &totVertexWt, 1, MPI_INT, MPI_SUM, comm);
-  MPI_Allgatherv(localVertWeight.data(), numLocalVertices, MPI_INT,
-                 vWeights.data(), recvLens.data(),
-                 recvDispls.data(), MPI_INT, comm);
-  MPI_Allgather(&numLocalHedges, 1, MPI_INT, recvLens.data(), 1, MPI_INT,
-                comm);
-
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ij += recvLens[i];
-  }
-
-  numHedges = ij;
-  hEdgeWeights.resize(numHedges);
-  MPI_Allgatherv(localHedgeWeights.data(), numLocalHedges, MPI_INT,
-                 hEdgeWeights.data(), recvLens.data(),
-                 recvDispls.data(), MPI_INT, comm);
-
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ++recvLens[i];
-    ij += recvLens[i];
-  }
-
-  recvArrayLen = ij;
-  recvArray.reserve(recvArrayLen);
-  MPI_Allgatherv(localHedgeOffsets.data(), numLocalHedges + 1, MPI_INT,
-                 recvArray.data(), recvLens.data(),
-                 recvDispls.data(), MPI_INT, comm);
-  hEdgeOffsets.resize(numHedges + 1);
-
-  j = 1;
-  index = 0;
-  hEdgeOffsets[0] = 0;
-
-  for (i = 1; i < recvArrayLen; ++i) {
-    if (recvArray[i] != 0) {
-      ij = recvArray[i] - recvArray[i - 1];
-      hEdgeOffsets[j] = hEdgeOffsets[j - 1] + ij;
-      ++j;
-    } else {
-      recvLens[index++] = recvArray[i - 1];
-    }
-  }
-
-  recvLens[index] = recvArray[recvArrayLen - 1];
-
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ij += recvLens[i];
-  }
-
-  numPins = ij;
-  pinList.resize(numPins);
-  MPI_Allgatherv(localPins.data(), numLocalPins, MPI_INT, pinList.data(),
-                 recvLens.data(), recvDispls.data(), MPI_INT, comm);
-
-  hypergraph_ = new serial::hypergraph(vWeights, numVertices);
-
-  hypergraph_->set_number_of_hyperedges(numHedges);
-  hypergraph_->set_number_of_pins(numPins);
-  hypergraph_->set_total_weight(totVertexWt);
-  hypergraph_->set_hyperedge_weights(hEdgeWeights);
-  hypergraph_->set_hyperedge_offsets(hEdgeOffsets);
-  hypergraph_->set_pin_list(pinList);
-  hypergraph_->buildVtoHedges();
-  hypergraph_->print_characteristics();
+  parkway::serial::controller::initialize_coarsest_hypergraph(hgraph, comm);
 }
 
 void web_graph_serial_controller::initialize_serial_partitions(
@@ -170,15 +58,20 @@ void web_graph_serial_controller::initialize_serial_partitions(
   int keepMyPartition;
   int proc;
   int numKept;
-  int myBestCut = hypergraph_->cut(0);
+  int myBestCut = hypergraph_ ? hypergraph_->cut(0) : -1;
   int ijk;
   int startOffset;
   int endOffset;
   int totToSend;
 
-  int numTotVertices = hypergraph_->number_of_vertices();
-  auto pVector = hypergraph_->partition_vector();
-  auto pCuts = hypergraph_->partition_cuts();
+  int numTotVertices = hgraph.total_number_of_vertices();
+  dynamic_array<int> pVector;
+  dynamic_array<int> pCuts;
+
+  if (hypergraph_) {
+    pVector = hypergraph_->partition_vector();
+    pCuts = hypergraph_->partition_cuts();
+  }
 
   dynamic_array<int> numVperProc(number_of_processors_);
   dynamic_array<int> procDispls(number_of_processors_);
@@ -220,7 +113,8 @@ void web_graph_serial_controller::initialize_serial_partitions(
         }
       }
 
-      if (ij == 0) {
+      // processors without a replica have no partition
+      if (ij == 0 && procCuts[proc] >= 0) {
         keepPartitions[proc] = 1;
         ++numKept;
       } else
@@ -0,0 +1,156 @@
+#include "data_structures/gain_bucket_queue.hpp"
+
+namespace parkway {
+namespace data_structures {
+
+const int gain_bucket_queue::no_key;
+const int gain_bucket_queue::not_queued;
+const int gain_bucket_queue::word_bits;
+
+void gain_bucket_queue::reset(int items, int max_gain) {
+  max_gain_ = max_gain;
+  max_bucket_ = -1;
+  size_ = 0;
+
+  int buckets = 2 * max_gain + 1;
+  // One word more than needed, so that highest_bucket_below() may be asked
+  // about the bucket just past the highest.
+  int words = buckets / word_bits + 1;
+
+  head_.assign(buckets, -1);
+  tail_.resize(buckets);
+  next_.resize(items);
+  previous_.assign(items, not_queued);
+  key_.resize(items);
+
+  occupied_.assign(words, 0);
+  summary_.assign((words + word_bits - 1) / word_bits, 0);
+}
+
+void gain_bucket_queue::clear_and_shrink() {
+  max_gain_ = 0;
+  max_bucket_ = -1;
+  size_ = 0;
+
+  head_.clear_and_shrink();
+  tail_.clear_and_shrink();
+  next_.clear_and_shrink();
+  previous_.clear_and_shrink();
+  key_.clear_and_shrink();
+  occupied_.clear_and_shrink();
+  summary_.clear_and_shrink();
+}
+
+void gain_bucket_queue::insert(int item, int gain) {
+  int bucket = gain + max_gain_;
+  int first = head_[bucket];
+
+  key_[item] = gain;
+  previous_[item] = -1;
+  next_[item] = first;
+
+  if (first != -1) {
+    previous_[first] = item;
+  } else {
+    tail_[bucket] = item;
+    mark(bucket);
+  }
+
+  head_[bucket] = item;
+
+  if (bucket > max_bucket_) {
+    max_bucket_ = bucket;
+  }
+
+  ++size_;
+}
+
+void gain_bucket_queue::insert_back(int item, int gain) {
+  int bucket = gain + max_gain_;
+
+  if (head_[bucket] == -1) {
+    insert(item, gain);
+    return;
+  }
+
+  int last = tail_[bucket];
+
+  key_[item] = gain;
+  previous_[item] = last;
+  next_[item] = -1;
+  next_[last] = item;
+  tail_[bucket] = item;
+
+  ++size_;
+}
+
+void gain_bucket_queue::remove(int item) {
+  int bucket = key_[item] + max_gain_;
+  int before = previous_[item];
+  int after = next_[item];
+
+  if (before == -1) {
+    head_[bucket] = after;
+  } else {
+    next_[before] = after;
+  }
+
+  if (after == -1) {
+    tail_[bucket] = before;
+  } else {
+    previous_[after] = before;
+  }
+
+  previous_[item] = not_queued;
+  --size_;
+
+  if (head_[bucket] == -1) {
+    unmark(bucket);
+
+    if (bucket == max_bucket_) {
+      max_bucket_ = highest_bucket_below(bucket);
+    }
+  }
+}
+
+void gain_bucket_queue::clear() {
+  while (size_ > 0) {
+    pop();
+  }
+}
+
+int gain_bucket_queue::highest_bucket_below(int bucket) const {
+  if (bucket <= 0) {
+    return -1;
+  }
+
+  int word = bucket / word_bits;
+  int bit = bucket % word_bits;
+
+  if (bit > 0) {
+    std::uint64_t below =
+        occupied_[word] & ((std::uint64_t(1) << bit) - 1);
+    if (below != 0) {
+      return word * word_bits + highest_bit(below);
+    }
+  }
+
+  // No lower bucket in this word: find the highest non-empty word below it
+  // through the summary.
+  int group = word / word_bits;
+  std::uint64_t words =
+      summary_[group] & ((std::uint64_t(1) << (word % word_bits)) - 1);
+
+  while (words == 0) {
+    if (--group < 0) {
+      return -1;
+    }
+    words = summary_[group];
+  }
+
+  word = group * word_bits + highest_bit(words);
+  return word * word_bits + highest_bit(occupied_[word]);
+}
+
+}  // namespace data_structures
+}  // namespace parkway
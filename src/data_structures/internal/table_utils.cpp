@@ -1,65 +1,52 @@
 #include "data_structures/internal/table_utils.hpp"
+#include "mpi.h"
+#include "utility/logging.hpp"
 
 namespace parkway {
 namespace data_structures {
 namespace internal {
 
-const int sizes[16] = {
-  1091,
-  2113,
-  4133,
-  9067,
-  17093,
-  37097,
-  70099,
-  145109,
-  300149,
-  610217,
-  1290151,
-  2600177,
-  6000109,
-  12500197,
-  26000111,
-  64000147
-};
-
-const int mins[16] = {
-  0,
-  256,
-  512,
-  1024,
-  2056,
-  4112,
-  8224,
-  16448,
-  35000,
-  70000,
-  140000,
-  300000,
-  700000,
-  1800000,
-  4000000,
-  12500000
-};
-
-complete_binary_tree<int> table_utils::table_size_tree_(sizes, mins, 16);
-dynamic_array<int> table_utils::scatter_array_;
-const int table_utils::SCATTER_ARRAY_NOT_SET = -1;
-int table_utils::scatter_size_ = table_utils::SCATTER_ARRAY_NOT_SET;
+const int table_utils::MIN_TABLE_SIZE = 1 << 10;
+const int table_utils::MAX_TABLE_SIZE = 1 << 30;
+const int table_utils::MAX_LOAD_INVERSE = 3;
+const int table_utils::SCATTER_KEY_NOT_SET = -1;
+int table_utils::scatter_size_ = table_utils::SCATTER_KEY_NOT_SET;
+unsigned int table_utils::scatter_mask_ = 0;
+unsigned int table_utils::scatter_seed_ = 0;
+int table_utils::scatter_shift_ = 1;
+
+int table_utils::table_size(int n) {
+  long wanted = static_cast<long>(n) * MAX_LOAD_INVERSE;
+  int size = MIN_TABLE_SIZE;
+  while (size < wanted && size < MAX_TABLE_SIZE) {
+    size <<= 1;
+  }
+  if (n >= size) {
+    // A full table would never find a free slot, so insert would not return.
+    error_on_processor("cannot hash %i entries in at most %i slots - abort\n",
+                       n, MAX_TABLE_SIZE);
+    MPI_Abort(MPI_COMM_WORLD, 0);
+  }
+  return size;
+}
 
-void table_utils::set_scatter_array(int size) {
+void table_utils::set_scatter_key(int size) {
   scatter_size_ = size;
-  if (size == SCATTER_ARRAY_NOT_SET) {
-    scatter_array_.resize(0);
+  if (size == SCATTER_KEY_NOT_SET) {
     return;
   }
-  scatter_array_.resize(scatter_size_);
 
-  for (int i = 0; i < scatter_size_; ++i) {
-    scatter_array_[i] = i;
+  int bits = 1;
+  while (bits < 31 && (1u << bits) < static_cast<unsigned int>(size)) {
+    ++bits;
   }
-
-  scatter_array_.random_permutation();
+  scatter_mask_ = (1u << bits) - 1;
+  scatter_shift_ = (bits + 1) / 2;
+  // Any seed gives a permutation. Deriving it from the size, rather than
+  // from the random number stream, keeps the scattering identical on every
+  // processor.
+  scatter_seed_ = (static_cast<unsigned int>(size) * 0x9e3779b9u) &
+                  scatter_mask_;
 }
 
 }  // namespace internal
@@ -22,16 +22,11 @@ void map_to_pos_int::create(int new_capacity, bool use_hash) {
     capacity_ = internal::table_utils::table_size(new_capacity);
     assert(capacity_ >= new_capacity);
 
-    keys.resize(capacity_);
-    table.resize(capacity_);
-
-    for (int i = 0; i < capacity_; ++i) {
-      keys[i] = -1;
-      table[i] = -1;
-    }
+    table.resize(0);
+    clear_slots();
   } else {
     capacity_ = new_capacity;
-    keys.resize(0);
+    slots.clear_and_shrink();
     table.resize(capacity_);
 
     for (int i = 0; i < capacity_; ++i) {
@@ -44,7 +39,7 @@ void map_to_pos_int::destroy() {
   size_ = 0;
   entries.resize(0);
   table.resize(0);
-  keys.resize(0);
+  slots.clear_and_shrink();
 }
 
 void map_to_pos_int::recover() {
@@ -54,22 +49,22 @@ void map_to_pos_int::recover() {
   entries.resize(2048);
 
   if (use_hash_) {
-    table.resize(capacity_);
-    keys.resize(capacity_);
-
-    for (i = 0; i < capacity_; ++i) {
-      keys[i] = -1;
-      table[i] = -1;
-    }
+    clear_slots();
   } else {
     table.resize(capacity_);
-    keys.resize(0);
 
     for (i = 0; i < capacity_; ++i)
       table[i] = -1;
   }
 }
 
+void map_to_pos_int::clear_slots() {
+  slot empty;
+  empty.key = -1;
+  empty.value = -1;
+  slots.assign(capacity_, empty);
+}
+
 int map_to_pos_int::insert(int key, int val) {
   #ifdef DEBUG_TABLES
   assert(key >= 0);
@@ -78,26 +73,25 @@ int map_to_pos_int::insert(int key, int val) {
 
   if (use_hash_) {
     int independent_key = internal::table_utils::scatter_key(key);
-    int slot = internal::hashes::primary(independent_key, capacity_);
+    int s = internal::hashes::home(independent_key, capacity_);
 
-    while (keys[slot] != -1 && keys[slot] != independent_key) {
-      slot = (slot + internal::hashes::secondary(independent_key, capacity_)) % capacity_;
+    while (slots[s].key != -1 && slots[s].key != independent_key) {
+      s = internal::hashes::next(s, capacity_);
     }
 
-    if (keys[slot] == -1) {
+    if (slots[s].key == -1) {
       #ifdef DEBUG_TABLES
-      assert(table[slot] == -1);
+      assert(slots[s].value == -1);
       #endif
-      table[slot] = val;
-      keys[slot] = independent_key;
-      entries[size_++] = slot;
+      slots[s].value = val;
+      slots[s].key = independent_key;
+      entries[size_++] = s;
       return false;
     } else {
       #ifdef DEBUG_TABLES
-      assert(keys[slot] == independent_key);
-      assert(table[slot] >= 0);
+      assert(slots[s].value >= 0);
       #endif
-      table[slot] = val;
+      slots[s].value = val;
       return true;
     }
   } else {
@@ -122,19 +116,19 @@ int map_to_pos_int::insert_if_empty(int key, int val) {
 
   if (use_hash_) {
     int independent_key = internal::table_utils::scatter_key(key);
-    int slot = internal::hashes::primary(independent_key, capacity_);
+    int s = internal::hashes::home(independent_key, capacity_);
 
-    while (keys[slot] != -1 && keys[slot] != independent_key) {
-      slot = (slot + internal::hashes::secondary(independent_key, capacity_)) % capacity_;
+    while (slots[s].key != -1 && slots[s].key != independent_key) {
+      s = internal::hashes::next(s, capacity_);
     }
 
-    if (keys[slot] == -1) {
-      table[slot] = val;
-      keys[slot] = independent_key;
-      entries[size_++] = slot;
+    if (slots[s].key == -1) {
+      slots[s].value = val;
+      slots[s].key = independent_key;
+      entries[size_++] = s;
       return -1;
     } else {
-      return table[slot];
+      return slots[s].value;
     }
   } else {
     #ifdef DEBUG_TABLES
@@ -153,13 +147,13 @@ int map_to_pos_int::insert_if_empty(int key, int val) {
 
 void map_to_pos_int::clear() {
   int i;
-  int slot;
+  int s;
 
   if (use_hash_) {
     for (i = 0; i < size_; ++i) {
-      slot = entries[i];
-      keys[slot] = -1;
-      table[slot] = -1;
+      s = entries[i];
+      slots[s].key = -1;
+      slots[s].value = -1;
     }
   } else {
     for (i = 0; i < size_; ++i) {
@@ -177,22 +171,22 @@ int map_to_pos_int::get_careful(int key) {
 
   if (use_hash_) {
     int independent_key = internal::table_utils::scatter_key(key);
-    int slot = internal::hashes::primary(independent_key, capacity_);
+    int s = internal::hashes::home(independent_key, capacity_);
 
-    while (keys[slot] != independent_key && keys[slot] != -1) {
-      slot = (slot + internal::hashes::secondary(independent_key, capacity_)) % capacity_;
+    while (slots[s].key != independent_key && slots[s].key != -1) {
+      s = internal::hashes::next(s, capacity_);
     }
 
-    if (keys[slot] == -1) {
+    if (slots[s].key == -1) {
       #ifdef DEBUG_TABLES
-      assert(table[slot] == -1);
+      assert(slots[s].value == -1);
       #endif
       return -1;
     } else {
       #ifdef DEBUG_TABLES
-      assert(table[slot] != -1);
+      assert(slots[s].value != -1);
       #endif
-      return table[slot];
+      return slots[s].value;
     }
   } else {
     #ifdef DEBUG_TABLES
@@ -212,16 +206,16 @@ int map_to_pos_int::get(int key) {
 
   if (use_hash_) {
     int independent_key = internal::table_utils::scatter_key(key);
-    int slot = internal::hashes::primary(independent_key, capacity_);
+    int s = internal::hashes::home(independent_key, capacity_);
 
-    while (keys[slot] != independent_key) {
-      slot = (slot + internal::hashes::secondary(independent_key, capacity_)) % capacity_;
+    while (slots[s].key != independent_key) {
+      s = internal::hashes::next(s, capacity_);
       #ifdef DEBUG_TABLES
-      assert(keys[slot] != -1);
+      assert(slots[s].key != -1);
       #endif
     }
 
-    return table[slot];
+    return slots[s].value;
   } else {
     #ifdef DEBUG_TABLES
     assert(key < capacity_);
@@ -51,6 +51,11 @@ int match_request_table::local_count(int _vertex) const {
   return entry_ ? entry_->number_local() : -1;
 }
 
+bool match_request_table::requested(int _vertex) const {
+  entry *entry_ = get_entry(_vertex);
+  return entry_ && entry_->requested();
+}
+
 void match_request_table::clear() {
   for (auto &ptr : table_) {
     if (ptr != nullptr) {
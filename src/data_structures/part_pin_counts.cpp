@@ -0,0 +1,119 @@
+#include "data_structures/part_pin_counts.hpp"
+
+namespace parkway {
+namespace data_structures {
+
+const int part_pin_counts::saturated;
+const int part_pin_counts::simd_width;
+
+void part_pin_counts::reset(int hyperedges, int parts) {
+  number_of_hyperedges_ = hyperedges;
+  parts_ = parts;
+  sparse_ = false;
+
+  // Short rows are only padded to keep them word aligned, they are never
+  // swept with SIMD instructions.
+  int pad = parts < simd_width ? 4 : simd_width;
+  stride_ = (parts + pad - 1) / pad * pad;
+
+  counts_.assign(static_cast<long>(hyperedges) * stride_, 0);
+  overflow_.clear();
+
+  offsets_.clear_and_shrink();
+  sizes_.clear_and_shrink();
+  sparse_parts_.clear_and_shrink();
+  sparse_counts_.clear_and_shrink();
+}
+
+void part_pin_counts::reset(int hyperedges, int parts,
+                            const int *capacities) {
+  number_of_hyperedges_ = hyperedges;
+  parts_ = parts;
+  sparse_ = true;
+  stride_ = (parts + simd_width - 1) / simd_width * simd_width;
+
+  counts_.clear_and_shrink();
+  overflow_.clear();
+
+  offsets_.resize(hyperedges + 1);
+  sizes_.assign(hyperedges, 0);
+
+  long offset = 0;
+  for (int i = 0; i < hyperedges; ++i) {
+    offsets_[i] = offset;
+    offset += std::min(capacities[i], parts);
+  }
+  offsets_[hyperedges] = offset;
+
+  sparse_parts_.resize(offset);
+  sparse_counts_.resize(offset);
+}
+
+void part_pin_counts::clear_and_shrink() {
+  number_of_hyperedges_ = 0;
+  stride_ = 0;
+  counts_.clear_and_shrink();
+  overflow_.clear();
+  offsets_.clear_and_shrink();
+  sizes_.clear_and_shrink();
+  sparse_parts_.clear_and_shrink();
+  sparse_counts_.clear_and_shrink();
+}
+
+int part_pin_counts::add_saturated(long i) {
+  if (counts_[i] != saturated) {
+    counts_[i] = saturated;
+    overflow_[i] = saturated;
+    return saturated;
+  }
+  return ++overflow_[i];
+}
+
+int part_pin_counts::remove_saturated(long i) {
+  int count = --overflow_[i];
+  if (count < saturated) {
+    overflow_.erase(i);
+    counts_[i] = static_cast<count_type>(count);
+  }
+  return count;
+}
+
+int part_pin_counts::add_sparse(int hyperedge, int part) {
+  int *first = sparse_parts_.data() + offsets_[hyperedge];
+  int *last = first + sizes_[hyperedge];
+  int *it = std::lower_bound(first, last, part);
+  long i = it - sparse_parts_.data();
+
+  if (it != last && *it == part) {
+    return ++sparse_counts_[i];
+  }
+
+  // Keep the list sorted. There is always room: a hyperedge cannot span more
+  // parts than it has pins.
+  long end = offsets_[hyperedge] + sizes_[hyperedge];
+  std::copy_backward(it, last, last + 1);
+  std::copy_backward(sparse_counts_.data() + i, sparse_counts_.data() + end,
+                     sparse_counts_.data() + end + 1);
+  *it = part;
+  sparse_counts_[i] = 1;
+  ++sizes_[hyperedge];
+  return 1;
+}
+
+int part_pin_counts::remove_sparse(int hyperedge, int part) {
+  long i = find(hyperedge, part);
+  int count = --sparse_counts_[i];
+
+  if (count == 0) {
+    long end = offsets_[hyperedge] + sizes_[hyperedge];
+    std::copy(sparse_parts_.data() + i + 1, sparse_parts_.data() + end,
+              sparse_parts_.data() + i);
+    std::copy(sparse_counts_.data() + i + 1, sparse_counts_.data() + end,
+              sparse_counts_.data() + i);
+    --sizes_[hyperedge];
+  }
+  return count;
+}
+
+}  // namespace data_structures
+}  // namespace parkway
@@ -0,0 +1,73 @@
+#include "data_structures/part_set_table.hpp"
+
+namespace parkway {
+namespace data_structures {
+
+void part_set_table::reset(int sets, int parts) {
+  parts_ = parts;
+  sparse_ = false;
+
+  flags_.assign(static_cast<long>(sets) * parts, 0);
+
+  offsets_.clear_and_shrink();
+  sizes_.clear_and_shrink();
+  members_.clear_and_shrink();
+}
+
+void part_set_table::reset(int sets, int parts, const int *capacities) {
+  parts_ = parts;
+  sparse_ = true;
+
+  flags_.clear_and_shrink();
+
+  offsets_.resize(sets + 1);
+  sizes_.assign(sets, 0);
+
+  long offset = 0;
+  for (int i = 0; i < sets; ++i) {
+    offsets_[i] = offset;
+    offset += std::min(capacities[i], parts);
+  }
+  offsets_[sets] = offset;
+
+  members_.resize(offset);
+}
+
+void part_set_table::clear_and_shrink() {
+  flags_.clear_and_shrink();
+  offsets_.clear_and_shrink();
+  sizes_.clear_and_shrink();
+  members_.clear_and_shrink();
+}
+
+bool part_set_table::insert_sparse(int set, int part) {
+  int *first = members_.data() + offsets_[set];
+  int *last = first + sizes_[set];
+  int *it = std::lower_bound(first, last, part);
+
+  if (it != last && *it == part) {
+    return false;
+  }
+
+  std::copy_backward(it, last, last + 1);
+  *it = part;
+  ++sizes_[set];
+  return true;
+}
+
+bool part_set_table::erase_sparse(int set, int part) {
+  int *first = members_.data() + offsets_[set];
+  int *last = first + sizes_[set];
+  int *it = std::lower_bound(first, last, part);
+
+  if (it == last || *it != part) {
+    return false;
+  }
+
+  std::copy(it + 1, last, it);
+  --sizes_[set];
+  return true;
+}
+
+}  // namespace data_structures
+}  // namespace parkway
@@ -20,15 +20,36 @@
 //
 // ###
 #include "hypergraph/parallel/hypergraph.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include "data_structures/bit_field.hpp"
 #include "data_structures/complete_binary_tree.hpp"
 #include "data_structures/map_from_pos_int.hpp"
-#include "data_structures/new_hyperedge_index_table.hpp"
 #include "utility/sorting.hpp"
 #include "utility/logging.hpp"
 
 namespace parkway {
 namespace parallel {
+
+namespace {
+// Hyperedges handled by each task when contracting with a thread pool.
+const int hyperedges_per_task = 4096;
+
+void for_each_task(utility::thread_pool *pool, int tasks,
+                   const utility::thread_pool::work_type &work) {
+  if (pool && tasks > 1) {
+    pool->run(tasks, work);
+  } else {
+    for (int task = 0; task < tasks; ++task) {
+      work(task, 0);
+    }
+  }
+}
+}  // namespace
 namespace ds = parkway::data_structures;
 hypergraph::hypergraph(int rank, int number_of_processors,
                        int number_of_local_vertices, int total_vertices,
@@ -75,10 +96,14 @@ hypergraph::hypergraph(int rank, int number_of_processors,
 }
 
 hypergraph::hypergraph(int rank, int number_of_processors, const char *filename,
-                       MPI_Comm comm)
+                       MPI_Comm comm, bool single_file)
     : global_communicator(rank, number_of_processors) {
   LOG(trace) << "Constructing a hypergraph from " << filename;
-  load_from_file(filename, comm);
+  if (single_file) {
+    load_from_mapped_file(filename, comm);
+  } else {
+    load_from_file(filename, comm);
+  }
 }
 
 
@@ -150,6 +175,202 @@ void hypergraph::load_from_file(const char *filename, MPI_Comm comm) {
   check_loaded_vertex_and_hyperedge_lengths(filename, comm);
 }
 
+void hypergraph::load_from_mapped_file(const char *filename, MPI_Comm comm) {
+  LOG(trace) << "Memory mapping hypergraph file " << filename;
+  int file_descriptor = open(filename, O_RDONLY);
+  if (file_descriptor < 0) {
+    error_on_processor("p[%i] could not open %s\n", rank_, filename);
+    MPI_Abort(comm, 0);
+  }
+
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0 ||
+      file_status.st_size < static_cast<off_t>(sizeof(int) * 3)) {
+    error_on_processor("p[%i] could not read in metadata\n", rank_);
+    close(file_descriptor);
+    MPI_Abort(comm, 0);
+  }
+
+  std::size_t file_length = static_cast<std::size_t>(file_status.st_size);
+  void *mapping = mmap(nullptr, file_length, PROT_READ, MAP_PRIVATE,
+                       file_descriptor, 0);
+  close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    error_on_processor("p[%i] could not map %s\n", rank_, filename);
+    MPI_Abort(comm, 0);
+  }
+  madvise(mapping, file_length, MADV_SEQUENTIAL);
+
+  // The file is laid out as:
+  // [0]-[2] = |V|, |E|, |pins|
+  // then chunks of the form [chunk length][hyperedge blocks...]
+  // with the |V| vertex weights at the very end of the file.
+  const int *data = static_cast<const int *>(mapping);
+  std::size_t file_ints = file_length / sizeof(int);
+  total_number_of_vertices_ = data[0];
+  int total_hyperedges = data[1];
+  if (total_number_of_vertices_ < processors_ ||
+      static_cast<std::size_t>(total_number_of_vertices_) + 3 > file_ints) {
+    error_on_processor("p[%i] %s is not a valid hypergraph file\n", rank_,
+                       filename);
+    munmap(mapping, file_length);
+    MPI_Abort(comm, 0);
+  }
+
+  // Vertices and hyperedges are split as by the converter, the last processor
+  // also taking the remainder.
+  int vertices_per_processor = total_number_of_vertices_ / processors_;
+  int hyperedges_per_processor = total_hyperedges / processors_;
+  minimum_vertex_index_ = vertices_per_processor * rank_;
+  number_of_vertices_ = vertices_per_processor;
+  int number_to_load = hyperedges_per_processor;
+  if (rank_ == processors_ - 1) {
+    number_of_vertices_ += total_number_of_vertices_ % processors_;
+    number_to_load += total_hyperedges % processors_;
+  }
+
+  std::size_t weights_offset = file_ints - total_number_of_vertices_;
+  const int *weights = data + weights_offset + minimum_vertex_index_;
+  vertex_weights_.resize(number_of_vertices_);
+  std::copy(weights, weights + number_of_vertices_, vertex_weights_.begin());
+
+  // Build an index of the chunks -- each processor only needs to follow the
+  // chunk headers here, not the hyperedges within them.
+  dynamic_array<std::size_t> chunk_offsets;
+  std::size_t offset = 3;
+  while (offset < weights_offset) {
+    chunk_offsets.push_back(offset);
+    offset += data[offset] + 1;
+  }
+  if (offset != weights_offset) {
+    error_on_processor("p[%i] %s has a corrupt hyperedge chunk header\n",
+                       rank_, filename);
+    munmap(mapping, file_length);
+    MPI_Abort(comm, 0);
+  }
+  int number_of_chunks = chunk_offsets.size();
+  chunk_offsets.push_back(weights_offset);
+
+  // Each processor counts the hyperedges in a contiguous block of chunks and
+  // the counts are shared, so that each processor can seek straight to the
+  // chunk holding its first hyperedge.
+  dynamic_array<int> chunk_hyperedges(number_of_chunks + 1, 0);
+  dynamic_array<int> chunks_on_processor(processors_);
+  dynamic_array<int> chunk_displacements(processors_);
+  for (int p = 0; p < processors_; ++p) {
+    chunk_displacements[p] =
+        static_cast<long>(number_of_chunks) * p / processors_;
+    chunks_on_processor[p] =
+        static_cast<long>(number_of_chunks) * (p + 1) / processors_ -
+        chunk_displacements[p];
+  }
+
+  int first_chunk = chunk_displacements[rank_];
+  int last_chunk = first_chunk + chunks_on_processor[rank_];
+  bool corrupt = false;
+  for (int c = first_chunk; c < last_chunk && !corrupt; ++c) {
+    std::size_t end = chunk_offsets[c + 1];
+    int count = 0;
+    for (offset = chunk_offsets[c] + 1; offset < end; offset += data[offset]) {
+      if (data[offset] < 2) {
+        corrupt = true;
+        break;
+      }
+      ++count;
+    }
+    corrupt |= offset != end;
+    chunk_hyperedges[c] = count;
+  }
+
+  int any_corrupt = corrupt;
+  MPI_Allreduce(MPI_IN_PLACE, &any_corrupt, 1, MPI_INT, MPI_MAX, comm);
+  if (any_corrupt) {
+    if (corrupt) {
+      error_on_processor("p[%i] %s has a corrupt hyperedge block\n", rank_,
+                         filename);
+    }
+    munmap(mapping, file_length);
+    MPI_Abort(comm, 0);
+  }
+
+  MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, chunk_hyperedges.data(),
+                 chunks_on_processor.data(), chunk_displacements.data(),
+                 MPI_INT, comm);
+
+  info("|--- Hypergraph %s (on file):\n"
+       "| |V| = %i\n"
+       "| |E| = %i\n", filename, total_number_of_vertices_, total_hyperedges);
+
+  // Seek to this processor's first hyperedge.
+  int to_skip = hyperedges_per_processor * rank_;
+  int chunk = 0;
+  while (chunk < number_of_chunks && to_skip >= chunk_hyperedges[chunk]) {
+    to_skip -= chunk_hyperedges[chunk++];
+  }
+  offset = chunk < number_of_chunks ? chunk_offsets[chunk] + 1 :
+      weights_offset;
+  for (; to_skip > 0; --to_skip) {
+    offset += data[offset];
+  }
+
+  // Steps over chunk headers (and empty chunks) once the end of a chunk is
+  // reached.
+  auto next_hyperedge_block = [&](std::size_t &position, int &current) {
+    while (current < number_of_chunks &&
+           position == chunk_offsets[current + 1]) {
+      if (++current < number_of_chunks) {
+        position = chunk_offsets[current] + 1;
+      }
+    }
+  };
+
+  // First pass sizes the local arrays, the second fills them. Hyperedges with
+  // a single pin are dropped, as in load_data_from_blocks.
+  std::size_t start_offset = offset;
+  int start_chunk = chunk;
+  number_of_hyperedges_ = 0;
+  number_of_pins_ = 0;
+  for (int i = 0; i < number_to_load && chunk < number_of_chunks; ++i) {
+    int length = data[offset] - 2;
+    if (length > 1) {
+      ++number_of_hyperedges_;
+      number_of_pins_ += length;
+    }
+    offset += data[offset];
+    next_hyperedge_block(offset, chunk);
+  }
+
+  allocate_hyperedge_memory(number_of_hyperedges_, number_of_pins_);
+  offset = start_offset;
+  chunk = start_chunk;
+  int hyperedge_index = 0;
+  int pin_counter = 0;
+  for (int i = 0; i < number_to_load && chunk < number_of_chunks; ++i) {
+    int length = data[offset] - 2;
+    if (length > 1) {
+      hyperedge_weights_[hyperedge_index] = data[offset + 1];
+      hyperedge_offsets_[hyperedge_index++] = pin_counter;
+      std::copy(data + offset + 2, data + offset + 2 + length,
+                pin_list_.begin() + pin_counter);
+      pin_counter += length;
+    }
+    offset += data[offset];
+    next_hyperedge_block(offset, chunk);
+  }
+  hyperedge_offsets_[hyperedge_index] = pin_counter;
+  munmap(mapping, file_length);
+
+  match_vector_.assign(number_of_vertices_, -1);
+  vertex_weight_ = 0;
+  for (const auto &weight : vertex_weights_) {
+    vertex_weight_ += weight;
+  }
+  do_not_coarsen = 0;
+  number_of_partitions_ = 0;
+
+  check_loaded_vertex_and_hyperedge_lengths(filename, comm);
+}
+
 void hypergraph::initalize_partition_from_file(
     const char *filename, int number_of_parts, MPI_Comm comm) {
   LOG(trace) << "Initializing partition from file";
@@ -191,7 +412,8 @@ void hypergraph::allocate_hyperedge_memory(int numHedges, int numLocPins) {
   pin_list_.resize(numLocPins);
 }
 
-void hypergraph::contract_hyperedges(hypergraph &coarse, MPI_Comm comm) {
+void hypergraph::contract_hyperedges(hypergraph &coarse, MPI_Comm comm,
+                                     utility::thread_pool *pool) {
   LOG(trace) << "Contracting hyperedges";
 
   int vertices_per_proc_fine = total_number_of_vertices_ / processors_;
@@ -201,30 +423,18 @@ void hypergraph::contract_hyperedges(hypergraph &coarse, MPI_Comm comm) {
 
   // Compute number of elements to send to other processors.
   ds::dynamic_array<int> copy_of_requests;
+  start_count_exchange(comm);
   int total_to_send = compute_number_of_elements_to_send(copy_of_requests);
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
 
   // compute number of elements to receive from other processors
-  int total_to_receive = compute_number_of_elements_to_receive();
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
-
-  // now have received all requests and sent out our requests the reply
-  // communication will have the dual dimensions
-  send_array_.resize(total_to_receive);
-  for (int i = 0; i < total_to_receive; ++i) {
-    send_array_[i] = match_vector_[receive_array_[i] - minimum_vertex_index_];
-  }
-
-  receive_array_.resize(total_to_send);
-  MPI_Alltoallv(send_array_.data(), receive_lens_.data(),
-                receive_displs_.data(), MPI_INT, receive_array_.data(),
-                send_lens_.data(), send_displs_.data(), MPI_INT, comm);
-
+  int total_to_receive = finish_count_exchange();
+  exchange(comm);
 
+  // now have received all requests and sent out our requests, reply with the
+  // match_vector values of the requested vertices
+  reply_to_requests(1, [this](int vertex, int *out) {
+    *out = match_vector_[vertex - minimum_vertex_index_];
+  }, comm);
 
   // Requested vertices are in the copy_of_requests while their corresponding
   // match_vector values are in the corresponding location in the receive_array_
@@ -235,22 +445,12 @@ void hypergraph::contract_hyperedges(hypergraph &coarse, MPI_Comm comm) {
                                    copy_of_requests);
 
   // send coarse hyperedges to appropriate processors via hash function
-  send_coarse_hyperedges(original_contracted_pin_list, copy_of_requests,
-                         total_to_send, total_to_receive, comm);
+  send_coarse_hyperedges(original_contracted_pin_list, total_to_send,
+                         total_to_receive, comm, pool);
 
   // Should have received all hyperedges destined for processor now build the
-  // coarse hypergraph pin-list
-  int table_size = static_cast<int>(
-      ceil(static_cast<double>(number_of_hyperedges_) * 1.5));
-  ds::new_hyperedge_index_table table(table_size);
-
-  // run through the recv data
-  // for each encountered hyperedge:
-  // - compute hash-key
-  // - check for duplicates in the hash table
-  // - if duplicate not found, add to list
-  // - if duplicate found, increment its weight
-  process_new_hyperedges(coarse, table, total_to_receive);
+  // coarse hypergraph pin-list, merging duplicate hyperedges
+  process_new_hyperedges(coarse, total_to_receive, pool);
 }
 
 
@@ -274,27 +474,18 @@ void hypergraph::contractRestrHyperedges(hypergraph &coarse, MPI_Comm comm) {
 
   // Compute number of elements to send to other processors
   ds::dynamic_array<int> copy_of_requests;
+  start_count_exchange(comm);
   int total_to_send = compute_number_of_elements_to_send(copy_of_requests);
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
 
   // Compute number of elements to receive from other processors
-  int total_to_receive = compute_number_of_elements_to_receive();
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
-
-  // now have received all requests and sent out our requests the reply
-  // communication will have the dual dimensions
-  send_array_.resize(total_to_receive);
-  for (int i = 0; i < total_to_receive; ++i) {
-    send_array_[i] = match_vector_[receive_array_[i] - minimum_vertex_index_];
-  }
+  int total_to_receive = finish_count_exchange();
+  exchange(comm);
 
-  receive_array_.resize(total_to_send);
-  MPI_Alltoallv(send_array_.data(), receive_lens_.data(),
-                receive_displs_.data(), MPI_INT, receive_array_.data(),
-                send_lens_.data(), send_displs_.data(), MPI_INT, comm);
+  // now have received all requests and sent out our requests, reply with the
+  // match_vector values of the requested vertices
+  reply_to_requests(1, [this](int vertex, int *out) {
+    *out = match_vector_[vertex - minimum_vertex_index_];
+  }, comm);
 
   // Requested vertices are in the copy_of_requests data while their
   // corresponding matchVector values are in the corresponding location in the
@@ -302,24 +493,14 @@ void hypergraph::contractRestrHyperedges(hypergraph &coarse, MPI_Comm comm) {
   choose_non_local_vertices_format(total_to_send, original_contracted_pin_list,
                                    copy_of_requests);
 
-  send_coarse_hyperedges(original_contracted_pin_list, copy_of_requests,
-                         total_to_send, total_to_receive, comm);
+  send_coarse_hyperedges(original_contracted_pin_list, total_to_send,
+                         total_to_receive, comm, nullptr);
 
   // Should have received all hyperedges destined for processor now build the
-  // coarse hypergraph pin-list
-  int table_size = static_cast<int>(
-      ceil(static_cast<double>(number_of_hyperedges_) * 1.1));
-  ds::new_hyperedge_index_table table(table_size);
-
-  // run through the recv data_
-  // for each encountered hyperedge:
-  // - compute hash-key
-  // - check for duplicates in the hash table
-  // - if duplicate not found, add to list
-  // - if duplicate found, increment its weight
+  // coarse hypergraph pin-list, merging duplicate hyperedges
 
   // NEED TO MODIFY THE RESTR HEDGE CONTRACTION TO CORRESPOND WITH NORMAL.
-  process_new_hyperedges(coarse, table, total_to_receive);
+  process_new_hyperedges(coarse, total_to_receive, nullptr);
 }
 
 
@@ -365,8 +546,10 @@ void hypergraph::project_partitions(hypergraph &coarse, MPI_Comm comm) {
   total = 0;
   for (int i = 0; i < processors_; ++i) {
     send_displs_[i] = total;
-    total += send_lens_[i] >> 1;
+    send_lens_[i] >>= 1;
+    total += send_lens_[i];
   }
+  start_count_exchange(comm);
 
   send_array_.resize(total);
   dynamic_array<int> requesting_local_vertices(total);
@@ -375,56 +558,25 @@ void hypergraph::project_partitions(hypergraph &coarse, MPI_Comm comm) {
   int ij = 0;
   for (int i = 0; i < processors_; ++i) {
     int j = 0;
-    int send_length = send_lens_[i];
-    while (j < send_lens_[i]) {
+    int send_length = send_lens_[i] << 1;
+    while (j < send_length) {
       requesting_local_vertices[ij] = data_out_sets_[i][j++];
       send_array_[ij++] = data_out_sets_[i][j++];
     }
-    send_lens_[i] = send_length >> 1;
   }
 
   // get dimension and carry out the communication
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
+  finish_count_exchange();
+  exchange(comm);
 
-  int total_to_receive = compute_number_of_elements_to_receive();
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
-
-  // process the requests for local vertex partitions dimensions of
-  // cummunication are reversed!
-  int total_to_send = total_to_receive * number_of_partitions_;
-  send_array_.resize(total_to_send);
-
-  ij = 0;
-  for (int i = 0; i < total_to_receive; ++i) {
-    int vertex = receive_array_[i] - min_coarse_vertex;
+  // process the requests for local vertex partitions, replying with the
+  // vertex's part in each of the partitions
+  reply_to_requests(number_of_partitions_, [&](int vertex, int *out) {
+    vertex -= min_coarse_vertex;
     for (int j = 0; j < number_of_partitions_; ++j) {
-      send_array_[ij++] =
-          coarse_partition[coarse_partition_offsets[j] + vertex];
+      out[j] = coarse_partition[coarse_partition_offsets[j] + vertex];
     }
-  }
-
-  for (int i = 0; i < processors_; ++i) {
-    ij = receive_lens_[i];
-    receive_lens_[i] = send_lens_[i] * number_of_partitions_;
-    send_lens_[i] = ij * number_of_partitions_;
-  }
-
-  ij = 0;
-  int size = 0;
-  for (int i = 0; i < processors_; ++i) {
-    send_displs_[i] = ij;
-    receive_displs_[i] = size;
-    ij += send_lens_[i];
-    size += receive_lens_[i];
-  }
-
-  receive_array_.resize(size);
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  }, comm);
 
   // finish off initialising the partition vector
   ij = 0;
@@ -605,7 +757,6 @@ void hypergraph::prescribed_vertex_shuffle(ds::dynamic_array<int> &mapToOrigV,
 
   int vPerProc = total_number_of_vertices_ / processors_;
   int max_local_vertex = minimum_vertex_index_ + number_of_vertices_;
-  int total_to_receive;
   int total_to_send;
   int arrayLen;
   int vertex;
@@ -645,6 +796,8 @@ void hypergraph::prescribed_vertex_shuffle(ds::dynamic_array<int> &mapToOrigV,
 
   /* compute number of elements to send to other processors */
 
+  start_count_exchange(comm);
+
   j = 0;
   for (i = 0; i < processors_; ++i) {
     send_displs_[i] = j;
@@ -668,39 +821,18 @@ void hypergraph::prescribed_vertex_shuffle(ds::dynamic_array<int> &mapToOrigV,
     }
   }
 
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
   // compute number of elements to receive from other processors
-  j = 0;
-  for (i = 0; i < processors_; ++i) {
-    receive_displs_[i] = j;
-    j += receive_lens_[i];
-  }
-
-  receive_array_.resize(j);
-  total_to_receive = j;
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  finish_count_exchange();
+  exchange(comm);
 
   /*
     now have received all requests and sent out our requests
-    the reply communication will have the dual dimensions
+    reply with the requested mapToOrigV entries
   */
 
-  send_array_.resize(total_to_receive);
-
-  for (i = 0; i < total_to_receive; ++i) {
-    send_array_[i] = copyOfMapToOrigV[receive_array_[i] - minimum_vertex_index_];
-  }
-
-  receive_array_.resize(total_to_send);
-
-  MPI_Alltoallv(send_array_.data(), receive_lens_.data(),
-                receive_displs_.data(), MPI_INT, receive_array_.data(),
-                send_lens_.data(), send_displs_.data(), MPI_INT, comm);
+  reply_to_requests(1, [&](int vertex, int *out) {
+    *out = copyOfMapToOrigV[vertex - minimum_vertex_index_];
+  }, comm);
 
   /*
      now the requested vertices are in the copy_of_requests data_
@@ -939,29 +1071,18 @@ void hypergraph::shuffle_vertices(
 
   // compute number of elements to send to other processors
   dynamic_array<int> copy_of_requests;
+  start_count_exchange(comm);
   int total_to_send = compute_number_of_elements_to_send(copy_of_requests);
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
 
   // compute number of elements to receive from other processors
-  int total_to_receive = compute_number_of_elements_to_receive();
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  finish_count_exchange();
+  exchange(comm);
 
-  // now have received all requests and sent out our requests the reply
-  // communication will have the dual dimensions
-  send_array_.resize(total_to_receive);
-
-  for (int i = 0; i < total_to_receive; ++i) {
-    send_array_[i] = old_to_new_index[receive_array_[i] -
-        minimum_vertex_index_];
-  }
-  receive_array_.resize(total_to_send);
-
-  MPI_Alltoallv(send_array_.data(), receive_lens_.data(),
-                receive_displs_.data(), MPI_INT, receive_array_.data(),
-                send_lens_.data(), send_displs_.data(), MPI_INT, comm);
+  // now have received all requests and sent out our requests, reply with the
+  // new indices of the requested vertices
+  reply_to_requests(1, [&](int vertex, int *out) {
+    *out = old_to_new_index[vertex - minimum_vertex_index_];
+  }, comm);
 
 
   // now the requested vertices are in the copy_of_requests data_ while their
@@ -1021,6 +1142,8 @@ void hypergraph::shuffle_vertices(
     }
   }
 
+  // the communication dimensions are known, exchange them while packing
+  start_count_exchange(comm);
   send_array_.resize(total_to_send);
 
   // compute the send data_
@@ -1040,15 +1163,9 @@ void hypergraph::shuffle_vertices(
     index_into_send_array[j] += 2 + extra_offset;
   }
 
-  // compute communication dimensions and carry out communication
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
-  total_to_receive = compute_number_of_elements_to_receive();
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  // carry out communication
+  int total_to_receive = finish_count_exchange();
+  exchange(comm);
 
   // change the local vertex information
   number_of_vertices_ = total_vertices_per_processor[rank_];
@@ -1153,6 +1270,8 @@ void hypergraph::shuffleVerticesAftRandom(
 
   /* compute number of elements to send to other processors */
 
+  start_count_exchange(comm);
+
   int total_to_send = 0;
   for (int i = 0; i < processors_; ++i) {
     send_displs_[i] = total_to_send;
@@ -1173,40 +1292,19 @@ void hypergraph::shuffleVerticesAftRandom(
   }
 
 
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
   /* compute number of elements to receive from other processors */
 
-  j = 0;
-  for (int i = 0; i < processors_; ++i) {
-    receive_displs_[i] = j;
-    j += receive_lens_[i];
-  }
-
-  receive_array_.resize(j);
-  total_to_receive = j;
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  total_to_receive = finish_count_exchange();
+  exchange(comm);
 
   /*
     now have received all requests and sent out our requests
-    the reply communication will have the dual dimensions
+    reply with the new indices of the requested vertices
   */
 
-  send_array_.resize(total_to_receive);
-
-  for (int i = 0; i < total_to_receive; ++i) {
-    send_array_[i] = old_to_new_index[receive_array_[i] - minimum_vertex_index_];
-  }
-
-  receive_array_.resize(total_to_send);
-
-  MPI_Alltoallv(send_array_.data(), receive_lens_.data(),
-                receive_displs_.data(), MPI_INT, receive_array_.data(),
-                send_lens_.data(), send_displs_.data(), MPI_INT, comm);
+  reply_to_requests(1, [&](int vertex, int *out) {
+    *out = old_to_new_index[vertex - minimum_vertex_index_];
+  }, comm);
 
   /*
      now the requested vertices are in the copy_of_requests data_
@@ -1280,6 +1378,7 @@ void hypergraph::shuffleVerticesAftRandom(
     }
   }
 
+  start_count_exchange(comm);
   send_array_.resize(total_to_send);
   /* compute the send data_ */
   if (!vToOrigVexist) {
@@ -1311,26 +1410,10 @@ void hypergraph::shuffleVerticesAftRandom(
     }
   }
 
-  /*
-    compute communication dimensions
-    and carry out communication
-  */
-
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
-  j = 0;
-  for (int i = 0; i < processors_; ++i) {
-    receive_displs_[i] = j;
-    j += receive_lens_[i];
-  }
+  /* carry out communication */
 
-  receive_array_.resize(j);
-  total_to_receive = j;
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  total_to_receive = finish_count_exchange();
+  exchange(comm);
 
   /* change the local vertex information */
 
@@ -1455,6 +1538,8 @@ void hypergraph::shuffleVerticesAftRandom(ds::dynamic_array<int> &vertex_to_proc
 
   /* compute number of elements to send to other processors */
 
+  start_count_exchange(comm);
+
   j = 0;
   for (i = 0; i < processors_; ++i) {
     send_displs_[i] = j;
@@ -1479,47 +1564,19 @@ void hypergraph::shuffleVerticesAftRandom(ds::dynamic_array<int> &vertex_to_proc
   assert(j == total_to_send);
 #endif
 
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
   /* compute number of elements to receive from other processors */
 
-  j = 0;
-  for (i = 0; i < processors_; ++i) {
-    receive_displs_[i] = j;
-    j += receive_lens_[i];
-  }
-
-  receive_array_.resize(j);
-  total_to_receive = j;
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  total_to_receive = finish_count_exchange();
+  exchange(comm);
 
   /*
     now have received all requests and sent out our requests
-    the reply communication will have the dual dimensions
+    reply with the new indices of the requested vertices
   */
 
-  send_array_.resize(total_to_receive);
-
-  for (i = 0; i < total_to_receive; ++i) {
-#ifdef DEBUG_HYPERGRAPH
-    assert(receive_array_[i] >= minVertexIndex &&
-           receive_array_[i] < max_local_vertex);
-#endif
-    send_array_[i] = old_to_new_index[receive_array_[i] - minimum_vertex_index_];
-#ifdef DEBUG_HYPERGRAPH
-    assert(send_array_[i] >= 0 && send_array_[i] < numTotalVertices);
-#endif
-  }
-
-  receive_array_.resize(total_to_send);
-
-  MPI_Alltoallv(send_array_.data(), receive_lens_.data(),
-                receive_displs_.data(), MPI_INT, receive_array_.data(),
-                send_lens_.data(), send_displs_.data(), MPI_INT, comm);
+  reply_to_requests(1, [&](int vertex, int *out) {
+    *out = old_to_new_index[vertex - minimum_vertex_index_];
+  }, comm);
 
   /*
     now the requested vertices are in the copy_of_requests data_
@@ -1651,6 +1708,7 @@ void hypergraph::shuffleVerticesAftRandom(ds::dynamic_array<int> &vertex_to_proc
   assert(j == total_to_send);
 #endif
 
+  start_count_exchange(comm);
   send_array_.resize(total_to_send);
 
   /* compute the send data_ */
@@ -1684,33 +1742,10 @@ void hypergraph::shuffleVerticesAftRandom(ds::dynamic_array<int> &vertex_to_proc
     }
   }
 
-  /*
-     compute communication dimensions
-     and carry out communication
-  */
+  /* carry out communication */
 
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
-  j = 0;
-  for (i = 0; i < processors_; ++i) {
-    receive_displs_[i] = j;
-    j += receive_lens_[i];
-  }
-
-#ifdef DEBUG_HYPERGRAPH
-  if (vToOrigVexist > 0)
-    assert(j == numLocalVertices * (numPartitions + 2));
-  else
-    assert(j == numLocalVertices * (numPartitions + 1));
-#endif
-
-  receive_array_.resize(j);
-  total_to_receive = j;
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  total_to_receive = finish_count_exchange();
+  exchange(comm);
 
   /* change the local vertex information */
 
@@ -2221,23 +2256,14 @@ void hypergraph::check_vertex_and_hyperedge_lengths(
     int hyperedge_data_length, const dynamic_array<int> &hyperedge_data,
     const char *filename, MPI_Comm comm) {
   int hyperedges_in_file = 0;
-  int j = 0;
   for (int i = 0; i < hyperedge_data_length; i += hyperedge_data[i]) {
-    int hyperedge_index = hyperedge_data[i] - 2;
-    if (hyperedge_index > j) {
-      j = hyperedge_index;
-    }
     ++hyperedges_in_file;
   }
 
-  int max_hyperedge_length;
   int number_of_edges;
-  MPI_Allreduce(&j, &max_hyperedge_length, 1, MPI_INT, MPI_MAX, comm);
   MPI_Reduce(&hyperedges_in_file, &number_of_edges, 1, MPI_INT, MPI_SUM, 0,
              comm);
 
-  Funct::setMaxHedgeLen(max_hyperedge_length);
-
   info("|--- Hypergraph %s (on file):\n"
        "| |V| = %i\n"
        "| |E| = %i\n", filename, total_number_of_vertices_, number_of_edges);
@@ -2395,16 +2421,21 @@ void hypergraph::choose_non_local_vertices_format(
 
 void hypergraph::send_coarse_hyperedges(
     ds::dynamic_array<int> original_contracted_pin_list,
-    ds::dynamic_array<int> copy_of_requests,
-    int &total_to_send, int &total_to_receive, MPI_Comm comm) {
-  for (int i = 0; i < number_of_hyperedges_; ++i) {
-    int j = hyperedge_offsets_[i + 1] - hyperedge_offsets_[i];
-    int start = hyperedge_offsets_[i];
-    original_contracted_pin_list.sort_between(start, start + j - 1);
-  }
+    int &total_to_send, int &total_to_receive, MPI_Comm comm,
+    utility::thread_pool *pool) {
+  int *pins = original_contracted_pin_list.data();
+  int tasks = (number_of_hyperedges_ + hyperedges_per_task - 1) /
+              hyperedges_per_task;
+
+  for_each_task(pool, tasks, [&](int task, int) {
+    int end = std::min(number_of_hyperedges_, (task + 1) * hyperedges_per_task);
+    for (int i = task * hyperedges_per_task; i < end; ++i) {
+      int start = hyperedge_offsets_[i];
+      utility::sort_short(pins + start, hyperedge_offsets_[i + 1] - start);
+    }
+  });
 
   int contracted_pin_list_length = 0;
-  int max_local_coarse_hedge_length = 0;
   int number_of_contracted_hedges = 0;
   int contracted_hedge_length = 0;
   dynamic_array<int> contracted_hedge_offsets(number_of_hyperedges_);
@@ -2430,23 +2461,13 @@ void hypergraph::send_coarse_hyperedges(
     if (contracted_hedge_length > 1) {
       contracted_pin_list_length += contracted_hedge_length;
       contracted_hedge_weights[number_of_contracted_hedges++] = hyperedge_weights_[i];
-      if (contracted_hedge_length > max_local_coarse_hedge_length) {
-        max_local_coarse_hedge_length = contracted_hedge_length;
-      }
     }
   }
 
   contracted_hedge_offsets[number_of_contracted_hedges] = contracted_pin_list_length;
 
-  // - compute max_coarse_hedge_length and set in Funct
   // - compute hash-keys for each hyperedge
   // - send hyperedges to processor determined by corresponding hash key
-  int max_coarse_hedge_length;
-  MPI_Allreduce(&max_local_coarse_hedge_length, &max_coarse_hedge_length, 1,
-                MPI_INT, MPI_MAX, comm);
-
-  Funct::setMaxHedgeLen(max_coarse_hedge_length);
-
   send_lens_.assign(processors_, 0);
   for (int i = 0; i < number_of_contracted_hedges; ++i) {
     int start_offset = contracted_hedge_offsets[i];
@@ -2464,21 +2485,19 @@ void hypergraph::send_coarse_hyperedges(
     }
   }
 
-  // Compute number of elements to send to other processors
-  total_to_send = compute_number_of_elements_to_send(copy_of_requests);
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
-  // Compute number of elements to receive from other processors.
-  total_to_receive = compute_number_of_elements_to_receive();
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  // The hyperedges are sent straight out of data_out_sets_.
+  total_to_send = 0;
+  for (int i = 0; i < processors_; ++i) {
+    total_to_send += send_lens_[i];
+  }
+  total_to_receive = send_from_data_out(comm);
 }
 
 void hypergraph::process_new_hyperedges(hypergraph &coarse,
-                                        ds::new_hyperedge_index_table &table,
-                                        int total_to_receive) {
+                                        int total_to_receive,
+                                        utility::thread_pool *pool) {
+  typedef std::pair<HashKey, int> keyed_hyperedge;
+
   dynamic_array<int> coarse_local_pins;
   dynamic_array<int> coarse_hedge_offsets;
   dynamic_array<int> coarse_hedge_weights;
@@ -2486,36 +2505,86 @@ void hypergraph::process_new_hyperedges(hypergraph &coarse,
   int number_coarse_hedges = 0;
   coarse_hedge_offsets[number_coarse_hedges] = number_coarse_pins;
 
-  int i = 0;
-  while (i < total_to_receive) {
-    int coarse_hyperedge_length = receive_array_[i] - 2;
-    HashKey hash_key = Funct::computeHash(&receive_array_[i + 2], coarse_hyperedge_length);
-    // See if a duplicate hyperedge exists
-    int number_seen = -1;
-    int duplicated_hyperedge = -1;
-    do {
-      int try_hyperedge = table.getHedgeIndex(hash_key, number_seen);
-      if (try_hyperedge >= 0) {
-        int start_offset = coarse_hedge_offsets[try_hyperedge];
-        int end_offset = coarse_hedge_offsets[try_hyperedge + 1];
-        int length = end_offset - start_offset;
-        if (length == coarse_hyperedge_length) {
-          int j = 0;
-          for (j = 0; j < length; ++j) {
-            if (receive_array_[i + 2 + j] != coarse_local_pins[start_offset + j]) {
-              break;
-            }
-          }
-          if (j == length) {
-            duplicated_hyperedge = try_hyperedge;
+  // Each received hyperedge is its length + 2, its weight and its pins.
+  dynamic_array<int> received;
+  int number_received = 0;
+  for (int i = 0; i < total_to_receive; i += receive_array_[i]) {
+    received[number_received++] = i;
+  }
+
+  // Sort the received hyperedges by hash key, keeping those with equal keys
+  // in the order they were received.
+  std::vector<keyed_hyperedge> keys(number_received);
+  std::vector<keyed_hyperedge> scratch(number_received);
+  int tasks = (number_received + hyperedges_per_task - 1) / hyperedges_per_task;
+
+  for_each_task(pool, tasks, [&](int task, int) {
+    int end = std::min(number_received, (task + 1) * hyperedges_per_task);
+    for (int k = task * hyperedges_per_task; k < end; ++k) {
+      int i = received[k];
+      keys[k] = keyed_hyperedge(
+          Funct::computeHash(&receive_array_[i + 2], receive_array_[i] - 2),
+          k);
+    }
+  });
+
+  utility::radix_sort(keys.data(), scratch.data(), number_received,
+                      [](const keyed_hyperedge &h) { return h.first; }, pool);
+
+  // Only hyperedges with equal keys can be duplicates. Each task resolves the
+  // runs of equal keys starting in its share of the sorted keys, pointing
+  // every hyperedge at the first received copy of its pins.
+  dynamic_array<int> first_copy(number_received);
+
+  for_each_task(pool, tasks, [&](int task, int) {
+    int end = std::min(number_received, (task + 1) * hyperedges_per_task);
+    int run = task * hyperedges_per_task;
+    std::vector<int> copies;
+
+    while (run > 0 && run < end && keys[run].first == keys[run - 1].first) {
+      ++run;
+    }
+
+    while (run < end) {
+      int run_end = run + 1;
+      while (run_end < number_received &&
+             keys[run_end].first == keys[run].first) {
+        ++run_end;
+      }
+
+      copies.clear();
+      for (int r = run; r < run_end; ++r) {
+        int k = keys[r].second;
+        const int *pins = &receive_array_[received[k]];
+
+        first_copy[k] = k;
+        for (int c : copies) {
+          const int *copy = &receive_array_[received[c]];
+          if (copy[0] == pins[0] &&
+              std::equal(pins + 2, pins + pins[0], copy + 2)) {
+            first_copy[k] = c;
             break;
           }
         }
+
+        if (first_copy[k] == k) {
+          copies.push_back(k);
+        }
       }
-    } while (number_seen >= 0);
+      run = run_end;
+    }
+  });
+
+  // Keep the first copy of each hyperedge, in the order received, and add the
+  // weights of the others to it.
+  dynamic_array<int> coarse_index(number_received);
+
+  for (int k = 0; k < number_received; ++k) {
+    int i = received[k];
+    int coarse_hyperedge_length = receive_array_[i] - 2;
 
-    if (duplicated_hyperedge == -1) {
-      table.insertKey(hash_key, number_coarse_hedges);
+    if (first_copy[k] == k) {
+      coarse_index[k] = number_coarse_hedges;
       coarse_hedge_weights[number_coarse_hedges++] = receive_array_[i + 1];
 
       for (int j = 0; j < coarse_hyperedge_length; ++j) {
@@ -2525,9 +2594,8 @@ void hypergraph::process_new_hyperedges(hypergraph &coarse,
       number_coarse_pins += coarse_hyperedge_length;
       coarse_hedge_offsets[number_coarse_hedges] = number_coarse_pins;
     } else {
-      coarse_hedge_weights[duplicated_hyperedge] += receive_array_[i + 1];
+      coarse_hedge_weights[coarse_index[first_copy[k]]] += receive_array_[i + 1];
     }
-    i += receive_array_[i];
   }
 
   // now set the coarse hypergraph
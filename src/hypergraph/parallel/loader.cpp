@@ -10,6 +10,7 @@
 
 #include "hypergraph/parallel/loader.hpp"
 #include "utility/logging.hpp"
+#include <climits>
 
 namespace parkway {
 namespace parallel {
@@ -25,7 +26,8 @@ loader::loader(int rank, int number_of_processors, int number_of_parts)
       maximum_vertex_index_(0),
       local_vertex_weight_(0),
       number_of_allocated_hyperedges_(0),
-      percentile_(100) {
+      percentile_(100),
+      communication_budget_(0) {
 }
 
 loader::~loader() {
@@ -93,5 +95,79 @@ void loader::compute_hyperedges_to_load(ds::bit_field &to_load,
   }
 }
 
+const int loader::exact_length_bits;
+const int loader::length_bin_bits;
+const int loader::number_of_length_bins;
+
+int loader::length_bin(int length) {
+  if (length < (1 << exact_length_bits)) {
+    return length;
+  }
+
+  int top_bit = 31 - __builtin_clz(length);
+  int shift = top_bit - length_bin_bits;
+  int mantissa = (length >> shift) & ((1 << length_bin_bits) - 1);
+  return (1 << exact_length_bits) +
+         ((top_bit - exact_length_bits) << length_bin_bits) + mantissa;
+}
+
+int loader::maximum_length_in_bin(int bin) {
+  if (bin < (1 << exact_length_bits)) {
+    return bin;
+  }
+
+  bin -= 1 << exact_length_bits;
+  int top_bit = (bin >> length_bin_bits) + exact_length_bits;
+  int shift = top_bit - length_bin_bits;
+  long next = static_cast<long>((1 << length_bin_bits) +
+                                (bin & ((1 << length_bin_bits) - 1)) + 1)
+              << shift;
+  return static_cast<int>(std::min<long>(next - 1, INT_MAX));
+}
+
+void loader::select_within_budget(ds::bit_field &to_load,
+                                  int number_of_hyperedges,
+                                  dynamic_array<int> &hyperedge_offsets,
+                                  ds::buffer<long> &volumes, MPI_Comm comm) {
+  ds::buffer<long> histogram(number_of_length_bins, 0);
+  ds::buffer<long> total_histogram(number_of_length_bins);
+
+  for (int i = 0; i < number_of_hyperedges; ++i) {
+    int length = hyperedge_offsets[i + 1] - hyperedge_offsets[i];
+    histogram[length_bin(length)] += volumes[i];
+  }
+
+  MPI_Allreduce(histogram.data(), total_histogram.data(),
+                number_of_length_bins, MPI_LONG, MPI_SUM, comm);
+
+  // The last bin that keeps the total within the budget, but at least the
+  // first bin sending anything.
+  long total_volume = 0;
+  long volume = 0;
+  int cutoff_bin = -1;
+
+  for (int bin = 0; bin < number_of_length_bins; ++bin) {
+    total_volume += total_histogram[bin];
+    if (total_volume <= communication_budget_ ||
+        (cutoff_bin < 0 && total_histogram[bin] > 0)) {
+      cutoff_bin = bin;
+      volume = total_volume;
+    }
+  }
+
+  int cutoff_length =
+      cutoff_bin < 0 ? INT_MAX : maximum_length_in_bin(cutoff_bin);
+
+  progress(" %ld/%ld %i ", volume, communication_budget_, cutoff_length);
+
+  to_load.set();
+  for (int i = 0; i < number_of_hyperedges; ++i) {
+    int length = hyperedge_offsets[i + 1] - hyperedge_offsets[i];
+    if (volumes[i] > 0 && length > cutoff_length) {
+      to_load.unset(i);
+    }
+  }
+}
+
 }  // namespace parallel
 }  // namespace parkway
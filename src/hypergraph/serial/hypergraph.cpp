@@ -17,12 +17,19 @@ namespace parkway {
 namespace serial {
 
 hypergraph::hypergraph(dynamic_array<int> vWts, int numVerts)
-    : parkway::base::hypergraph(numVerts) {
+    : parkway::base::hypergraph(numVerts), shared_(false) {
 
   match_vector_.assign(number_of_vertices_, -1);
   vertex_weights_ = vWts;
 }
 
+hypergraph::hypergraph(const shared_structure &structure, int numVerts)
+    : parkway::base::hypergraph(numVerts), shared_(true),
+      structure_(structure) {
+
+  match_vector_.assign(number_of_vertices_, -1);
+}
+
 hypergraph::hypergraph(dynamic_array<int> vWts, dynamic_array<int> p_vector,
                        int numVerts, int cut)
     : hypergraph(vWts, numVerts) {
@@ -39,6 +46,22 @@ hypergraph::hypergraph(dynamic_array<int> vWts, dynamic_array<int> p_vector,
 
 hypergraph::~hypergraph() {}
 
+hypergraph *hypergraph::shallow_copy() const {
+  hypergraph *h = shared_ ? new hypergraph(structure_, number_of_vertices_)
+                          : new hypergraph(vertex_weights_, number_of_vertices_);
+
+  h->number_of_hyperedges_ = number_of_hyperedges_;
+  h->number_of_pins_ = number_of_pins_;
+  h->total_weight_ = total_weight_;
+  h->hyperedge_weights_ = hyperedge_weights_;
+  h->hyperedge_offsets_ = hyperedge_offsets_;
+  h->pin_list_ = pin_list_;
+  h->vertex_to_hyperedges_ = vertex_to_hyperedges_;
+  h->vertex_offsets_ = vertex_offsets_;
+
+  return h;
+}
+
 void hypergraph::buildVtoHedges() {
 #ifdef DEBUG_HYPERGRAPH
   assert(numVertices >= 0);
@@ -49,8 +72,17 @@ void hypergraph::buildVtoHedges() {
 #endif
 
   ds::dynamic_array<int> vDegs(number_of_vertices_);
-  vertex_to_hyperedges_.resize(number_of_pins_);
-  vertex_offsets_.resize(number_of_vertices_ + 1);
+  ds::span<const int> pins = pin_list_view();
+  ds::span<const int> hEdgeOffsets = hyperedge_offset_view();
+  ds::span<int> vToHedges = structure_.vertex_to_hyperedges;
+  ds::span<int> vOffsets = structure_.vertex_offsets;
+
+  if (!shared_) {
+    vertex_to_hyperedges_.resize(number_of_pins_);
+    vertex_offsets_.resize(number_of_vertices_ + 1);
+    vToHedges = vertex_to_hyperedges_.view();
+    vOffsets = vertex_offsets_.view();
+  }
 
   for (int i = 0; i < number_of_vertices_; ++i) {
     vDegs[i] = 0;
@@ -60,23 +92,23 @@ void hypergraph::buildVtoHedges() {
 #ifdef DEBUG_HYPERGRAPH
     assert(pinList[i] >= 0 && pinList[i] < numVertices);
 #endif
-    ++vDegs[pin_list_[i]];
+    ++vDegs[pins[i]];
   }
 
   int i;
   int j = 0;
   for (i = 0; i < number_of_vertices_; ++i) {
-    vertex_offsets_[i] = j;
+    vOffsets[i] = j;
     j += vDegs[i];
     vDegs[i] = 0;
   }
-  vertex_offsets_[i] = j;
+  vOffsets[i] = j;
 
   for (i = 0; i < number_of_hyperedges_; ++i) {
-    int endOffset = hyperedge_offsets_[i + 1];
-    for (j = hyperedge_offsets_[i]; j < endOffset; ++j) {
-      int ij = pin_list_[j];
-      vertex_to_hyperedges_[vertex_offsets_[ij] + (vDegs[ij]++)] = i;
+    int endOffset = hEdgeOffsets[i + 1];
+    for (j = hEdgeOffsets[i]; j < endOffset; ++j) {
+      int ij = pins[j];
+      vToHedges[vOffsets[ij] + (vDegs[ij]++)] = i;
     }
   }
 }
@@ -215,6 +247,9 @@ void hypergraph::copy_in_partition(dynamic_array<int> p_vector, int nV,
 }
 
 void hypergraph::print_characteristics() {
+  ds::span<const int> hEdgeOffsets = hyperedge_offset_view();
+  ds::span<const int> hEdgeWeights = hyperedge_weight_view();
+  ds::span<const int> vWeights = vertex_weight_view();
   info(" |cGraph| %i %i %i : ", number_of_vertices_, number_of_hyperedges_,
        number_of_pins_);
 
@@ -231,9 +266,9 @@ void hypergraph::print_characteristics() {
   int j = 0;
   for (int i = 0; i < number_of_hyperedges_; ++i) {
     hEdges[i] = i;
-    hEdgeLens[i] = hyperedge_offsets_[i + 1] - hyperedge_offsets_[i];
-    weighted_ave += (hEdgeLens[i] * hyperedge_weights_[i]);
-    j += hyperedge_weights_[i];
+    hEdgeLens[i] = hEdgeOffsets[i + 1] - hEdgeOffsets[i];
+    weighted_ave += (hEdgeLens[i] * hEdgeWeights[i]);
+    j += hEdgeWeights[i];
   }
 
   percentile_75 = (static_cast<double>(j) * 75) / 100;
@@ -248,7 +283,7 @@ void hypergraph::print_characteristics() {
   j = 0;
   int ij = 0;
   for (int i = 0; i < number_of_hyperedges_;) {
-    j += hyperedge_weights_[hEdges[i++]];
+    j += hEdgeWeights[hEdges[i++]];
 
     if (ij == 0 && j > percentile_25) {
       info("%i ", hEdgeLens[hEdges[i]]);
@@ -278,7 +313,7 @@ void hypergraph::print_characteristics() {
   j = 0;
   for (int i = 0; i < number_of_vertices_; ++i) {
     vertices[i] = i;
-    j += vertex_weights_[i];
+    j += vWeights[i];
   }
 
   percentile_75 = (static_cast<double>(j) * 75) / 100;
@@ -286,35 +321,37 @@ void hypergraph::print_characteristics() {
   percentile_95 = (static_cast<double>(j) * 95) / 100;
   percentile_25 = (static_cast<double>(j) * 25) / 100;
 
-  vertices.sort_using_another_array(vertex_weights_);
+  parkway::utility::quick_sort_by_another_array(
+      0, number_of_vertices_ - 1, vertices.data(), vWeights.data(),
+      parkway::utility::sort_order::INCREASING);
 
   j = 0;
   ij = 0;
   for (int i = 0; i < number_of_vertices_;) {
-    j += vertex_weights_[vertices[i++]];
+    j += vWeights[vertices[i++]];
 
     if (ij == 0 && j > percentile_25) {
-      info("%i ", vertex_weights_[vertices[i]]);
+      info("%i ", vWeights[vertices[i]]);
       ++ij;
     }
 
     if (ij == 1 && j > percentile_50) {
-      info("%i ", vertex_weights_[vertices[i]]);
+      info("%i ", vWeights[vertices[i]]);
       ++ij;
     }
 
     if (ij == 2 && j > percentile_75) {
-      info("%i ", vertex_weights_[vertices[i]]);
+      info("%i ", vWeights[vertices[i]]);
       ++ij;
     }
 
     if (ij == 3 && j > percentile_95) {
-      info("%i ", vertex_weights_[vertices[i]]);
+      info("%i ", vWeights[vertices[i]]);
       ++ij;
     }
 
     if (i == number_of_vertices_ - 1) {
-      info("%i \n", vertex_weights_[vertices[i]]);
+      info("%i \n", vWeights[vertices[i]]);
     }
   }
 }
@@ -344,29 +381,33 @@ int hypergraph::keep_best_partition() {
 }
 
 int hypergraph::export_hyperedge_weight() const {
+  ds::span<const int> hEdgeWeights = hyperedge_weight_view();
   int ij = 0;
   for (int i = 0; i < number_of_hyperedges_; ++i) {
-    ij += hyperedge_weights_[i];
+    ij += hEdgeWeights[i];
   }
 
   return ij;
 }
 
 int hypergraph::cut_size(int nP, int partitionNo) const {
+  ds::span<const int> hEdgeWeights = hyperedge_weight_view();
+  ds::span<const int> hEdgeOffsets = hyperedge_offset_view();
+  ds::span<const int> pins = pin_list_view();
   int offset = partition_vector_offsets_[partitionNo];
   ds::dynamic_array<int> spanned(nP);
   int k_1_cut = 0;
 
   for (int i = 0; i < number_of_hyperedges_; ++i) {
-    int endOffset = hyperedge_offsets_[i + 1];
+    int endOffset = hEdgeOffsets[i + 1];
     int number_spanned = 0;
 
     for (int j = 0; j < nP; ++j) {
       spanned[j] = 0;
     }
 
-    for (int j = hyperedge_offsets_[i]; j < endOffset; ++j) {
-      int vertex_part = partition_vector_[offset + pin_list_[j]];
+    for (int j = hEdgeOffsets[i]; j < endOffset; ++j) {
+      int vertex_part = partition_vector_[offset + pins[j]];
 #ifdef DEBUG_HYPERGRAPH
       assert(vertex_part >= 0 && vertex_part < nP);
 #endif
@@ -376,13 +417,16 @@ int hypergraph::cut_size(int nP, int partitionNo) const {
       }
     }
 
-    k_1_cut += ((number_spanned - 1) * hyperedge_weights_[i]);
+    k_1_cut += ((number_spanned - 1) * hEdgeWeights[i]);
   }
 
   return k_1_cut;
 }
 
 int hypergraph::sum_of_external_degrees(int nP, int partitionNo) const {
+  ds::span<const int> hEdgeWeights = hyperedge_weight_view();
+  ds::span<const int> hEdgeOffsets = hyperedge_offset_view();
+  ds::span<const int> pins = pin_list_view();
   int offset = partition_vector_offsets_[partitionNo];
 
   ds::dynamic_array<int> spanned(nP);
@@ -390,15 +434,15 @@ int hypergraph::sum_of_external_degrees(int nP, int partitionNo) const {
   int soed = 0;
 
   for (int i = 0; i < number_of_hyperedges_; ++i) {
-    int endOffset = hyperedge_offsets_[i + 1];
+    int endOffset = hEdgeOffsets[i + 1];
     int number_spanned = 0;
 
     for (int j = 0; j < nP; ++j) {
       spanned[j] = 0;
     }
 
-    for (int j = hyperedge_offsets_[i]; j < endOffset; ++j) {
-      int vertex_part = partition_vector_[offset + pin_list_[j]];
+    for (int j = hEdgeOffsets[i]; j < endOffset; ++j) {
+      int vertex_part = partition_vector_[offset + pins[j]];
 #ifdef DEBUG_HYPERGRAPH
       assert(vertex_part >= 0 && vertex_part < nP);
 #endif
@@ -409,7 +453,7 @@ int hypergraph::sum_of_external_degrees(int nP, int partitionNo) const {
     }
 
     if (number_spanned > 1) {
-      soed += (number_spanned * hyperedge_weights_[i]);
+      soed += (number_spanned * hEdgeWeights[i]);
     }
   }
 
@@ -430,6 +474,7 @@ void hypergraph::initialize_cut_sizes(int numParts) {
 }
 
 void hypergraph::check_partitions(int nP, int maxWt) const {
+  ds::span<const int> vWeights = vertex_weight_view();
   ds::dynamic_array<int> partWts(nP);
   for (int i = 0; i < number_of_partitions_; ++i) {
     int cut = cut_size(nP, i);
@@ -442,7 +487,7 @@ void hypergraph::check_partitions(int nP, int maxWt) const {
     int offset = partition_vector_offsets_[i];
 
     for (int j = 0; j < number_of_vertices_; ++j) {
-      partWts[partition_vector_[offset + j]] += vertex_weights_[j];
+      partWts[partition_vector_[offset + j]] += vWeights[j];
     }
 
     check_part_weights_are_less_than(partWts, nP, maxWt);
@@ -450,6 +495,7 @@ void hypergraph::check_partitions(int nP, int maxWt) const {
 }
 
 void hypergraph::check_partition(int numPartition, int nP, int maxWt) const {
+  ds::span<const int> vWeights = vertex_weight_view();
   ds::dynamic_array<int> partWts(nP);
 
   int cut = cut_size(nP, numPartition);
@@ -461,7 +507,7 @@ void hypergraph::check_partition(int numPartition, int nP, int maxWt) const {
   int offset = partition_vector_offsets_[numPartition];
 
   for (int i = 0; i < number_of_vertices_; ++i)
-    partWts[partition_vector_[offset + i]] += vertex_weights_[i];
+    partWts[partition_vector_[offset + i]] += vWeights[i];
 
   check_part_weights_are_less_than(partWts, nP, maxWt);
 }
@@ -570,6 +616,9 @@ void hypergraph::convert_to_DOMACS_graph_file(const char *fN) {
 }
 
 void hypergraph::print_percentiles() {
+  ds::span<const int> hEdgeOffsets = hyperedge_offset_view();
+  ds::span<const int> hEdgeWeights = hyperedge_weight_view();
+  ds::span<const int> vWeights = vertex_weight_view();
   int i;
   int j;
   int ij;
@@ -593,9 +642,9 @@ void hypergraph::print_percentiles() {
 
   for (i = 0; i < number_of_hyperedges_; ++i) {
     indices[i] = i;
-    j += hyperedge_weights_[i];
-    hEdgeLens[i] = hyperedge_offsets_[i + 1] - hyperedge_offsets_[i];
-    weighted_ave += (hEdgeLens[i] * hyperedge_weights_[i]);
+    j += hEdgeWeights[i];
+    hEdgeLens[i] = hEdgeOffsets[i + 1] - hEdgeOffsets[i];
+    weighted_ave += (hEdgeLens[i] * hEdgeWeights[i]);
   }
 
   percentile_95 = (static_cast<double>(j) * 95) / 100;
@@ -614,7 +663,7 @@ void hypergraph::print_percentiles() {
   ij = 0;
 
   for (; i < number_of_hyperedges_;) {
-    j += hyperedge_weights_[indices[i++]];
+    j += hEdgeWeights[indices[i++]];
 
     if (ij == 0 && j > percentile_25) {
       info("%i ", hEdgeLens[indices[i]]);
@@ -648,7 +697,7 @@ void hypergraph::print_percentiles() {
 
   for (i = 0; i < number_of_vertices_; ++i) {
     indices[i] = i;
-    j += vertex_weights_[i];
+    j += vWeights[i];
   }
 
   percentile_95 = (static_cast<double>(j) * 95) / 100;
@@ -656,7 +705,9 @@ void hypergraph::print_percentiles() {
   percentile_50 = (static_cast<double>(j) * 50) / 100;
   percentile_25 = (static_cast<double>(j) * 25) / 100;
 
-  indices.sort_using_another_array(vertex_weights_);
+  parkway::utility::quick_sort_by_another_array(
+      0, number_of_vertices_ - 1, indices.data(), vWeights.data(),
+      parkway::utility::sort_order::INCREASING);
 
   info("vertex weight percentiles: (ave, 25, 50, 75, 95, maxWeight)\n");
   info("\t%.2f ", static_cast<double>(j) / number_of_vertices_);
@@ -666,30 +717,30 @@ void hypergraph::print_percentiles() {
   ij = 0;
 
   for (; i < number_of_vertices_;) {
-    j += vertex_weights_[indices[i++]];
+    j += vWeights[indices[i++]];
 
     if (ij == 0 && j > percentile_25) {
-      info("%i ", vertex_weights_[indices[i]]);
+      info("%i ", vWeights[indices[i]]);
       ++ij;
     }
 
     if (ij == 1 && j > percentile_50) {
-      info("%i ", vertex_weights_[indices[i]]);
+      info("%i ", vWeights[indices[i]]);
       ++ij;
     }
 
     if (ij == 2 && j > percentile_75) {
-      info("%i ", vertex_weights_[indices[i]]);
+      info("%i ", vWeights[indices[i]]);
       ++ij;
     }
 
     if (ij == 3 && j > percentile_95) {
-      info("%i ", vertex_weights_[indices[i]]);
+      info("%i ", vWeights[indices[i]]);
       ++ij;
     }
 
     if (i == number_of_vertices_ - 1) {
-      info("%i \n", vertex_weights_[indices[i]]);
+      info("%i \n", vWeights[indices[i]]);
     }
   }
 }
@@ -11,6 +11,24 @@
 
 namespace parkway {
 
+namespace {
+// All exchange messages share a tag; MPI's non-overtaking guarantee keeps the
+// messages of successive exchanges between two processors in order.
+const int exchange_tag = 17;
+
+// Sparse count exchanges alternate between two tags, as a processor can be at
+// most one count exchange ahead of another (see receive_sparse_counts()).
+const int count_tag = 18;
+
+int free_sparse_exchanges(MPI_Comm, int, void *count, void *) {
+  delete static_cast<int *>(count);
+  return MPI_SUCCESS;
+}
+}
+
+bool global_communicator::sparse_exchange_ = false;
+int global_communicator::sparse_exchanges_key_ = MPI_KEYVAL_INVALID;
+
 global_communicator::global_communicator(const int rank, const int processors)
     : rank_(rank),
       processors_(processors),
@@ -18,7 +36,12 @@ global_communicator::global_communicator(const int rank, const int processors)
       send_lens_(processors_),
       receive_lens_(processors_),
       send_displs_(processors_),
-      receive_displs_(processors_) {
+      receive_displs_(processors_),
+      requests_(2 * processors_),
+      count_request_(MPI_REQUEST_NULL),
+      count_comm_(MPI_COMM_NULL),
+      count_tag_(count_tag),
+      number_of_requests_(0) {
   for (auto &item : data_out_sets_) {
     item.resize(1024);
   }
@@ -33,42 +56,170 @@ void global_communicator::free_memory() {
   }
   send_array_.clear_and_shrink();
   receive_array_.clear_and_shrink();
+  reply_array_.clear_and_shrink();
 }
 
-void global_communicator::send_from_data_out(MPI_Comm comm) {
+int global_communicator::send_from_data_out(MPI_Comm comm) {
+  start_count_exchange(comm);
+
   int capacity = 0;
   for (int i = 0; i < processors_; ++i) {
     send_displs_[i] = capacity;
     capacity += send_lens_[i];
   }
-  send_array_.resize(capacity);
 
-  int ij = 0;
-  for (int i = 0; i < processors_; ++i) {
-    for (int j = 0; j < send_lens_[i]; ++j) {
-      send_array_[ij++] = data_out_sets_[i][j];
+  int total_to_receive = finish_count_exchange();
+
+  // The blocks are sent straight out of data_out_sets_.
+  for (int i = 1; i < processors_; ++i) {
+    int p = (rank_ + i) % processors_;
+    receive_block(p, receive_array_.data() + receive_displs_[p],
+                  receive_lens_[p], comm);
+  }
+  for (int i = 1; i < processors_; ++i) {
+    int p = (rank_ + i) % processors_;
+    send_block(p, data_out_sets_[p].data(), send_lens_[p], comm);
+  }
+  std::copy(data_out_sets_[rank_].data(),
+            data_out_sets_[rank_].data() + send_lens_[rank_],
+            receive_array_.data() + receive_displs_[rank_]);
+
+  wait_for_exchange();
+  return total_to_receive;
+}
+
+void global_communicator::start_count_exchange(MPI_Comm comm) {
+  if (!sparse_exchange_) {
+    MPI_Ialltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1,
+                  MPI_INT, comm, &count_request_);
+    return;
+  }
+
+  // Only the non-zero counts are sent. The sends are synchronous, so their
+  // completion means that they have been received.
+  count_tag_ = count_tag + (next_sparse_exchange(comm) & 1);
+  for (int i = 1; i < processors_; ++i) {
+    int p = (rank_ + i) % processors_;
+    if (send_lens_[p] > 0) {
+      MPI_Issend(send_lens_.data() + p, 1, MPI_INT, p, count_tag_, comm,
+                 &requests_[number_of_requests_++]);
     }
   }
+  count_comm_ = comm;
+}
 
-  // Send data from all to all processes.
-  // Send 1 int from send_lens_,
-  // Receive 1 into into receive_lens_
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT,
-               receive_lens_.data(), 1, MPI_INT,
-               comm);
+int global_communicator::finish_count_exchange() {
+  if (sparse_exchange_) {
+    receive_sparse_counts();
+  } else {
+    MPI_Wait(&count_request_, MPI_STATUS_IGNORE);
+  }
 
-  capacity = 0;
+  int capacity = 0;
   for (int i = 0; i < processors_; ++i) {
     receive_displs_[i] = capacity;
     capacity += receive_lens_[i];
   }
 
   receive_array_.resize(capacity);
+  return capacity;
+}
+
+void global_communicator::receive_sparse_counts() {
+  // Non-blocking consensus: receive counts until every processor has had all
+  // of its counts received, which is the case once all processors have
+  // entered the barrier. A processor leaving the barrier may start its next
+  // count exchange while others are still probing, hence the alternating tag.
+  int tag = count_tag_;
+
+  for (int i = 0; i < processors_; ++i) {
+    receive_lens_[i] = 0;
+  }
+  receive_lens_[rank_] = send_lens_[rank_];
+
+  MPI_Request barrier = MPI_REQUEST_NULL;
+  bool in_barrier = false;
+  int done = 0;
+  while (!done) {
+    int arrived;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, tag, count_comm_, &arrived, &status);
+    if (arrived) {
+      MPI_Recv(receive_lens_.data() + status.MPI_SOURCE, 1, MPI_INT,
+               status.MPI_SOURCE, tag, count_comm_, MPI_STATUS_IGNORE);
+    }
+
+    if (in_barrier) {
+      MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+    } else {
+      int sent;
+      MPI_Testall(number_of_requests_, requests_.data(), &sent,
+                  MPI_STATUSES_IGNORE);
+      if (sent) {
+        number_of_requests_ = 0;
+        MPI_Ibarrier(count_comm_, &barrier);
+        in_barrier = true;
+      }
+    }
+  }
+}
+
+int global_communicator::next_sparse_exchange(MPI_Comm comm) {
+  // The parity must agree between all processors, and so is counted per
+  // communicator rather than per instance or per process.
+  if (sparse_exchanges_key_ == MPI_KEYVAL_INVALID) {
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, free_sparse_exchanges,
+                           &sparse_exchanges_key_, nullptr);
+  }
+
+  void *value;
+  int found;
+  MPI_Comm_get_attr(comm, sparse_exchanges_key_, &value, &found);
+
+  int *count = static_cast<int *>(value);
+  if (!found) {
+    count = new int(0);
+    MPI_Comm_set_attr(comm, sparse_exchanges_key_, count);
+  }
+  return (*count)++;
+}
+
+void global_communicator::exchange(MPI_Comm comm) {
+  for (int i = 1; i < processors_; ++i) {
+    int p = (rank_ + i) % processors_;
+    receive_block(p, receive_array_.data() + receive_displs_[p],
+                  receive_lens_[p], comm);
+  }
+  for (int i = 1; i < processors_; ++i) {
+    int p = (rank_ + i) % processors_;
+    send_block(p, send_array_.data() + send_displs_[p], send_lens_[p], comm);
+  }
+  std::copy(send_array_.data() + send_displs_[rank_],
+            send_array_.data() + send_displs_[rank_] + send_lens_[rank_],
+            receive_array_.data() + receive_displs_[rank_]);
+
+  wait_for_exchange();
+}
+
+void global_communicator::receive_block(int processor, int *data, int length,
+                                        MPI_Comm comm) {
+  if (length > 0) {
+    MPI_Irecv(data, length, MPI_INT, processor, exchange_tag, comm,
+              &requests_[number_of_requests_++]);
+  }
+}
+
+void global_communicator::send_block(int processor, const int *data,
+                                     int length, MPI_Comm comm) {
+  if (length > 0) {
+    MPI_Isend(const_cast<int *>(data), length, MPI_INT, processor,
+              exchange_tag, comm, &requests_[number_of_requests_++]);
+  }
+}
 
-  MPI_Alltoallv(
-      send_array_.data(), send_lens_.data(), send_displs_.data(), MPI_INT,
-      receive_array_.data(), receive_lens_.data(), receive_displs_.data(),
-      MPI_INT, comm);
+void global_communicator::wait_for_exchange() {
+  MPI_Waitall(number_of_requests_, requests_.data(), MPI_STATUSES_IGNORE);
+  number_of_requests_ = 0;
 }
 
 }  // namespace parkway
@@ -8,6 +8,11 @@
 //
 // ###
 #include "internal/parallel_controller.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <vector>
 #include "utility/logging.hpp"
 
 namespace parkway {
@@ -215,30 +220,114 @@ void controller::store_best_partition(int numV, const dynamic_array<int> array,
 #endif
 }
 
-void controller::partition_to_file(const char *filename, MPI_Comm comm) const {
-  std::ofstream out;
-  if (rank_ == 0)
-    remove(filename);
+void controller::partition_to_file(const char *filename, bool text,
+                                   int gather_limit, MPI_Comm comm) const {
+  const char *data = reinterpret_cast<const char *>(best_partition_.data());
+  long long length = sizeof(int) * static_cast<long long>(
+                         number_of_orig_local_vertices_);
+
+  std::vector<char> formatted;
+  if (text) {
+    formatted.reserve(4 * number_of_orig_local_vertices_);
+    char digits[16];
+    for (int i = 0; i < number_of_orig_local_vertices_; ++i) {
+      int n = sprintf(digits, "%d\n", best_partition_[i]);
+      formatted.insert(formatted.end(), digits, digits + n);
+    }
+    data = formatted.data();
+    length = formatted.size();
+  }
+
+  // ###
+  // small partitions are cheaper to funnel through one
+  // processor than to open collectively on every one
+  // ###
 
-  MPI_Barrier(comm);
+  long long local[2] = {number_of_orig_local_vertices_, length};
+  long long total[2];
+  MPI_Allreduce(local, total, 2, MPI_LONG_LONG, MPI_SUM, comm);
+
+  if (total[0] <= gather_limit && total[1] <= INT_MAX) {
+    write_gathered(filename, data, static_cast<int>(length), comm);
+  } else {
+    write_collective(filename, data, length, total[1], comm);
+  }
+}
+
+void controller::write_gathered(const char *filename, const char *data,
+                                int length, MPI_Comm comm) const {
+  std::vector<int> lengths(rank_ == 0 ? processors_ : 0);
+  std::vector<int> displs(lengths.size());
+  std::vector<char> gathered;
+
+  MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, comm);
+
+  if (rank_ == 0) {
+    int offset = 0;
+    for (int i = 0; i < processors_; ++i) {
+      displs[i] = offset;
+      offset += lengths[i];
+    }
+    gathered.resize(offset);
+  }
 
-  for (int i = 0; i < processors_; ++i) {
-    if (rank_ == i) {
-      out.open(filename, std::ofstream::out | std::ofstream::app |
-               std::ofstream::binary);
+  MPI_Gatherv(data, length, MPI_CHAR, gathered.data(), lengths.data(),
+              displs.data(), MPI_CHAR, 0, comm);
 
-      if (!out.is_open()) {
-        error_on_processor("p[%d] cannot open %s\n", rank_, filename);
-      } else
-        out.write((char *)(best_partition_.data()),
-                  sizeof(int) * number_of_orig_local_vertices_);
+  if (rank_ == 0) {
+    std::ofstream out(filename, std::ofstream::out | std::ofstream::trunc |
+                      std::ofstream::binary);
 
-      out.close();
+    if (!out.is_open()) {
+      error_on_processor("p[%d] cannot open %s\n", rank_, filename);
+    } else {
+      out.write(gathered.data(), gathered.size());
     }
-    MPI_Barrier(comm);
   }
 }
 
+void controller::write_collective(const char *filename, const char *data,
+                                  long long length, long long total,
+                                  MPI_Comm comm) const {
+  // MPI-IO counts are ints, so very long partitions are written in rounds of
+  // at most max_chunk bytes; every processor takes part in every round.
+  const long long max_chunk = 1LL << 30;
+
+  long long offset = 0;
+  MPI_Exscan(&length, &offset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+  if (rank_ == 0) {
+    offset = 0;
+  }
+
+  MPI_File file;
+  int status = MPI_File_open(comm, const_cast<char *>(filename),
+                             MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                             &file);
+
+  if (status != MPI_SUCCESS) {
+    error_on_processor("p[%d] cannot open %s\n", rank_, filename);
+    return;
+  }
+
+  // Discard the tail of any longer file written previously.
+  MPI_File_set_size(file, total);
+
+  long long rounds = (length + max_chunk - 1) / max_chunk;
+  long long max_rounds;
+  MPI_Allreduce(&rounds, &max_rounds, 1, MPI_LONG_LONG, MPI_MAX, comm);
+
+  for (long long r = 0; r < max_rounds; ++r) {
+    long long start = std::min(r * max_chunk, length);
+    int count = static_cast<int>(std::min(max_chunk, length - start));
+
+    MPI_File_write_at_all(file, offset + start,
+                          const_cast<char *>(data) + start, count, MPI_CHAR,
+                          MPI_STATUS_IGNORE);
+  }
+
+  MPI_File_close(&file);
+}
+
 void controller::copy_out_partition(int numVertices, int *pVector) const {
   for (int i = 0; i < numVertices; ++i)
     pVector[i] = best_partition_[i];
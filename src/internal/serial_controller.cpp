@@ -7,6 +7,7 @@
 // 30/11/2004: Last Modified
 //
 // ###
+#include <algorithm>
 #include "internal/serial_controller.hpp"
 #include "utility/logging.hpp"
 
@@ -25,22 +26,225 @@ controller::controller(int rank, int nProcs, int nParts) {
 
   hypergraph_ = nullptr;
 
+  replicas_ = 0;
+  shared_replica_ = false;
+  group_rank_ = 0;
+  replica_rank_ = rank;
+  number_of_replicas_ = nProcs;
+  group_comm_ = MPI_COMM_NULL;
+  leader_comm_ = MPI_COMM_NULL;
+  replica_comm_ = MPI_COMM_NULL;
+  window_ = MPI_WIN_NULL;
+
   partition_vector_.resize(0);
   partition_vector_cuts_.resize(0);
   partition_vector_offsets_.resize(0);
 }
 
 controller::~controller() {
+  int finalized;
+  MPI_Finalized(&finalized);
+
+  if (finalized)
+    return;
+
+  free_shared_replica();
+
+  if (group_comm_ != MPI_COMM_NULL && group_comm_ != MPI_COMM_SELF) {
+    MPI_Comm_free(&group_comm_);
+    if (leader_comm_ != MPI_COMM_NULL)
+      MPI_Comm_free(&leader_comm_);
+  }
+}
+
+void controller::setup_replicas(MPI_Comm comm) {
+  if (group_comm_ != MPI_COMM_NULL)
+    return;
+
+  if (!shared_replica_ &&
+      (replicas_ == 0 || replicas_ >= number_of_processors_)) {
+    // ###
+    // every processor holds a replica
+    // ###
+
+    group_comm_ = MPI_COMM_SELF;
+    leader_comm_ = comm;
+    replica_comm_ = comm;
+    group_rank_ = 0;
+    replica_rank_ = rank_;
+    number_of_replicas_ = number_of_processors_;
+    return;
+  }
+
+  // ###
+  // split the processors into groups, either one per
+  // shared memory node or blocks of consecutive ranks,
+  // the first processor of each group is its leader
+  // ###
+
+  if (shared_replica_ || replicas_ < 0) {
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank_, MPI_INFO_NULL,
+                        &group_comm_);
+  } else {
+    int groupSize = (number_of_processors_ + replicas_ - 1) / replicas_;
+    MPI_Comm_split(comm, rank_ / groupSize, rank_, &group_comm_);
+  }
+
+  int groupSize;
+
+  MPI_Comm_rank(group_comm_, &group_rank_);
+  MPI_Comm_size(group_comm_, &groupSize);
+  MPI_Comm_split(comm, is_leader() ? 0 : MPI_UNDEFINED, rank_,
+                 &leader_comm_);
+
+  dynamic_array<int> members(groupSize);
+  MPI_Gather(&rank_, 1, MPI_INT, members.data(), 1, MPI_INT, 0, group_comm_);
+
+  if (shared_replica_) {
+    replica_comm_ = comm;
+    replica_rank_ = rank_;
+    number_of_replicas_ = number_of_processors_;
+  } else if (is_leader()) {
+    replica_comm_ = leader_comm_;
+    MPI_Comm_rank(replica_comm_, &replica_rank_);
+    MPI_Comm_size(replica_comm_, &number_of_replicas_);
+  } else {
+    replica_rank_ = -1;
+    number_of_replicas_ = 0;
+  }
+
+  if (!is_leader())
+    return;
+
+  int numLeaders;
+  MPI_Comm_size(leader_comm_, &numLeaders);
+
+  dynamic_array<int> groupSizes(numLeaders);
+  dynamic_array<int> groupDispls(numLeaders);
+
+  MPI_Allgather(&groupSize, 1, MPI_INT, groupSizes.data(), 1, MPI_INT,
+                leader_comm_);
+
+  int ij = 0;
+  for (int i = 0; i < numLeaders; ++i) {
+    groupDispls[i] = ij;
+    ij += groupSizes[i];
+  }
+
+  gather_order_.resize(number_of_processors_);
+  MPI_Allgatherv(members.data(), groupSize, MPI_INT, gather_order_.data(),
+                 groupSizes.data(), groupDispls.data(), MPI_INT,
+                 leader_comm_);
+}
+
+void controller::gather_onto_leaders(const int *local, int length, int *all,
+                                     MPI_Comm comm) const {
+  int i;
+  int ij;
+
+  dynamic_array<int> lengths(number_of_processors_);
+  dynamic_array<int> displs(number_of_processors_);
+
+  MPI_Allgather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, comm);
+
+  ij = 0;
+  for (i = 0; i < number_of_processors_; ++i) {
+    displs[i] = ij;
+    ij += lengths[i];
+  }
+
+  if (group_comm_ == MPI_COMM_SELF) {
+    MPI_Allgatherv(const_cast<int *>(local), length, MPI_INT, all,
+                   lengths.data(), displs.data(), MPI_INT, comm);
+    return;
+  }
+
+  // ###
+  // first gather each group onto its leader
+  // ###
+
+  int groupSize;
+  MPI_Comm_size(group_comm_, &groupSize);
+
+  dynamic_array<int> memberLens(groupSize);
+  dynamic_array<int> memberDispls(groupSize);
+  dynamic_array<int> block;
+
+  MPI_Gather(&length, 1, MPI_INT, memberLens.data(), 1, MPI_INT, 0,
+             group_comm_);
+
+  ij = 0;
+  if (is_leader()) {
+    for (i = 0; i < groupSize; ++i) {
+      memberDispls[i] = ij;
+      ij += memberLens[i];
+    }
+    block.resize(ij);
+  }
+
+  MPI_Gatherv(const_cast<int *>(local), length, MPI_INT, block.data(),
+              memberLens.data(), memberDispls.data(), MPI_INT, 0,
+              group_comm_);
+
+  if (!is_leader())
+    return;
+
+  // ###
+  // then exchange the groups between the leaders and
+  // put the data back into processor order
+  // ###
+
+  int numLeaders;
+  int blockLen = ij;
+
+  MPI_Comm_size(leader_comm_, &numLeaders);
+
+  dynamic_array<int> blockLens(numLeaders);
+  dynamic_array<int> blockDispls(numLeaders);
+  dynamic_array<int> gathered;
+
+  MPI_Allgather(&blockLen, 1, MPI_INT, blockLens.data(), 1, MPI_INT,
+                leader_comm_);
+
+  ij = 0;
+  for (i = 0; i < numLeaders; ++i) {
+    blockDispls[i] = ij;
+    ij += blockLens[i];
+  }
+
+  gathered.resize(ij);
+  MPI_Allgatherv(block.data(), blockLen, MPI_INT, gathered.data(),
+                 blockLens.data(), blockDispls.data(), MPI_INT,
+                 leader_comm_);
+
+  ij = 0;
+  for (i = 0; i < number_of_processors_; ++i) {
+    int proc = gather_order_[i];
+    std::copy(gathered.data() + ij, gathered.data() + ij + lengths[proc],
+              all + displs[proc]);
+    ij += lengths[proc];
+  }
+}
+
+void controller::free_shared_replica() {
+  if (window_ == MPI_WIN_NULL)
+    return;
+
+  // ###
+  // the hypergraph's arrays live in the window
+  // ###
+
+  delete hypergraph_;
+  hypergraph_ = nullptr;
+
+  MPI_Win_unlock_all(window_);
+  MPI_Win_free(&window_);
 }
 
 void controller::initialize_coarsest_hypergraph(parallel::hypergraph &hgraph,
                                                 MPI_Comm comm) {
   int i;
-  int j;
-  int ij;
 
-  int recvArrayLen;
-  int index;
   int numLocalVertices = hgraph.number_of_vertices();
   int numLocalHedges = hgraph.number_of_hyperedges();
   int numLocalPins = hgraph.number_of_pins();
@@ -60,99 +264,124 @@ void controller::initialize_coarsest_hypergraph(parallel::hypergraph &hgraph,
   dynamic_array<int> hEdgeWeights;
   dynamic_array<int> hEdgeOffsets;
   dynamic_array<int> pinList;
-  dynamic_array<int> recvDispls(number_of_processors_);
-  dynamic_array<int> recvLens(number_of_processors_);
-  dynamic_array<int> recvArray;
-
-  MPI_Allgather(&numLocalVertices, 1, MPI_INT, recvLens.data(), 1, MPI_INT,
-                comm);
+  dynamic_array<int> localHedgeLens(numLocalHedges);
 
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ij += recvLens[i];
-  }
+  // ###
+  // the arrays are gathered into either the dynamic
+  // arrays above or the shared replica's window
+  // ###
 
-#ifdef DEBUG_CONTROLLER
-  assert(numVertices == ij);
-#endif
+  serial::hypergraph::shared_structure structure;
 
-  vWeights.resize(numVertices);
+  free_shared_replica();
+  setup_replicas(comm);
 
   MPI_Allreduce(&localVertexWt, &totVertexWt, 1, MPI_INT, MPI_SUM, comm);
-  MPI_Allgatherv(localVertWeight.data(), numLocalVertices, MPI_INT,
-                 vWeights.data(), recvLens.data(),
-                 recvDispls.data(), MPI_INT, comm);
-  MPI_Allgather(&numLocalHedges, 1, MPI_INT, recvLens.data(), 1, MPI_INT,
-                comm);
+  MPI_Allreduce(&numLocalHedges, &numHedges, 1, MPI_INT, MPI_SUM, comm);
+  MPI_Allreduce(&numLocalPins, &numPins, 1, MPI_INT, MPI_SUM, comm);
 
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ij += recvLens[i];
+  // ###
+  // only the leaders store the coarsest hypergraph,
+  // a shared replica is stored in a window on the
+  // leader and viewed in place by the whole node
+  // ###
+
+  if (shared_replica_) {
+    long length[6] = {numVertices, numHedges, numHedges + 1L, numPins,
+                      numPins, numVertices + 1L};
+    long total = 0;
+    int *base;
+
+    for (i = 0; i < 6; ++i)
+      total += length[i];
+
+    MPI_Aint size = is_leader() ? total * sizeof(int) : 0;
+    int dispUnit;
+
+    MPI_Win_allocate_shared(size, sizeof(int), MPI_INFO_NULL, group_comm_,
+                            &base, &window_);
+    MPI_Win_shared_query(window_, 0, &size, &dispUnit, &base);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window_);
+
+    structure.vertex_weights = ds::span<int>(base, length[0]);
+    structure.hyperedge_weights = ds::span<int>(base += length[0], length[1]);
+    structure.hyperedge_offsets = ds::span<int>(base += length[1], length[2]);
+    structure.pin_list = ds::span<int>(base += length[2], length[3]);
+    structure.vertex_to_hyperedges =
+        ds::span<int>(base += length[3], length[4]);
+    structure.vertex_offsets = ds::span<int>(base += length[4], length[5]);
+  } else if (is_leader()) {
+    vWeights.resize(numVertices);
+    hEdgeWeights.resize(numHedges);
+    hEdgeOffsets.resize(numHedges + 1);
+    pinList.resize(numPins);
+
+    structure.vertex_weights = vWeights.view();
+    structure.hyperedge_weights = hEdgeWeights.view();
+    structure.hyperedge_offsets = hEdgeOffsets.view();
+    structure.pin_list = pinList.view();
   }
 
-  numHedges = ij;
-  hEdgeWeights.resize(numHedges);
+  ds::span<int> hEdgeOffsetView = structure.hyperedge_offsets;
 
-  MPI_Allgatherv(localHedgeWeights.data(), numLocalHedges, MPI_INT,
-                 hEdgeWeights.data(), recvLens.data(),
-                 recvDispls.data(), MPI_INT, comm);
+  gather_onto_leaders(localVertWeight.data(), numLocalVertices,
+                      structure.vertex_weights.data(), comm);
+  gather_onto_leaders(localHedgeWeights.data(), numLocalHedges,
+                      structure.hyperedge_weights.data(), comm);
 
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ++recvLens[i];
-    ij += recvLens[i];
-  }
-
-  recvArrayLen = ij;
-  recvArray.resize(recvArrayLen);
-  MPI_Allgatherv(localHedgeOffsets.data(), numLocalHedges + 1, MPI_INT,
-                 recvArray.data(), recvLens.data(),
-                 recvDispls.data(), MPI_INT, comm);
-  hEdgeOffsets.resize(numHedges + 1);
-
-  j = 1;
-  index = 0;
-  hEdgeOffsets[0] = 0;
-
-  for (i = 1; i < recvArrayLen; ++i) {
-    if (recvArray[i] != 0) {
-      ij = recvArray[i] - recvArray[i - 1];
-      hEdgeOffsets[j] = hEdgeOffsets[j - 1] + ij;
-      ++j;
-    } else {
-      recvLens[index++] = recvArray[i - 1];
-    }
-  }
+  // ###
+  // hyperedge lengths rather than offsets are gathered,
+  // the offsets are then their prefix sums
+  // ###
 
-#ifdef DEBUG_CONTROLLER
-  assert(index == numProcs - 1);
-#endif
+  for (i = 0; i < numLocalHedges; ++i)
+    localHedgeLens[i] = localHedgeOffsets[i + 1] - localHedgeOffsets[i];
 
-  recvLens[index] = recvArray[recvArrayLen - 1];
+  gather_onto_leaders(localHedgeLens.data(), numLocalHedges,
+                      hEdgeOffsetView.data() + 1, comm);
+  gather_onto_leaders(localPins.data(), numLocalPins,
+                      structure.pin_list.data(), comm);
 
-  ij = 0;
-  for (i = 0; i < number_of_processors_; ++i) {
-    recvDispls[i] = ij;
-    ij += recvLens[i];
+  if (!is_replica()) {
+    hypergraph_ = nullptr;
+    return;
   }
 
-  numPins = ij;
-  pinList.resize(numPins);
-  MPI_Allgatherv(localPins.data(), numLocalPins, MPI_INT, pinList.data(),
-                 recvLens.data(), recvDispls.data(), MPI_INT, comm);
+  if (is_leader()) {
+    hEdgeOffsetView[0] = 0;
+    for (i = 1; i <= numHedges; ++i)
+      hEdgeOffsetView[i] += hEdgeOffsetView[i - 1];
+  }
 
-  hypergraph_ = new serial::hypergraph(vWeights, numVertices);
+  if (shared_replica_) {
+    hypergraph_ = new serial::hypergraph(structure, numVertices);
+  } else {
+    hypergraph_ = new serial::hypergraph(vWeights, numVertices);
+    hypergraph_->set_hyperedge_weights(hEdgeWeights);
+    hypergraph_->set_hyperedge_offsets(hEdgeOffsets);
+    hypergraph_->set_pin_list(pinList);
+  }
 
   hypergraph_->set_number_of_hyperedges(numHedges);
   hypergraph_->set_number_of_pins(numPins);
   hypergraph_->set_total_weight(totVertexWt);
-  hypergraph_->set_hyperedge_weights(hEdgeWeights);
-  hypergraph_->set_hyperedge_offsets(hEdgeOffsets);
-  hypergraph_->set_pin_list(pinList);
-  hypergraph_->buildVtoHedges();
+
+  if (shared_replica_) {
+    if (is_leader())
+      hypergraph_->buildVtoHedges();
+
+    // ###
+    // make the leader's stores visible to the node,
+    // from here on the window is only read
+    // ###
+
+    MPI_Win_sync(window_);
+    MPI_Barrier(group_comm_);
+    MPI_Win_sync(window_);
+  } else {
+    hypergraph_->buildVtoHedges();
+  }
+
   hypergraph_->print_characteristics();
 }
 
@@ -165,7 +394,7 @@ void controller::initialize_serial_partitions(
   int keepMyPartition;
   int proc;
   int numKept;
-  int myBestCut = hypergraph_->cut(0);
+  int myBestCut = hypergraph_ ? hypergraph_->cut(0) : -1;
   int ijk;
   int startOffset;
   int endOffset;
@@ -175,9 +404,14 @@ void controller::initialize_serial_partitions(
   dynamic_array<int> hPartVectorOffsets;
   dynamic_array<int> hPartCuts;
 
-  int numTotVertices = hypergraph_->number_of_vertices();
-  auto pVector = hypergraph_->partition_vector();
-  auto pCuts = hypergraph_->partition_cuts();
+  int numTotVertices = hgraph.total_number_of_vertices();
+  dynamic_array<int> pVector;
+  dynamic_array<int> pCuts;
+
+  if (hypergraph_) {
+    pVector = hypergraph_->partition_vector();
+    pCuts = hypergraph_->partition_cuts();
+  }
 
   dynamic_array<int> numVperProc(number_of_processors_);
   dynamic_array<int> procDispls(number_of_processors_);
@@ -219,7 +453,8 @@ void controller::initialize_serial_partitions(
         }
       }
 
-      if (ij == 0) {
+      // processors without a replica have no partition
+      if (ij == 0 && procCuts[proc] >= 0) {
         keepPartitions[proc] = 1;
         ++numKept;
       } else
@@ -58,6 +58,10 @@ void options::add_general_options() {
 
     ("hypergraph", po::value<std::string>(), "Hypergraph file to partition.")
 
+    ("single-file-input", po::bool_switch()->default_value(false),
+     "Load the hypergraph from a single (unsplit) binary file, memory mapped "
+     "by every process, rather than from '<hypergraph>-<rank>' part files.")
+
     ("config,o", po::value<std::string>(), "Configuration file to load.")
 
     ("number-of-runs,n", po::value<int>()->default_value(1),
@@ -97,8 +101,24 @@ void options::add_general_options() {
     ("write-partitions-to-file", po::bool_switch()->default_value(false),
      "Write the computed partition to file.")
 
+    ("partition-file-format",
+     po::value<std::string>()->default_value("binary"),
+     "Format of the partition file. Options:\n"
+     "  binary: one int per vertex,\n"
+     "  text: one part per line.")
+
+    ("partition-gather-limit", po::value<int>()->default_value(1 << 20),
+     "Partitions of at most this many vertices are gathered to and written "
+     "by one process. Larger partitions are written collectively by every "
+     "process with MPI-IO.")
+
     ("random-vertex-shuffle", po::bool_switch()->default_value(false),
      "Randomly shuffle vertices between processes before coarsening.")
+
+    ("sparse-exchange", po::bool_switch()->default_value(false),
+     "Exchange message sizes only between processes that communicate, "
+     "rather than between all pairs of processes. Faster on large numbers "
+     "of processes when each process communicates with only a few others.")
   ;
 }
 
@@ -146,6 +166,32 @@ void options::add_coarsening_options() {
     ("coarsening.randomly-process-match-requests",
      po::bool_switch()->default_value(false),
      "Process match requests in a random order from other processes.")
+
+    ("coarsening.summary-pins", po::value<int>()->default_value(0),
+     "If positive, only the process storing a hyperedge loads all of its "
+     "pins. Other processes receive their own pins of the hyperedge and at "
+     "most this many of its other pins as matching candidates. 0 sends "
+     "hyperedges in full.")
+
+    ("coarsening.communication-budget", po::value<long>()->default_value(0),
+     "If positive, the hyperedges loaded at each parallel coarsening level "
+     "are those up to the longest length that keeps the bytes of hyperedges "
+     "sent between processes within this budget, instead of those chosen by "
+     "'percentile-cutoff'.")
+
+    ("coarsening.match-request-batch", po::value<int>()->default_value(0),
+     "If positive, first-choice coarsening sends match requests to other "
+     "processes in batches, every this many local vertices visited, and "
+     "answers them as they arrive while matching continues. 0 exchanges "
+     "them in two synchronous rounds after local matching. With more than "
+     "one of 'threads', all requests are sent after local matching.")
+
+    ("coarsening.threads", po::value<int>()->default_value(1),
+     "Number of threads each process uses to contract hyperedges during "
+     "parallel coarsening, and to match its local vertices during "
+     "first-choice coarsening. More than 1 thread matches before any "
+     "requests of 'match-request-batch' are sent, losing their overlap with "
+     "matching. Must be greater than 0.")
   ;
 }
 
@@ -169,6 +215,24 @@ void options::add_serial_partitioning_options() {
 
     ("serial-partitioning.use-patoh", po::bool_switch()->default_value(false),
      "Use PaToH to perform serial partitioning (if available).")
+
+    ("serial-partitioning.replicas", po::value<int>()->default_value(0),
+     "Number of processes the coarsest hypergraph is gathered onto for "
+     "recursive bisection. 0: every process, -1: one process per shared "
+     "memory node.")
+
+    ("serial-partitioning.shared-replica",
+     po::bool_switch()->default_value(false),
+     "Store one copy of the coarsest hypergraph per shared memory node, in "
+     "memory shared by the node's processes. Every process still takes part "
+     "in recursive bisection and 'replicas' is ignored.")
+
+    ("serial-partitioning.cache-k-way-gains",
+     po::bool_switch()->default_value(false),
+     "Cache each vertex's move gains during serial k-way refinement and only "
+     "recompute them after a vertex sharing a hyperedge with it has moved. "
+     "Uses memory proportional to the number of vertices times the number "
+     "of parts.")
   ;
 
   recursive_bisection_.add_options()
@@ -190,6 +254,15 @@ void options::add_serial_partitioning_options() {
     ("recursive-bisection.number-of-initial-partitioning-runs",
      po::value<int>()->default_value(10),
      "Number of bisection runs used on the coarsest hypergraph.")
+
+    ("recursive-bisection.threads", po::value<int>()->default_value(1),
+     "Number of threads each process splits the runs of a bisection between.")
+
+    ("recursive-bisection.work-stealing",
+     po::bool_switch()->default_value(false),
+     "Queue the sub-bisections left to single processes as tasks that idle "
+     "processes steal, instead of each process finishing its own half of the "
+     "recursion. Results then depend on timing.")
   ;
 
   patoh_.add_options()
@@ -262,6 +335,15 @@ void options::add_refinement_options() {
      "Limit the length of hyperedges which may be refined. The length is "
      "determined by 'coarsening.reduction-ratio'.")
 
+    ("refinement.threads", po::value<int>()->default_value(1),
+     "Number of threads each processor uses to compute the gains of candidate "
+     "moves during parallel refinement. Must be greater than 0.")
+
+    ("refinement.gain-ordered", po::bool_switch()->default_value(false),
+     "Visit the boundary vertices in order of decreasing gain during "
+     "parallel refinement, rather than visiting every vertex in random "
+     "order. Gain-ordered passes use one thread per processor.")
+
     // TODO(gb610): add to config file -- remove previous two options?!
     ("refinement.approximate", po::value<int>()->default_value(0),
      "Approximate refinement. Options:\n"
@@ -398,6 +480,9 @@ void options::validate_variables() const {
   okay &= check_greater_than<double>("balance-constraint", 0.0);
   okay &= check_between("vertex-to-processor-allocation", 0, 2);
   okay &= check_greater_than_equal<int>("sprng-seed", 0);
+  okay &= check_in_set<std::string>("partition-file-format",
+                                    {"binary", "text"});
+  okay &= check_greater_than_equal<int>("partition-gather-limit", 0);
 
   // Coarsening options.
   okay &= check_in_set<std::string>("coarsening.type", {"first-choice",
@@ -410,14 +495,27 @@ void options::validate_variables() const {
                                     {"random", "increasing", "decreasing",
                                     "increasing-weight", "decreasing-weight"});
   okay &= check_between<int>("coarsening.connectivity-metric", 0, 3);
+  okay &= check_greater_than_equal<int>("coarsening.summary-pins", 0);
+  okay &= check_greater_than_equal<long>("coarsening.communication-budget", 0);
+  okay &= check_greater_than_equal<int>("coarsening.match-request-batch", 0);
+  okay &= check_greater_than<int>("coarsening.threads", 0);
+  if (get<int>("coarsening.threads") > 1 &&
+      get<int>("coarsening.match-request-batch") > 0) {
+    std::cerr << "[Warning!] Option 'coarsening.match-request-batch' only "
+        << "overlaps match requests with matching when 'coarsening.threads' "
+        << "is 1 - the requests will be sent after local matching."
+        << std::endl;
+  }
 
   // Serial partitioning.
   okay &= check_greater_than<int>("serial-partitioning.number-of-runs", 0);
   okay &= check_clash("serial-partitioning.use-patoh",
                       "serial-partitioning.use-hmetis");
+  okay &= check_greater_than_equal<int>("serial-partitioning.replicas", -1);
   okay &= check_in_set<std::string>("recursive-bisection.v-cycles",
                             {"final-only", "all", "off"});
   okay &= check_greater_than<int>("recursive-bisection.number-of-runs", 0);
+  okay &= check_greater_than<int>("recursive-bisection.threads", 0);
   okay &= check_in_set<std::string>("patoh.partition-options",
                             {"default", "speed", "quality"});
   okay &= check_in_set<std::string>("hmetis.coarsening", {"first-choice", "hybrid",
@@ -433,6 +531,7 @@ void options::validate_variables() const {
   okay &= check_between<int>("refinement.acceptance-threshold", 0, 100);
   okay &= check_between<int>("refinement.threshold-reduction", 0, 100);
   okay &= check_between<int>("refinement.early-exit", 0, 100);
+  okay &= check_greater_than<int>("refinement.threads", 0);
 
   if (!okay) {
     std::exit(1);
@@ -456,6 +555,9 @@ void options::generate_options_file() const {
     "\n"
     "# Hypergraph file to partition.\n"
     "hypergraph =\n"
+    "# Load the hypergraph from a single (unsplit) binary file rather than from\n"
+    "# '<hypergraph>-<rank>' part files.\n"
+    "single-file-input = false\n"
     "# Number of parallel partitioning runs.\n"
     "number-of-runs = 1\n"
     "# Number of parts sought in partition.\n"
@@ -480,8 +582,18 @@ void options::generate_options_file() const {
     "output-file arg = parkway_output.log\n"
     "# Write the computed partitions to file.\n"
     "write-partitions-to-file = false\n"
+    "# Format of the partition file.\n"
+    "# Options:\n"
+    "#   binary: one int per vertex,\n"
+    "#   text: one part per line.\n"
+    "partition-file-format = binary\n"
+    "# Partitions of at most this many vertices are written by one process,\n"
+    "# larger ones collectively by every process with MPI-IO.\n"
+    "partition-gather-limit = 1048576\n"
     "# Randomly shuffle vertices between processes before coarsening.\n"
     "random-vertex-shuffle = false\n"
+    "# Exchange message sizes only between processes that communicate.\n"
+    "sparse-exchange = false\n"
     "\n"
     "[coarsening]\n"
     "# Type of coarsener.\n"
@@ -519,6 +631,25 @@ void options::generate_options_file() const {
     "connectivity-metric = 0\n"
     "# Process match requests in a random order from other processes.\n"
     "randomly-process-match-requests = false\n"
+    "# If positive, only the process storing a hyperedge loads all of its pins.\n"
+    "# Other processes receive their own pins of the hyperedge and at most this\n"
+    "# many of its other pins as matching candidates. 0 sends hyperedges in full.\n"
+    "summary-pins = 0\n"
+    "# If positive, the hyperedges loaded at each parallel coarsening level are those\n"
+    "# up to the longest length that keeps the bytes of hyperedges sent between\n"
+    "# processes within this budget, instead of those chosen by 'percentile-cutoff'.\n"
+    "communication-budget = 0\n"
+    "# If positive, first-choice coarsening sends match requests to other processes\n"
+    "# in batches, every this many local vertices visited, and answers them as they\n"
+    "# arrive while matching continues. 0 exchanges them in two synchronous rounds\n"
+    "# after local matching. With more than one of 'threads', all requests are sent\n"
+    "# after local matching.\n"
+    "match-request-batch = 0\n"
+    "# Number of threads each process uses to contract hyperedges during parallel\n"
+    "# coarsening, and to match its local vertices during first-choice coarsening.\n"
+    "# More than 1 thread matches before any requests of 'match-request-batch' are\n"
+    "# sent, losing their overlap with matching. Must be greater than 0.\n"
+    "threads = 1\n"
     "\n"
     "[serial-partitioning]\n"
     "# Number of serial partitioning runs. If hMETIS or PaToH are used, each\n"
@@ -533,6 +664,19 @@ void options::generate_options_file() const {
     "use-hmetis = false\n"
     "# Use PaToH to perform serial partitioning (if available).\n"
     "use-patoh = false\n"
+    "# Number of processes the coarsest hypergraph is gathered onto for\n"
+    "# recursive bisection. 0: every process, -1: one process per shared memory\n"
+    "# node.\n"
+    "replicas = 0\n"
+    "# Store one copy of the coarsest hypergraph per shared memory node, in\n"
+    "# memory shared by the node's processes. Every process still takes part\n"
+    "# in recursive bisection and 'replicas' is ignored.\n"
+    "shared-replica = false\n"
+    "# Cache each vertex's move gains during serial k-way refinement and only\n"
+    "# recompute them after a vertex sharing a hyperedge with it has moved.\n"
+    "# Uses memory proportional to the number of vertices times the number of\n"
+    "# parts.\n"
+    "cache-k-way-gains = false\n"
     "\n"
     "# Recursive bisection options (only used if both 'use-hmetis' and 'use-patoh'\n"
     "# are false).\n"
@@ -549,6 +693,12 @@ void options::generate_options_file() const {
     "number-of-runs = 2\n"
     "# Number of bisection runs used on the coarsest hypergraph.\n"
     "number-of-initial-partitioning-runs = 10\n"
+    "# Number of threads each process splits the runs of a bisection between.\n"
+    "threads = 1\n"
+    "# Queue the sub-bisections left to single processes as tasks that idle\n"
+    "# processes steal, instead of each process finishing its own half of the\n"
+    "# recursion. Results then depend on timing.\n"
+    "work-stealing = false\n"
     "\n"
     "# PaToH (only if compiled with PaToH and use-patoh = true)\n"
     "[patoh]\n"
@@ -606,7 +756,14 @@ void options::generate_options_file() const {
     "early-exit = 100\n"
     "# Limit the length of hyperedges which may be refined. The length is\n"
     "# determined by 'coarsening.reduction-ratio'.\n"
-    "limit-by-length = false\n";
+    "limit-by-length = false\n"
+    "# Number of threads each processor uses to compute the gains of candidate\n"
+    "# moves during parallel refinement. Must be greater than 0.\n"
+    "threads = 1\n"
+    "# Visit the boundary vertices in order of decreasing gain during parallel\n"
+    "# refinement, rather than visiting every vertex in random order.\n"
+    "# Gain-ordered passes use one thread per processor.\n"
+    "gain-ordered = false\n";
   options_file.close();
   std::cout << "Saved configuartion file as '" << filename << "'" << std::endl;
 }
@@ -7,6 +7,7 @@
 #include "refiners/parallel/refiner.hpp"
 #include "internal/serial_controller.hpp"
 #include "internal/parallel_controller.hpp"
+#include "internal/global_communicator.hpp"
 #include "hypergraph/hypergraph.hpp"
 #include "utility/logging.hpp"
 #include "utility/component_builders.hpp"
@@ -58,9 +59,14 @@ int k_way_partition(const parkway::options &options, MPI_Comm comm) {
 
   Funct::printIntro();
 
+  if (options.get<bool>("sparse-exchange")) {
+    parkway::global_communicator::enable_sparse_exchange();
+  }
+
   LOG(trace) << "Creating initial hypergraph";
   parallel::hypergraph *hgraph = new parallel::hypergraph(
-      rank, number_of_processors, file_name, comm);
+      rank, number_of_processors, file_name, comm,
+      options.get<bool>("single-file-input"));
 
   if (!hgraph) {
     error_on_processor("p[%d] not able to build local hypergraph from %s - "
@@ -68,7 +74,7 @@ int k_way_partition(const parkway::options &options, MPI_Comm comm) {
     MPI_Abort(comm, 0);
   }
 
-  ds::internal::table_utils::set_scatter_array(hgraph->total_number_of_vertices());
+  ds::internal::table_utils::set_scatter_key(hgraph->total_number_of_vertices());
 
   int num_parts = options.get<int>("number-of-parts");
   parallel::coarsener *coarsener = parkway::build_parallel_coarsener(
@@ -123,7 +129,9 @@ int k_way_partition(const parkway::options &options, MPI_Comm comm) {
   if (options.get<bool>("write-partitions-to-file")) {
     char part_file[512];
     sprintf(part_file, "%s.part.%d", file_name, num_parts);
-    controller->partition_to_file(part_file, comm);
+    controller->partition_to_file(
+        part_file, options.get<std::string>("partition-file-format") == "text",
+        options.get<int>("partition-gather-limit"), comm);
   }
 
   return controller->best_cut_size();
@@ -11,15 +11,34 @@
 #include "refiners/parallel/k_way_greedy_refiner.hpp"
 #include "utility/random.hpp"
 #include "utility/logging.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
 namespace parkway {
 namespace parallel {
 
+namespace {
+// Vertices whose best moves one thread computes at a time in a threaded pass.
+const int vertices_per_task = 64;
+// Tasks per thread in each batch of a threaded pass.
+const int tasks_per_thread = 4;
+// The sparse connectivity structures are used when they need less than this
+// fraction of the memory of the dense ones.
+const int sparse_memory_ratio = 4;
+// With the sparse structures a vertex's gains are swept when it has at least
+// one candidate part for every this many parts.
+const int sparse_sweep_parts = 64;
+}  // namespace
+
 k_way_greedy_refiner::k_way_greedy_refiner(int rank, int nProcs, int nParts,
-                                           int numVperP, int eExit, double lim)
-    : refiner(rank, nProcs, nParts) {
+                                           int numVperP, int eExit, double lim,
+                                           int nThreads, bool gainOrdered)
+    : refiner(rank, nProcs, nParts),
+      sparse_connectivity_(false),
+      threads_(nThreads),
+      thread_pool_(nullptr),
+      gain_ordered_(gainOrdered) {
   int i;
   int j;
   int ij;
@@ -60,24 +79,31 @@ k_way_greedy_refiner::k_way_greedy_refiner(int rank, int nProcs, int nParts,
   movement_sets_ = new ds::movement_set_table(number_of_parts_, processors_);
 
   number_of_neighbor_parts_.resize(0);
-  neighbors_of_vertices_.resize(0);
-  neighbors_of_vertices_offsets_.resize(0);
-  hyperedge_vertices_in_part_.resize(0);
-  hyperedge_vertices_in_part_offsets_.resize(0);
   vertices_.resize(0);
   moved_vertices_.resize(0);
   number_of_parts_spanned_.resize(0);
   spanned_parts_.resize(0);
   locked_.reserve(0);
   vertices_seen_.reserve(0);
+
+  if (threads_ > 1) {
+    thread_pool_ = new utility::thread_pool(threads_);
+    ij = threads_ * tasks_per_thread * vertices_per_task;
+
+    batch_vertices_.resize(ij);
+    batch_moves_.resize(ij);
+    batch_gains_.resize(ij);
+  }
 }
 
 k_way_greedy_refiner::~k_way_greedy_refiner() {
+  delete thread_pool_;
 }
 
 void k_way_greedy_refiner::display_options() const {
   info("|--- PARA_REF: \n"
-       "|- PKWAY: eeL = %.2f eExit = %i\n|\n", limit_, early_exit_);
+       "|- PKWAY: eeL = %.2f eExit = %i threads = %i gainOrd = %i\n|\n",
+       limit_, early_exit_, threads_, gain_ordered_ ? 1 : 0);
 }
 
 void k_way_greedy_refiner::release_memory() {
@@ -85,20 +111,22 @@ void k_way_greedy_refiner::release_memory() {
   hyperedge_offsets_.resize(0);
   local_pin_list_.resize(0);
 
-  vertex_to_hyperedges_offset_.resize(0);
-  vertex_to_hyperedges_.resize(0);
+  vertex_to_hyperedges_offset_.clear_and_shrink();
+  vertex_to_hyperedges_.clear_and_shrink();
   allocated_hyperedges_.resize(0);
 
-  number_of_neighbor_parts_.resize(0);
-  neighbors_of_vertices_.resize(0);
-  neighbors_of_vertices_offsets_.resize(0);
-  hyperedge_vertices_in_part_.resize(0);
-  hyperedge_vertices_in_part_offsets_.resize(0);
-  vertices_.resize(0);
+  number_of_neighbor_parts_.clear_and_shrink();
+  neighbors_of_vertices_.clear_and_shrink();
+  hyperedge_part_capacities_.clear_and_shrink();
+  vertex_part_capacities_.clear_and_shrink();
+  gain_queue_.clear_and_shrink();
+  hyperedge_vertices_in_part_.clear_and_shrink();
+  part_gains_.clear_and_shrink();
+  vertices_.clear_and_shrink();
   moved_vertices_.resize(0);
-  seen_vertices_.resize(0);
-  number_of_parts_spanned_.resize(0);
-  spanned_parts_.resize(0);
+  seen_vertices_.clear_and_shrink();
+  number_of_parts_spanned_.clear_and_shrink();
+  spanned_parts_.clear_and_shrink();
 
   non_local_vertices_.resize(0);
   part_indices_.resize(0);
@@ -116,6 +144,11 @@ void k_way_greedy_refiner::initialize_data_structures(
   int i;
   int j;
   int ij;
+  int hEdge;
+  int endOffset;
+
+  long denseBytes;
+  long sparseBytes;
 
   initialize_partition_structures(h, comm);
 
@@ -134,25 +167,68 @@ void k_way_greedy_refiner::initialize_data_structures(
   spanned_parts_.resize(number_of_parts_);
   number_of_parts_spanned_.resize(number_of_hyperedges_);
   number_of_neighbor_parts_.resize(number_of_local_vertices_);
-  neighbors_of_vertices_.resize(number_of_local_vertices_ * number_of_parts_);
-  neighbors_of_vertices_offsets_.resize(number_of_local_vertices_ + 1);
 
-  hyperedge_vertices_in_part_.resize(number_of_hyperedges_ * number_of_parts_);
-  hyperedge_vertices_in_part_offsets_.resize(number_of_hyperedges_ + 1);
+  // ###
+  // bound the number of parts each hyperedge can span and
+  // each vertex can be adjacent to. If storing only those
+  // parts takes much less memory than a count or flag for
+  // every part, use the sparse connectivity structures
+  // ###
+
+  hyperedge_part_capacities_.resize(number_of_hyperedges_);
+  vertex_part_capacities_.resize(number_of_local_vertices_);
+  sparseBytes = 0;
+
+  for (i = 0; i < number_of_hyperedges_; ++i) {
+    // one more than the length as a pin's new part is added
+    // before its old part is removed
+    ij = std::min(hyperedge_offsets_[i + 1] - hyperedge_offsets_[i] + 1,
+                  number_of_parts_);
+    hyperedge_part_capacities_[i] = ij;
+    sparseBytes += ij * (sizeof(int) * 2);
+  }
 
-  j = 0;
-  ij = number_of_parts_;
+  for (i = 0; i < number_of_local_vertices_; ++i) {
+    ij = 0;
+    endOffset = vertex_to_hyperedges_offset_[i + 1];
+
+    for (j = vertex_to_hyperedges_offset_[i]; j < endOffset && ij < number_of_parts_; ++j) {
+      hEdge = vertex_to_hyperedges_[j];
+      ij += hyperedge_part_capacities_[hEdge];
+    }
 
-  for (i = 0; i <= number_of_local_vertices_; ++i) {
-    neighbors_of_vertices_offsets_[i] = j;
-    j += ij;
+    ij = std::min(ij + 1, number_of_parts_);
+    vertex_part_capacities_[i] = ij;
+    sparseBytes += ij * sizeof(int);
   }
 
-  j = 0;
+  sparseBytes += (number_of_hyperedges_ + number_of_local_vertices_) *
+                 (sizeof(long) + sizeof(int));
+  denseBytes = static_cast<long>(number_of_hyperedges_ + number_of_local_vertices_) *
+               number_of_parts_;
+
+  sparse_connectivity_ = sparseBytes * sparse_memory_ratio < denseBytes;
+
+  if (gain_ordered_) {
+    // ###
+    // no move can gain more than the weight of the
+    // hyperedges incident on the vertex
+    // ###
+
+    int maxGain = 0;
+
+    for (i = 0; i < number_of_local_vertices_; ++i) {
+      ij = 0;
+      endOffset = vertex_to_hyperedges_offset_[i + 1];
+
+      for (j = vertex_to_hyperedges_offset_[i]; j < endOffset; ++j) {
+        ij += hyperedge_weights_[vertex_to_hyperedges_[j]];
+      }
+
+      maxGain = std::max(maxGain, ij);
+    }
 
-  for (i = 0; i <= number_of_hyperedges_; ++i) {
-    hyperedge_vertices_in_part_offsets_[i] = j;
-    j += ij;
+    gain_queue_.reset(number_of_local_vertices_, maxGain);
   }
 }
 
@@ -170,9 +246,6 @@ void k_way_greedy_refiner::set_partitioning_structures(int pNo, MPI_Comm comm) {
   int j;
   int ij;
 
-  int neighVertOffset;
-  int hEdgeVertOffset;
-  int vertOffset;
   int endOffset;
   int numSpanned;
   int vertex;
@@ -216,20 +289,22 @@ void k_way_greedy_refiner::set_partitioning_structures(int pNo, MPI_Comm comm) {
     number_of_neighbor_parts_[i] = 0;
   }
 
-  j = neighbors_of_vertices_offsets_[number_of_local_vertices_];
-
-  for (i = 0; i < j; ++i)
-    neighbors_of_vertices_[i] = 0;
-
   j = number_of_hyperedges_;
 
   for (i = 0; i < j; ++i)
     number_of_parts_spanned_[i] = 0;
 
-  j = hyperedge_vertices_in_part_offsets_[number_of_hyperedges_];
+  if (sparse_connectivity_) {
+    hyperedge_vertices_in_part_.reset(number_of_hyperedges_, number_of_parts_,
+                                      hyperedge_part_capacities_.data());
+    neighbors_of_vertices_.reset(number_of_local_vertices_, number_of_parts_,
+                                 vertex_part_capacities_.data());
+  } else {
+    hyperedge_vertices_in_part_.reset(number_of_hyperedges_, number_of_parts_);
+    neighbors_of_vertices_.reset(number_of_local_vertices_, number_of_parts_);
+  }
 
-  for (i = 0; i < j; ++i)
-    hyperedge_vertices_in_part_[i] = 0;
+  part_gains_.resize(threads_ * hyperedge_vertices_in_part_.stride());
 
   MPI_Allreduce(locPartWts.data(), part_weights_.data(), number_of_parts_,
                 MPI_INT, MPI_SUM, comm);
@@ -241,7 +316,6 @@ void k_way_greedy_refiner::set_partitioning_structures(int pNo, MPI_Comm comm) {
 
   for (i = 0; i < number_of_hyperedges_; ++i) {
     endOffset = hyperedge_offsets_[i + 1];
-    hEdgeVertOffset = hyperedge_vertices_in_part_offsets_[i];
     numSpanned = 0;
 
     for (j = hyperedge_offsets_[i]; j < endOffset; ++j) {
@@ -259,13 +333,9 @@ void k_way_greedy_refiner::set_partitioning_structures(int pNo, MPI_Comm comm) {
 #ifdef DEBUGU_REFINER
       assert(vPart >= 0 && vPart < numParts);
 #endif
-      ij = hEdgeVertOffset + vPart;
-
-      if (hyperedge_vertices_in_part_[ij] == 0) {
+      if (hyperedge_vertices_in_part_.add(i, vPart) == 1) {
         spanned_parts_[numSpanned++] = vPart;
       }
-
-      ++hyperedge_vertices_in_part_[ij];
     }
 
 #ifdef DEBUG_REFINER
@@ -290,15 +360,10 @@ void k_way_greedy_refiner::set_partitioning_structures(int pNo, MPI_Comm comm) {
 
       if (vertex >= minimum_vertex_index_ && vertex < maximum_vertex_index_) {
         v = vertex - minimum_vertex_index_;
-        vertOffset = neighbors_of_vertices_offsets_[v];
 
         for (ij = 0; ij < numSpanned; ++ij) {
-          neighVertOffset = vertOffset + spanned_parts_[ij];
-
-          if (neighbors_of_vertices_[neighVertOffset] == 0)
+          if (neighbors_of_vertices_.insert(v, spanned_parts_[ij]))
             ++number_of_neighbor_parts_[v];
-
-          neighbors_of_vertices_[neighVertOffset] = 1;
         }
       }
     }
@@ -383,6 +448,14 @@ int k_way_greedy_refiner::greedy_k_way_refinement(parallel::hypergraph &h,
 }
 
 int k_way_greedy_refiner::greedy_pass(int lowToHigh, MPI_Comm comm) {
+  if (gain_ordered_) {
+    return gain_ordered_pass(lowToHigh, comm);
+  }
+
+  if (threads_ > 1) {
+    return threaded_greedy_pass(lowToHigh, comm);
+  }
+
   int i;
   int j;
   int ij;
@@ -391,22 +464,15 @@ int k_way_greedy_refiner::greedy_pass(int lowToHigh, MPI_Comm comm) {
   int gain;
   int prod;
   int vGain;
-  int posGain;
-  int hEdge;
   int bestMove;
   int randomNum;
   int vertexWt;
-  int vertOffset;
-  int vNeighOffset;
-  int hEdgeOff;
-  int neighOfVOffset;
   int numNonPos = 0;
   int limNonPosMoves = static_cast<int>(
       ceil(limit_ * static_cast<double>(number_of_local_vertices_)));
 
   double currImbalance = 0;
   double bestImbalance;
-  double posImbalance;
 
   for (i = 0; i < number_of_parts_; ++i) {
     prod = number_of_parts_ * i;
@@ -441,138 +507,508 @@ int k_way_greedy_refiner::greedy_pass(int lowToHigh, MPI_Comm comm) {
     randomNum = parkway::utility::random(0, i);
     v = vertices_[randomNum];
 
-    if (!locked_(v)) {
-      vertexWt = vertex_weights_[v];
-      sP = current_partition_vector_[v];
-      vGain = 0;
-      bestImbalance = currImbalance;
-      bestMove = -1;
-
-      if (number_of_neighbor_parts_[v] > 1) {
-        vNeighOffset = neighbors_of_vertices_offsets_[v];
-
-        for (j = 0; j < number_of_parts_; ++j) {
-          if (neighbors_of_vertices_[vNeighOffset + j] > 0 &&
-              ((lowToHigh && j > sP) || (!lowToHigh && j < sP))) {
-            if (part_weights_[j] + vertexWt <= maximum_part_weight_) {
-              posGain = 0;
-              vertOffset = vertex_to_hyperedges_offset_[v + 1];
-
-              for (ij = vertex_to_hyperedges_offset_[v]; ij < vertOffset; ++ij) {
-                hEdge = vertex_to_hyperedges_[ij];
-                hEdgeOff = hyperedge_vertices_in_part_offsets_[hEdge];
-
-                if (hyperedge_vertices_in_part_[hEdgeOff + sP] == 1) {
-                  posGain += hyperedge_weights_[hEdge];
-                }
+    if (!locked_(v) && number_of_neighbor_parts_[v] > 1) {
+      bestMove = best_move(v, lowToHigh, currImbalance, vGain, bestImbalance,
+                           part_gains_.data());
 
-                if (hyperedge_vertices_in_part_[hEdgeOff + j] == 0) {
-                  posGain -= hyperedge_weights_[hEdge];
-                }
-              }
+      if (bestMove != -1) {
+        vertexWt = vertex_weights_[v];
+        sP = current_partition_vector_[v];
 
-              posImbalance = currImbalance + std::fabs(part_weights_[sP] - (vertexWt + average_part_weight_));
-              posImbalance += std::fabs((part_weights_[j] + vertexWt) - average_part_weight_);
-              posImbalance -= std::fabs(part_weights_[sP] - average_part_weight_);
-              posImbalance -= std::fabs(part_weights_[j] - average_part_weight_);
+        commit_move(v, sP, bestMove, vGain, vertexWt);
+        currImbalance = bestImbalance;
 
-              if ((posGain > vGain) ||
-                  (posGain == vGain && posImbalance < bestImbalance)) {
-                vGain = posGain;
-                bestMove = j;
-                bestImbalance = posImbalance;
-              }
-            }
-          }
+        // ###
+        // update the gain...
+        // ###
+
+        gain += vGain;
+        numNonPos = vGain <= 0 ? numNonPos + 1 : 0;
+
+        if (limit_ < 1.0 && numNonPos > limNonPosMoves) {
+          break;
         }
+      }
+    }
 
+    std::swap(vertices_[randomNum], vertices_[--i]);
+  } while (i > 0);
+  return gain;
+}
 
-        if (bestMove != -1) {
-          vertOffset = vertex_to_hyperedges_offset_[v + 1];
-          neighOfVOffset = neighbors_of_vertices_offsets_[v];
+int k_way_greedy_refiner::threaded_greedy_pass(int lowToHigh, MPI_Comm comm) {
+  int i;
+  int j;
+  int ij;
+  int v;
+  int sP;
+  int gain;
+  int prod;
+  int vGain;
+  int bestMove;
+  int randomNum;
+  int vertexWt;
+  int batchSize;
+  int numTasks;
+  int numNonPos = 0;
+  int limNonPosMoves = static_cast<int>(
+      ceil(limit_ * static_cast<double>(number_of_local_vertices_)));
 
-          // ###
-          // update the moved vertices' stats
-          // ###
+  double currImbalance = 0;
+  double posImbalance;
 
-          if (neighbors_of_vertices_[neighOfVOffset + bestMove] == 0) {
-            ++number_of_neighbor_parts_[v];
-          }
+  for (i = 0; i < number_of_parts_; ++i) {
+    prod = number_of_parts_ * i;
 
-          neighbors_of_vertices_[neighOfVOffset + bestMove] = 1;
-          neighbors_of_vertices_[neighOfVOffset + sP] = 0;
+    for (j = 0; j < number_of_parts_; ++j) {
+      if (i != j) {
+        ij = prod + j;
 
-          for (j = vertex_to_hyperedges_offset_[v]; j < vertOffset; ++j) {
-            // ###
-            // update the hyperedge stats: (vInPart etc.)
-            // ###
+        number_of_vertices_moved_[ij] = 0;
+        v = index_into_move_set_[ij];
 
-            hEdge = vertex_to_hyperedges_[j];
-            hEdgeOff = hyperedge_vertices_in_part_offsets_[hEdge];
-            if (hyperedge_vertices_in_part_[hEdgeOff + bestMove] == 0) {
-              ++number_of_parts_spanned_[hEdge];
-            }
+        move_set_data_[v] = 0;
+        move_set_data_[v + 1] = 0;
+      }
+    }
+  }
 
-            --hyperedge_vertices_in_part_[hEdgeOff + sP];
-            ++hyperedge_vertices_in_part_[hEdgeOff + bestMove];
+  for (i = 0; i < number_of_local_vertices_; ++i) {
+    vertices_[i] = i;
+  }
 
-            if (hyperedge_vertices_in_part_[hEdgeOff + sP] > 0) {
-              neighbors_of_vertices_[neighOfVOffset + sP] = 1;
-            } else {
-              --number_of_parts_spanned_[hEdge];
-            }
-          }
+  for (i = 0; i < number_of_parts_; ++i) {
+    currImbalance += std::fabs(part_weights_[i] - average_part_weight_);
+  }
 
-          if (neighbors_of_vertices_[neighOfVOffset + sP] == 0) {
-            --number_of_neighbor_parts_[v];
-          }
+  i = number_of_local_vertices_;
+  gain = 0;
 
-          // ###
-          // update the adj vertices stats:
-          // (num neighbours in part etc.)
-          // ###
+  while (i > 0) {
+    // ###
+    // draw the next batch in the same random order as the
+    // serial pass and compute the best move of each of its
+    // vertices in parallel, without changing any state
+    // ###
 
-          update_adjacent_vertex_status(v, sP, bestMove);
+    batchSize = std::min(i, static_cast<int>(batch_vertices_.size()));
 
-          // ###
-          // update other structs
-          // ###
+    for (j = 0; j < batchSize; ++j) {
+      randomNum = parkway::utility::random(0, i);
+      batch_vertices_[j] = vertices_[randomNum];
+      std::swap(vertices_[randomNum], vertices_[--i]);
+    }
 
-          locked_.set(v);
-          current_partition_vector_[v] = bestMove;
-          part_weights_[sP] -= vertexWt;
-          part_weights_[bestMove] += vertexWt;
-          currImbalance = bestImbalance;
+    numTasks = (batchSize + vertices_per_task - 1) / vertices_per_task;
 
-          // ###
-          // update the gain...
-          // ###
+    thread_pool_->run(numTasks, [&](int task, int thread) {
+      int first = task * vertices_per_task;
+      int last = std::min(first + vertices_per_task, batchSize);
+      int *gains =
+          part_gains_.data() + thread * hyperedge_vertices_in_part_.stride();
+      double imbalance;
 
-          gain += vGain;
-          numNonPos = vGain <= 0 ? numNonPos + 1 : 0;
+      for (int b = first; b < last; ++b) {
+        int u = batch_vertices_[b];
 
-          // ###
-          // update the movement set structures
-          // ###
+        if (locked_(u) || number_of_neighbor_parts_[u] <= 1) {
+          batch_moves_[b] = -1;
+        } else {
+          batch_moves_[b] = best_move(u, lowToHigh, currImbalance,
+                                      batch_gains_[b], imbalance, gains);
+        }
+      }
+    });
 
-          ij = sP * number_of_parts_ + bestMove;
+    // ###
+    // commit the candidate moves in batch order. Earlier
+    // commits may have changed the neighbourhood of a vertex,
+    // so the chosen move is re-evaluated and only made if it
+    // would still have been accepted by the serial pass
+    // ###
 
-          move_sets_[ij]->at(number_of_vertices_moved_[ij]++) = v + minimum_vertex_index_;
-          move_set_data_[index_into_move_set_[ij]] += vGain;
-          move_set_data_[index_into_move_set_[ij] + 1] += vertexWt;
+    for (j = 0; j < batchSize; ++j) {
+      bestMove = batch_moves_[j];
 
-          if (limit_ < 1.0 && numNonPos > limNonPosMoves) {
-            break;
-          }
+      if (bestMove == -1) {
+        continue;
+      }
+
+      v = batch_vertices_[j];
+      sP = current_partition_vector_[v];
+      vertexWt = vertex_weights_[v];
+
+      if (!neighbors_of_vertices_.contains(v, bestMove) ||
+          part_weights_[bestMove] + vertexWt > maximum_part_weight_) {
+        continue;
+      }
+
+      vGain = move_gain(v, sP, bestMove);
+      posImbalance = move_imbalance(sP, bestMove, vertexWt, currImbalance);
+
+      if (vGain < 0 || (vGain == 0 && posImbalance >= currImbalance)) {
+        continue;
+      }
+
+      commit_move(v, sP, bestMove, vGain, vertexWt);
+      currImbalance = posImbalance;
+
+      // ###
+      // update the gain...
+      // ###
+
+      gain += vGain;
+      numNonPos = vGain <= 0 ? numNonPos + 1 : 0;
+
+      if (limit_ < 1.0 && numNonPos > limNonPosMoves) {
+        return gain;
+      }
+    }
+  }
+
+  return gain;
+}
+
+int k_way_greedy_refiner::gain_ordered_pass(int lowToHigh, MPI_Comm comm) {
+  int i;
+  int j;
+  int ij;
+  int v;
+  int sP;
+  int gain;
+  int prod;
+  int vGain;
+  int bestMove;
+  int vertexWt;
+  int numTouched;
+  int numNonPos = 0;
+  int limNonPosMoves = static_cast<int>(
+      ceil(limit_ * static_cast<double>(number_of_local_vertices_)));
+
+  double currImbalance = 0;
+  double bestImbalance;
+
+  for (i = 0; i < number_of_parts_; ++i) {
+    prod = number_of_parts_ * i;
+
+    for (j = 0; j < number_of_parts_; ++j) {
+      if (i != j) {
+        ij = prod + j;
+
+        number_of_vertices_moved_[ij] = 0;
+        v = index_into_move_set_[ij];
+
+        move_set_data_[v] = 0;
+        move_set_data_[v + 1] = 0;
+      }
+    }
+  }
+
+  for (i = 0; i < number_of_parts_; ++i) {
+    currImbalance += std::fabs(part_weights_[i] - average_part_weight_);
+  }
+
+  // ###
+  // queue the boundary vertices by the gain of their best move;
+  // interior vertices have no move and are never looked at
+  // ###
+
+  for (v = 0; v < number_of_local_vertices_; ++v) {
+    if (!locked_(v) && number_of_neighbor_parts_[v] > 1) {
+      queue_best_move(v, lowToHigh, currImbalance);
+    }
+  }
+
+  gain = 0;
+
+  while (!gain_queue_.empty()) {
+    v = gain_queue_.top();
+
+    // ###
+    // the key may be stale if the part weights have changed
+    // since it was computed. If the best move is now worth
+    // less, requeue the vertex with its current gain
+    // ###
+
+    bestMove = best_move(v, lowToHigh, currImbalance, vGain, bestImbalance,
+                         part_gains_.data());
+
+    if (bestMove == -1) {
+      gain_queue_.remove(v);
+      continue;
+    }
+
+    if (vGain < gain_queue_.key(v)) {
+      gain_queue_.update(v, vGain);
+      continue;
+    }
+
+    gain_queue_.remove(v);
+
+    vertexWt = vertex_weights_[v];
+    sP = current_partition_vector_[v];
+
+    numTouched = commit_move(v, sP, bestMove, vGain, vertexWt);
+    currImbalance = bestImbalance;
+
+    // ###
+    // update the gains of the neighbours whose connectivity
+    // the move changed, which update_adjacent_vertex_status
+    // left in seen_vertices_
+    // ###
+
+    for (i = 0; i < numTouched; ++i) {
+      ij = seen_vertices_[i];
+
+      if (locked_(ij) || number_of_neighbor_parts_[ij] <= 1) {
+        if (gain_queue_.contains(ij)) {
+          gain_queue_.remove(ij);
         }
+      } else {
+        queue_best_move(ij, lowToHigh, currImbalance);
       }
     }
 
-    std::swap(vertices_[randomNum], vertices_[--i]);
-  } while (i > 0);
+    // ###
+    // update the gain...
+    // ###
+
+    gain += vGain;
+    numNonPos = vGain <= 0 ? numNonPos + 1 : 0;
+
+    if (limit_ < 1.0 && numNonPos > limNonPosMoves) {
+      gain_queue_.clear();
+      break;
+    }
+  }
+
   return gain;
 }
 
+void k_way_greedy_refiner::queue_best_move(int v, int lowToHigh,
+                                           double currImbalance) {
+  int vGain;
+  double bestImbalance;
+
+  if (best_move(v, lowToHigh, currImbalance, vGain, bestImbalance,
+                part_gains_.data()) == -1) {
+    if (gain_queue_.contains(v)) {
+      gain_queue_.remove(v);
+    }
+  } else {
+    gain_queue_.update(v, vGain);
+  }
+}
+
+int k_way_greedy_refiner::best_move(int v, int lowToHigh, double currImbalance,
+                                    int &vGain, double &bestImbalance,
+                                    int *gains) const {
+  int j;
+  int sweepGain = 0;
+  int bestMove = -1;
+  int sP = current_partition_vector_[v];
+  int vertexWt = vertex_weights_[v];
+
+  bool sweep = use_sweep(number_of_neighbor_parts_[v] - 1);
+
+  vGain = 0;
+  bestImbalance = currImbalance;
+
+  if (sweep) {
+    sweepGain = sweep_gains(v, sP, gains);
+  }
+
+  auto consider = [&](int to) {
+    if ((lowToHigh && to > sP) || (!lowToHigh && to < sP)) {
+      if (part_weights_[to] + vertexWt <= maximum_part_weight_) {
+        int posGain = sweep ? sweepGain + gains[to] : move_gain(v, sP, to);
+        double posImbalance = move_imbalance(sP, to, vertexWt, currImbalance);
+
+        if ((posGain > vGain) ||
+            (posGain == vGain && posImbalance < bestImbalance)) {
+          vGain = posGain;
+          bestMove = to;
+          bestImbalance = posImbalance;
+        }
+      }
+    }
+  };
+
+  // ###
+  // the sparse structures list the neighbouring parts in
+  // increasing order, so both visit the parts in the same
+  // order and make the same choice
+  // ###
+
+  if (neighbors_of_vertices_.sparse()) {
+    for (int to : neighbors_of_vertices_.members(v)) {
+      consider(to);
+    }
+  } else {
+    for (j = 0; j < number_of_parts_; ++j) {
+      if (neighbors_of_vertices_.contains(v, j)) {
+        consider(j);
+      }
+    }
+  }
+
+  return bestMove;
+}
+
+int k_way_greedy_refiner::move_gain(int v, int sP, int to) const {
+  int hEdge;
+  int posGain = 0;
+  int vertOffset = vertex_to_hyperedges_offset_[v + 1];
+
+  // Unchecked view of the hyperedge weights, which are only read here.
+  ds::span<const int> hyperedge_weights = hyperedge_weights_.view();
+
+  for (int ij = vertex_to_hyperedges_offset_[v]; ij < vertOffset; ++ij) {
+    hEdge = vertex_to_hyperedges_[ij];
+
+    if (hyperedge_vertices_in_part_.single(hEdge, sP)) {
+      posGain += hyperedge_weights[hEdge];
+    }
+
+    if (hyperedge_vertices_in_part_.empty(hEdge, to)) {
+      posGain -= hyperedge_weights[hEdge];
+    }
+  }
+
+  return posGain;
+}
+
+int k_way_greedy_refiner::sweep_gains(int v, int sP, int *gains) const {
+  // ###
+  // computes the gain of moving v out of sP into every part
+  // at once. The gain of the move to part p is the returned
+  // value plus gains[p]
+  // ###
+
+  // ###
+  // moving to a part costs the weight of every hyperedge
+  // with no pins there, i.e. the total weight less the
+  // weight of the hyperedges already present in the part
+  // ###
+
+  int hEdge;
+  int gainFromSP = 0;
+  int vertOffset = vertex_to_hyperedges_offset_[v + 1];
+
+  ds::span<const int> hyperedge_weights = hyperedge_weights_.view();
+
+  std::fill(gains, gains + hyperedge_vertices_in_part_.stride(), 0);
+
+  for (int ij = vertex_to_hyperedges_offset_[v]; ij < vertOffset; ++ij) {
+    hEdge = vertex_to_hyperedges_[ij];
+
+    if (hyperedge_vertices_in_part_.single(hEdge, sP)) {
+      gainFromSP += hyperedge_weights[hEdge];
+    }
+
+    gainFromSP -= hyperedge_weights[hEdge];
+    hyperedge_vertices_in_part_.add_where_present(
+        hEdge, hyperedge_weights[hEdge], gains);
+  }
+
+  return gainFromSP;
+}
+
+bool k_way_greedy_refiner::use_sweep(int candidates) const {
+  // ###
+  // sweeping a hyperedge's row costs about as much as
+  // testing six candidate parts one at a time for every
+  // SIMD width of parts in the row. With the sparse
+  // structures a sweep only visits the parts spanned,
+  // after clearing the gains once per vertex
+  // ###
+
+  int stride = hyperedge_vertices_in_part_.stride();
+
+  if (hyperedge_vertices_in_part_.sparse()) {
+    return candidates * sparse_sweep_parts >= stride;
+  }
+
+  return stride >= ds::part_pin_counts::simd_width &&
+         candidates * ds::part_pin_counts::simd_width >= 6 * stride;
+}
+
+double k_way_greedy_refiner::move_imbalance(int sP, int to, int vertexWt,
+                                            double currImbalance) const {
+  double posImbalance = currImbalance + std::fabs(part_weights_[sP] - (vertexWt + average_part_weight_));
+  posImbalance += std::fabs((part_weights_[to] + vertexWt) - average_part_weight_);
+  posImbalance -= std::fabs(part_weights_[sP] - average_part_weight_);
+  posImbalance -= std::fabs(part_weights_[to] - average_part_weight_);
+  return posImbalance;
+}
+
+int k_way_greedy_refiner::commit_move(int v, int sP, int bestMove, int vGain,
+                                      int vertexWt) {
+  int j;
+  int ij;
+  int hEdge;
+  int numTouched;
+  int vertOffset = vertex_to_hyperedges_offset_[v + 1];
+
+  // ###
+  // update the moved vertices' stats
+  // ###
+
+  if (neighbors_of_vertices_.insert(v, bestMove)) {
+    ++number_of_neighbor_parts_[v];
+  }
+  neighbors_of_vertices_.erase(v, sP);
+
+  for (j = vertex_to_hyperedges_offset_[v]; j < vertOffset; ++j) {
+    // ###
+    // update the hyperedge stats: (vInPart etc.)
+    // ###
+
+    hEdge = vertex_to_hyperedges_[j];
+    if (hyperedge_vertices_in_part_.add(hEdge, bestMove) == 1) {
+      ++number_of_parts_spanned_[hEdge];
+    }
+
+    if (hyperedge_vertices_in_part_.remove(hEdge, sP) > 0) {
+      neighbors_of_vertices_.insert(v, sP);
+    } else {
+      --number_of_parts_spanned_[hEdge];
+    }
+  }
+
+  if (!neighbors_of_vertices_.contains(v, sP)) {
+    --number_of_neighbor_parts_[v];
+  }
+
+  // ###
+  // update the adj vertices stats:
+  // (num neighbours in part etc.)
+  // ###
+
+  numTouched = update_adjacent_vertex_status(v, sP, bestMove);
+
+  // ###
+  // update other structs
+  // ###
+
+  locked_.set(v);
+  current_partition_vector_[v] = bestMove;
+  part_weights_[sP] -= vertexWt;
+  part_weights_[bestMove] += vertexWt;
+
+  // ###
+  // update the movement set structures
+  // ###
+
+  ij = sP * number_of_parts_ + bestMove;
+
+  move_sets_[ij]->at(number_of_vertices_moved_[ij]++) = v + minimum_vertex_index_;
+  move_set_data_[index_into_move_set_[ij]] += vGain;
+  move_set_data_[index_into_move_set_[ij] + 1] += vertexWt;
+
+  return numTouched;
+}
+
 int k_way_greedy_refiner::compute_cutsize(MPI_Comm comm) {
   int i;
   int ij;
@@ -746,10 +1182,10 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
   int v;
   int vertexPart;
   int newVertexPart;
+  int vertexPartPins;
   int locVertIndex;
   int hEdge;
   int endOffset;
-  int neighOfVOffset;
   int othVOffset;
   int othHedge;
   int hEdgeOff;
@@ -836,7 +1272,6 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
 #ifdef DEBUG_REFINER
         assert(hEdge >= 0 && hEdge < numHedges);
 #endif
-        hEdgeOff = hyperedge_vertices_in_part_offsets_[hEdge];
 
 #ifdef DEBUG_REFINER
         int hEdgeLen = 0;
@@ -845,19 +1280,18 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
         assert(hEdgeLen == hEdgeOffset[hEdge + 1] - hEdgeOffset[hEdge]);
         assert(hEdgeVinPart[hEdgeOff + vertexPart] > 0);
 #endif
-        if (hyperedge_vertices_in_part_[hEdgeOff + newVertexPart] == 0) {
+        if (hyperedge_vertices_in_part_.add(hEdge, newVertexPart) == 1) {
           ++number_of_parts_spanned_[hEdge];
         }
 
-        --hyperedge_vertices_in_part_[hEdgeOff + vertexPart];
-        ++hyperedge_vertices_in_part_[hEdgeOff + newVertexPart];
+        vertexPartPins = hyperedge_vertices_in_part_.remove(hEdge, vertexPart);
 
 #ifdef DEBUG_REFINER
         assert(hEdgeVinPart[hEdgeOff + newVertexPart] > 0);
         assert(hEdgeVinPart[hEdgeOff + vertexPart] >= 0);
 #endif
 
-        if (hyperedge_vertices_in_part_[hEdgeOff + vertexPart] == 0)
+        if (vertexPartPins == 0)
           --number_of_parts_spanned_[hEdge];
       }
 
@@ -885,16 +1319,13 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
             locVertIndex = vert - minimum_vertex_index_;
 
             if (vertices_seen_(locVertIndex) == 0) {
-              neighOfVOffset = neighbors_of_vertices_offsets_[locVertIndex];
 
-              if (neighbors_of_vertices_[neighOfVOffset + newVertexPart] == 0) {
+              if (neighbors_of_vertices_.insert(locVertIndex, newVertexPart)) {
                 ++number_of_neighbor_parts_[locVertIndex];
               }
 
-              neighbors_of_vertices_[neighOfVOffset + newVertexPart] = 1;
-
               if (current_partition_vector_[locVertIndex] != vertexPart) {
-                neighbors_of_vertices_[neighOfVOffset + vertexPart] = 0;
+                neighbors_of_vertices_.erase(locVertIndex, vertexPart);
 
                 // sorting out this now...go thro each hedge
                 // of neighbouring vertex and check if its
@@ -907,15 +1338,13 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
                      ++ijk) {
                   othHedge = vertex_to_hyperedges_[ijk];
 
-                  if (hyperedge_vertices_in_part_[
-                          hyperedge_vertices_in_part_offsets_[othHedge] + vertexPart] >
-                      0) {
-                    neighbors_of_vertices_[neighOfVOffset + vertexPart] = 1;
+                  if (!hyperedge_vertices_in_part_.empty(othHedge, vertexPart)) {
+                    neighbors_of_vertices_.insert(locVertIndex, vertexPart);
                     break;
                   }
                 }
 
-                if (neighbors_of_vertices_[neighOfVOffset + vertexPart] == 0) {
+                if (!neighbors_of_vertices_.contains(locVertIndex, vertexPart)) {
                   --number_of_neighbor_parts_[locVertIndex];
                 }
               }
@@ -985,7 +1414,6 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
 #ifdef DEBUG_REFINER
         assert(hEdge >= 0 && hEdge < numHedges);
 #endif
-        hEdgeOff = hyperedge_vertices_in_part_offsets_[hEdge];
 #ifdef DEBUG_REFINER
         int hEdgeLen = 0;
         for (int ijkl = 0; ijkl < numParts; ++ijkl)
@@ -993,18 +1421,17 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
         assert(hEdgeLen == hEdgeOffset[hEdge + 1] - hEdgeOffset[hEdge]);
         assert(hEdgeVinPart[hEdgeOff + vertexPart] > 0);
 #endif
-        if (hyperedge_vertices_in_part_[hEdgeOff + newVertexPart] == 0) {
+        if (hyperedge_vertices_in_part_.add(hEdge, newVertexPart) == 1) {
           ++number_of_parts_spanned_[hEdge];
         }
 
-        --hyperedge_vertices_in_part_[hEdgeOff + vertexPart];
-        ++hyperedge_vertices_in_part_[hEdgeOff + newVertexPart];
+        vertexPartPins = hyperedge_vertices_in_part_.remove(hEdge, vertexPart);
 
 #ifdef DEBUG_REFINER
         assert(hEdgeVinPart[hEdgeOff + newVertexPart] > 0);
         assert(hEdgeVinPart[hEdgeOff + vertexPart] >= 0);
 #endif
-        if (hyperedge_vertices_in_part_[hEdgeOff + vertexPart] == 0)
+        if (vertexPartPins == 0)
           --number_of_parts_spanned_[hEdge];
       }
 
@@ -1032,16 +1459,13 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
             locVertIndex = vert - minimum_vertex_index_;
 
             if (vertices_seen_(locVertIndex) == 0) {
-              neighOfVOffset = neighbors_of_vertices_offsets_[locVertIndex];
 
-              if (neighbors_of_vertices_[neighOfVOffset + newVertexPart] == 0) {
+              if (neighbors_of_vertices_.insert(locVertIndex, newVertexPart)) {
                 ++number_of_neighbor_parts_[locVertIndex];
               }
 
-              neighbors_of_vertices_[neighOfVOffset + newVertexPart] = 1;
-
               if (current_partition_vector_[locVertIndex] != vertexPart) {
-                neighbors_of_vertices_[neighOfVOffset + vertexPart] = 0;
+                neighbors_of_vertices_.erase(locVertIndex, vertexPart);
 
                 // sorting out this now...go thro each hedge
                 // of neighbouring vertex and check if its
@@ -1054,15 +1478,13 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
                      ++ijk) {
                   othHedge = vertex_to_hyperedges_[ijk];
 
-                  if (hyperedge_vertices_in_part_[
-                          hyperedge_vertices_in_part_offsets_[othHedge] + vertexPart] >
-                      0) {
-                    neighbors_of_vertices_[neighOfVOffset + vertexPart] = 1;
+                  if (!hyperedge_vertices_in_part_.empty(othHedge, vertexPart)) {
+                    neighbors_of_vertices_.insert(locVertIndex, vertexPart);
                     break;
                   }
                 }
 
-                if (neighbors_of_vertices_[neighOfVOffset + vertexPart] == 0) {
+                if (!neighbors_of_vertices_.contains(locVertIndex, vertexPart)) {
                   --number_of_neighbor_parts_[locVertIndex];
                 }
               }
@@ -1101,8 +1523,8 @@ void k_way_greedy_refiner::update_vertex_move_info(MPI_Comm comm) {
 #endif
 }
 
-void k_way_greedy_refiner::update_adjacent_vertex_status(int v, int sP,
-                                                         int bestMove) {
+int k_way_greedy_refiner::update_adjacent_vertex_status(int v, int sP,
+                                                        int bestMove) {
   int i;
   int j;
   int ij;
@@ -1113,7 +1535,6 @@ void k_way_greedy_refiner::update_adjacent_vertex_status(int v, int sP,
   int locVertIndex;
   int hEdge;
   int hEdgeOff;
-  int neighOfVOffset;
   int othVOffset;
   int othHedge;
 
@@ -1135,16 +1556,13 @@ void k_way_greedy_refiner::update_adjacent_vertex_status(int v, int sP,
         locVertIndex = vert - minimum_vertex_index_;
 
         if (locVertIndex != v && vertices_seen_(locVertIndex) == 0) {
-          neighOfVOffset = neighbors_of_vertices_offsets_[locVertIndex];
 
-          if (neighbors_of_vertices_[neighOfVOffset + bestMove] == 0) {
+          if (neighbors_of_vertices_.insert(locVertIndex, bestMove)) {
             ++number_of_neighbor_parts_[locVertIndex];
           }
 
-          neighbors_of_vertices_[neighOfVOffset + bestMove] = 1;
-
           if (current_partition_vector_[locVertIndex] != sP) {
-            neighbors_of_vertices_[neighOfVOffset + sP] = 0;
+            neighbors_of_vertices_.erase(locVertIndex, sP);
 
             // sorting out this now...go thro each hedge
             // of neighbouring vertex and check if its
@@ -1156,14 +1574,13 @@ void k_way_greedy_refiner::update_adjacent_vertex_status(int v, int sP,
             for (ij = vertex_to_hyperedges_offset_[locVertIndex]; ij < othVOffset; ++ij) {
               othHedge = vertex_to_hyperedges_[ij];
 
-              if (hyperedge_vertices_in_part_[
-                      hyperedge_vertices_in_part_offsets_[othHedge] + sP] > 0) {
-                neighbors_of_vertices_[neighOfVOffset + sP] = 1;
+              if (!hyperedge_vertices_in_part_.empty(othHedge, sP)) {
+                neighbors_of_vertices_.insert(locVertIndex, sP);
                 break;
               }
             }
 
-            if (neighbors_of_vertices_[neighOfVOffset + sP] == 0) {
+            if (!neighbors_of_vertices_.contains(locVertIndex, sP)) {
               --number_of_neighbor_parts_[locVertIndex];
             }
           }
@@ -1181,11 +1598,14 @@ void k_way_greedy_refiner::update_adjacent_vertex_status(int v, int sP,
   }
 
   // ###
-  // restore the 'seen' vertices structure
+  // restore the 'seen' vertices structure; the vertices
+  // updated are left in seen_vertices_ for the caller
   // ###
 
   for (i = 0; i < numVerticesSeen; ++i)
     vertices_seen_.unset(seen_vertices_[i]);
+
+  return numVerticesSeen;
 }
 
 void k_way_greedy_refiner::undo_move(int indexIntoMoveSets, int from,
@@ -1198,8 +1618,6 @@ void k_way_greedy_refiner::undo_move(int indexIntoMoveSets, int from,
   int j;
 
   int i;
-  int hEdgeOff;
-  int neighOfVOffset;
   int vertOffset;
   int hEdge;
 
@@ -1218,18 +1636,15 @@ void k_way_greedy_refiner::undo_move(int indexIntoMoveSets, int from,
     // ###
 
     vertOffset = vertex_to_hyperedges_offset_[v + 1];
-    neighOfVOffset = neighbors_of_vertices_offsets_[v];
 
     // ###
     // update the moved vertices' stats
     // ###
 
-    if (neighbors_of_vertices_[neighOfVOffset + from] == 0) {
+    if (neighbors_of_vertices_.insert(v, from)) {
       ++number_of_neighbor_parts_[v];
     }
-
-    neighbors_of_vertices_[neighOfVOffset + from] = 1;
-    neighbors_of_vertices_[neighOfVOffset + to] = 0;
+    neighbors_of_vertices_.erase(v, to);
 
     for (j = vertex_to_hyperedges_offset_[v]; j < vertOffset; ++j) {
       // ###
@@ -1240,7 +1655,6 @@ void k_way_greedy_refiner::undo_move(int indexIntoMoveSets, int from,
 #ifdef DEBUG_REFINER
       assert(hEdge >= 0 && hEdge < numHedges);
 #endif
-      hEdgeOff = hyperedge_vertices_in_part_offsets_[hEdge];
 
 #ifdef DEBUG_REFINER
       int hEdgeLen = 0;
@@ -1248,25 +1662,18 @@ void k_way_greedy_refiner::undo_move(int indexIntoMoveSets, int from,
         hEdgeLen += hEdgeVinPart[hEdgeOff + ijk];
       assert(hEdgeLen == hEdgeOffset[hEdge + 1] - hEdgeOffset[hEdge]);
 #endif
-      if (hyperedge_vertices_in_part_[hEdgeOff + from] == 0) {
+      if (hyperedge_vertices_in_part_.add(hEdge, from) == 1) {
         ++number_of_parts_spanned_[hEdge];
       }
 
-      --hyperedge_vertices_in_part_[hEdgeOff + to];
-      ++hyperedge_vertices_in_part_[hEdgeOff + from];
-
-#ifdef DEBUG_REFINER
-      assert(hEdgeVinPart[hEdgeOff + to] >= 0);
-#endif
-
-      if (hyperedge_vertices_in_part_[hEdgeOff + to] > 0) {
-        neighbors_of_vertices_[neighOfVOffset + to] = 1;
+      if (hyperedge_vertices_in_part_.remove(hEdge, to) > 0) {
+        neighbors_of_vertices_.insert(v, to);
       } else {
         --number_of_parts_spanned_[hEdge];
       }
     }
 
-    if (neighbors_of_vertices_[neighOfVOffset + to] == 0) {
+    if (!neighbors_of_vertices_.contains(v, to)) {
       --number_of_neighbor_parts_[v];
     }
 
@@ -1293,9 +1700,9 @@ void k_way_greedy_refiner::undo_move(int indexIntoMoveSets, int from,
 }
 
 void k_way_greedy_refiner::non_local_vertices_check() const {
+#ifndef NDEBUG
   int i;
   int j;
-  int ij;
 
   int vertPart;
   int endOffset;
@@ -1308,11 +1715,11 @@ void k_way_greedy_refiner::non_local_vertices_check() const {
     for (j = non_local_vertices_to_hyperedges_offsets_[i]; j < endOffset; ++j) {
       assert(j < non_local_vertices_to_hyperedges_.capacity());
       h = non_local_vertices_to_hyperedges_[j];
-      assert(h < hyperedge_vertices_in_part_offsets_.capacity());
-      ij = hyperedge_vertices_in_part_offsets_[h];
-      assert(hyperedge_vertices_in_part_[ij + vertPart] > 0);
+      assert(h < number_of_hyperedges_);
+      assert(hyperedge_vertices_in_part_(h, vertPart) > 0);
     }
   }
+#endif
 }
 
 void k_way_greedy_refiner::sanity_hyperedge_check() const {
@@ -1326,11 +1733,10 @@ void k_way_greedy_refiner::sanity_hyperedge_check() const {
   for (i = 0; i < number_of_hyperedges_; ++i) {
     hEdgeLen = hyperedge_offsets_[i + 1] - hyperedge_offsets_[i];
     inParts = 0;
-    ij = hyperedge_vertices_in_part_offsets_[i + 1];
-
-    for (j = hyperedge_vertices_in_part_offsets_[i]; j < ij; ++j) {
-      inParts += hyperedge_vertices_in_part_[j];
-      assert(hyperedge_vertices_in_part_[j] >= 0);
+    for (j = 0; j < number_of_parts_; ++j) {
+      ij = hyperedge_vertices_in_part_(i, j);
+      inParts += ij;
+      assert(ij >= 0);
     }
 
     assert(inParts == hEdgeLen);
@@ -413,9 +413,7 @@ void refiner::initialize_partition_structures(
   int vPerProc;
   int arraySize;
   int vertex;
-  int totalToRecv;
   int endOffset;
-  int totalToSend;
 
   int i;
   int j;
@@ -471,6 +469,8 @@ void refiner::initialize_partition_structures(
     data_out_sets_[ij][send_lens_[ij]++] = j;
   }
 
+  start_count_exchange(comm);
+
   ij = 0;
   for (i = 0; i < processors_; ++i) {
     send_displs_[i] = ij;
@@ -495,84 +495,20 @@ void refiner::initialize_partition_structures(
     }
   }
 
-  MPI_Alltoall(send_lens_.data(), 1, MPI_INT, receive_lens_.data(), 1, MPI_INT,
-               comm);
-
-  ij = 0;
-  for (i = 0; i < processors_; ++i) {
-    receive_displs_[i] = ij;
-    ij += receive_lens_[i];
-  }
-
-  totalToRecv = ij;
-  receive_array_.resize(ij);
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  finish_count_exchange();
+  exchange(comm);
 
   // ###
   // now communicate the partition vector
-  // requests for values of non-local vertices
+  // values of the requested local vertices
   // ###
 
-  totalToSend = totalToRecv * number_of_partitions_;
-  send_array_.resize(totalToSend);
-
-  for (i = 0; i < processors_; ++i) {
-    ij = send_lens_[i];
-    send_lens_[i] = receive_lens_[i] * number_of_partitions_;
-    receive_lens_[i] = ij * number_of_partitions_;
-  }
-
-  ij = 0;
-  j = 0;
-
-  for (i = 0; i < processors_; ++i) {
-    send_displs_[i] = ij;
-    receive_displs_[i] = j;
-
-    ij += send_lens_[i];
-    j += receive_lens_[i];
-  }
-
-// ###
-// now get the partition vector values
-// of the requested local vertices
-// ###
-
-#ifdef DEBUG_REFINER
-  assert(receive_array_.getLength() == totalToRecv);
-  assert(send_array_.getLength() == totalToRecv * numPartitions);
-#endif
-
-  ij = 0;
-  for (i = 0; i < totalToRecv; ++i) {
-    vertex = receive_array_[i] - minimum_vertex_index_;
-
-#ifdef DEBUG_REFINER
-    assert(vertex >= 0 && vertex < maxVertexIndex - minVertexIndex);
-#endif
-
-    for (j = 0; j < number_of_partitions_; ++j) {
-#ifdef DEBUG_REFINER
-      int part = partitionVector[partitionVectorOffsets[j] + vertex];
-      assert(part >= 0 && part < number_of_parts_);
-      assert(ij < totalToRecv * numPartitions);
-#endif
-      send_array_[ij++] = partition_vector_[partition_vector_offsets_[j] + vertex];
+  reply_to_requests(number_of_partitions_, [this](int vertex, int *out) {
+    vertex -= minimum_vertex_index_;
+    for (int p = 0; p < number_of_partitions_; ++p) {
+      out[p] = partition_vector_[partition_vector_offsets_[p] + vertex];
     }
-  }
-#ifdef DEBUG_REFINER
-  assert(ij == totalToSend);
-#endif
-
-  totalToRecv = number_of_non_local_vertices_ * number_of_partitions_;
-  receive_array_.resize(totalToRecv);
-
-  MPI_Alltoallv(send_array_.data(), send_lens_.data(),
-                send_displs_.data(), MPI_INT, receive_array_.data(),
-                receive_lens_.data(), receive_displs_.data(), MPI_INT, comm);
+  }, comm);
 
   ij = 0;
   for (i = 0; i < arraySize; ++i) {
@@ -14,10 +14,8 @@ namespace parkway {
 namespace serial {
 
 fm_refiner::fm_refiner(int max, int insMethod, int ee)  {
-  bucket_arrays_length_ = 0;
   maximum_possible_gain_ = 0;
   maximum_non_positive_moves_ = 0;
-  buckets_.reserve(0);
   move_list_.reserve(0);
   vertex_gains_.reserve(0);
   vertex_in_part_.reserve(0);
@@ -28,13 +26,6 @@ fm_refiner::fm_refiner(int max, int insMethod, int ee)  {
   maximum_part_weight_ = max;
   number_of_parts_ = 2;
   part_weights_.reserve(2);
-  bucket_arrays_.reserve(2);
-  number_of_buckets_in_array_.reserve(2);
-  maximum_gain_entries_.reserve(2);
-  maximum_gains_.reserve(2);
-
-  bucket_arrays_[0] = nullptr;
-  bucket_arrays_[1] = nullptr;
 }
 
 fm_refiner::~fm_refiner() {
@@ -64,18 +55,12 @@ void fm_refiner::build_buckets() {
   int maxVertDeg = 0;
   int maxHedgeWt = 0;
 
-  buckets_.reserve(numVertices);
   vertex_gains_.reserve(numVertices);
   loaded_.reserve(numVertices);
   move_list_.reserve(numVertices);
   vertex_in_part_.reserve(numHedges << 1);
 
   for (i = 0; i < numVertices; ++i) {
-    buckets_[i] = new bucket_node;
-    buckets_[i]->vertex_id = i;
-    buckets_[i]->previous = nullptr;
-    buckets_[i]->next = nullptr;
-
     j = vOffsets[i + 1] - vOffsets[i];
 
     if (j > maxVertDeg)
@@ -89,36 +74,19 @@ void fm_refiner::build_buckets() {
   }
 
   maximum_possible_gain_ = maxVertDeg * maxHedgeWt;
-  bucket_arrays_length_ = (maximum_possible_gain_ << 1) | 0x1;
-
-  bucket_arrays_[0] = new NodeArray(bucket_arrays_length_);
-  bucket_arrays_[1] = new NodeArray(bucket_arrays_length_);
 
-  for (i = 0; i < bucket_arrays_length_; ++i) {
-    (*bucket_arrays_[0])[i].next = nullptr;
-    (*bucket_arrays_[0])[i].vertex_id = -1;
-    (*bucket_arrays_[1])[i].next = nullptr;
-    (*bucket_arrays_[1])[i].vertex_id = -1;
-  }
+  buckets_[0].reset(numVertices, maximum_possible_gain_);
+  buckets_[1].reset(numVertices, maximum_possible_gain_);
 }
 
 void fm_refiner::restore_buckets() {
-  int i;
-
-  for (i = 0; i < bucket_arrays_length_; ++i) {
-    (*bucket_arrays_[0])[i].next = nullptr;
-    (*bucket_arrays_[0])[i].vertex_id = -1;
-    (*bucket_arrays_[1])[i].next = nullptr;
-    (*bucket_arrays_[1])[i].vertex_id = -1;
-  }
-
-  for (i = 0; i < numVertices; ++i) {
-    buckets_[i]->previous = nullptr;
-    buckets_[i]->next = nullptr;
-  }
+  buckets_[0].clear();
+  buckets_[1].clear();
 }
 
 void fm_refiner::destroy_buckets() {
+  buckets_[0].clear_and_shrink();
+  buckets_[1].clear_and_shrink();
 }
 
 void fm_refiner::initialise_partition_structure() {
@@ -162,12 +130,6 @@ void fm_refiner::prepare_vertex_gains() {
   // compute the vertex gains
   // ###
 
-  for (i = 0; i < 2; ++i) {
-    maximum_gains_[i] = -maximum_possible_gain_;
-    maximum_gain_entries_[i] = 0;
-    number_of_buckets_in_array_[i] = 0;
-  }
-
   for (i = 0; i < numVertices; ++i) {
     endOffset = vOffsets[i + 1];
     vPart = partition_vector_[i];
@@ -190,7 +152,6 @@ void fm_refiner::prepare_vertex_gains() {
     }
 
     move_to_bucket_array(vPart, vertex_gains_[i], i);
-    ++number_of_buckets_in_array_[vPart];
   }
 }
 
@@ -205,12 +166,6 @@ void fm_refiner::initialise_gains_1_to_0() {
   // compute vertex gains in 1 to 0 direction
   // ###
 
-  for (i = 0; i < 2; ++i) {
-    maximum_gains_[i] = -maximum_possible_gain_;
-    maximum_gain_entries_[i] = 0;
-    number_of_buckets_in_array_[i] = 0;
-  }
-
   for (i = 0; i < numVertices; ++i) {
     if (partition_vector_[i] == 1) {
       endOffset = vOffsets[i + 1];
@@ -227,11 +182,6 @@ void fm_refiner::initialise_gains_1_to_0() {
       }
 
       move_to_bucket_array(1, vertex_gains_[i], i);
-
-#ifdef DEBUG_FM_REFINER
-      assert(buckets[i]->prev != nullptr);
-#endif
-      ++number_of_buckets_in_array_[1];
     }
   }
 }
@@ -247,12 +197,6 @@ void fm_refiner::initialise_gains_0_to_1() {
   // compute vertex gains in 0 to 1 direction
   // ###
 
-  for (i = 0; i < 2; ++i) {
-    maximum_gains_[i] = -maximum_possible_gain_;
-    maximum_gain_entries_[i] = 0;
-    number_of_buckets_in_array_[i] = 0;
-  }
-
   for (i = 0; i < numVertices; ++i) {
     if (partition_vector_[i] == 0) {
       endOffset = vOffsets[i + 1];
@@ -269,88 +213,21 @@ void fm_refiner::initialise_gains_0_to_1() {
       }
 
       move_to_bucket_array(0, vertex_gains_[i], i);
-
-#ifdef DEBUG_FM_REFINER
-      assert(buckets[i]->prev != nullptr);
-#endif
-      ++number_of_buckets_in_array_[0];
     }
   }
 }
 
 void fm_refiner::remove_buckets_from_1() {
-  int i;
-  bucket_node *b;
-
-  bucket_node *array = bucket_arrays_[1]->data();
-
-  int bucketArrayLen = (maximum_possible_gain_ << 1) | 0x1;
-
-  for (i = 0; i < bucketArrayLen; ++i) {
-    while (array[i].next != nullptr) {
-      b = array[i].next;
-#ifdef DEBUG_FM_REFINER
-      assert(b);
-#endif
-      array[i].next = b->next;
-
-      b->previous = nullptr;
-      b->next = nullptr;
-    }
-  }
-
-  number_of_buckets_in_array_[1] = 0;
+  buckets_[1].clear();
 }
 
 void fm_refiner::remove_buckets_from_0() {
-  int i;
-  bucket_node *b;
-
-  bucket_node *array = bucket_arrays_[0]->data();
-
-  int bucketArrayLen = (maximum_possible_gain_ << 1) | 0x1;
-
-  for (i = 0; i < bucketArrayLen; ++i) {
-    while (array[i].next != nullptr) {
-      b = array[i].next;
-#ifdef DEBUG_FM_REFINER
-      assert(b);
-#endif
-      array[i].next = b->next;
-
-      b->previous = nullptr;
-      b->next = nullptr;
-    }
-  }
-
-  number_of_buckets_in_array_[0] = 0;
+  buckets_[0].clear();
 }
 
 void fm_refiner::remove_unlocked_from_bucket_arrays() {
-  int i;
-  bucket_node *b;
-
-  for (i = 0; i < numVertices; ++i) {
-    if (!loaded_(i)) {
-      b = buckets_[i];
-
-#ifdef DEBUG_FM_REFINER
-      assert(b);
-      assert(b->prev != nullptr);
-#endif
-
-      b->previous->next = b->next;
-
-      if (b->next)
-        b->next->previous = b->previous;
-
-      b->previous = nullptr;
-      b->next = nullptr;
-    }
-  }
-
-  number_of_buckets_in_array_[0] = 0;
-  number_of_buckets_in_array_[1] = 0;
+  buckets_[0].clear();
+  buckets_[1].clear();
 }
 
 void fm_refiner::move_to_bucket_array(int vPart, int vGain, int v) {
@@ -359,156 +236,36 @@ void fm_refiner::move_to_bucket_array(int vPart, int vGain, int v) {
   assert(v >= 0 && v < numVertices);
 #endif
 
-  int arrayIndex = vGain + maximum_possible_gain_;
-
-  bucket_node *b = buckets_[v];
-  bucket_node *bucket;
-
   // ###
-  // first remove from bucket data_
+  // first remove from its bucket, then insert at the
+  // end of the new one given by the queue discipline,
+  // even if the gain did not change
   // ###
 
-  if (b->previous) {
-    b->previous->next = b->next;
+  ds::gain_bucket_queue &buckets = buckets_[vPart];
 
-    if (b->next) {
-      b->next->previous = b->previous;
-    }
+  if (buckets.contains(v)) {
+    buckets.remove(v);
   }
 
-  // ###
-  // now insert into appropriate slot
-  // ###
-
-  if (vGain > maximum_gains_[vPart]) {
-    maximum_gain_entries_[vPart] = arrayIndex;
-    maximum_gains_[vPart] = vGain;
-  }
-
-  bucket = &(*bucket_arrays_[vPart])[arrayIndex];
-
-  switch (insert_method_) {
-  case FIFO: {
-    while (bucket->next)
-      bucket = bucket->next;
-
-    bucket->next = b;
-    b->previous = bucket;
-    b->next = nullptr;
-
-    break;
-  }
-  case LIFO: {
-    b->next = bucket->next;
-    b->previous = bucket;
-    bucket->next = b;
-
-    if (b->next)
-      b->next->previous = b;
-
-    break;
-  }
-  default:
-    // ###
-    // LIFO
-    // ###
-    {
-      b->next = bucket->next;
-      b->previous = bucket;
-      bucket->next = b;
-
-      if (b->next)
-        b->next->previous = b;
-
-#ifdef DEBUG_FM_REFINER
-      assert(bucket->vertex_id == -1);
-      assert(bucket->next);
-#endif
-      break;
-    }
-  }
-
-  if (maximum_gains_[vPart] > vGain) {
-    int index = maximum_gain_entries_[vPart];
-
-    while ((*bucket_arrays_[vPart])[index].next == nullptr) {
-#ifdef DEBUG_FM_REFINER
-      assert(index >= 0);
-#endif
-      --index;
-    }
-
-    maximum_gain_entries_[vPart] = index;
-    maximum_gains_[vPart] = index - maximum_possible_gain_;
-
-#ifdef DEBUG_FM_REFINER
-    assert(index >= 0);
-    assert((*bucketArrays[vPart])[index].next);
-#endif
+  if (insert_method_ == FIFO) {
+    buckets.insert_back(v, vGain);
+  } else {
+    buckets.insert(v, vGain);
   }
 }
 
-void fm_refiner::remove_from_bucket_array(int v, int vPart, int vGain) {
+void fm_refiner::remove_from_bucket_array(int v, int vPart) {
 #ifdef DEBUG_FM_REFINER
   assert(vPart == 0 || vPart == 1);
   assert(v >= 0 && v < numVertices);
+  assert(buckets_[vPart].contains(v));
+  assert(buckets_[vPart].key(v) == vertex_gains_[v]);
 #endif
 
-  bucket_node *b = buckets_[v];
-
-#ifdef DEBUG_FM_REFINER
-  assert(b->prev);
-#endif
-
-  b->previous->next = b->next;
-
-  if (b->next)
-    b->next->previous = b->previous;
-
-  b->previous = nullptr;
-  b->next = nullptr;
-
-  --number_of_buckets_in_array_[vPart];
-
-#ifdef DEBUG_FM_REFINER
-  assert(numBucketsInArray[vPart] >= 0);
-#endif
-
-  if (maximum_gains_[vPart] == vGain) {
-    int index = vGain + maximum_possible_gain_;
-
-    while ((*bucket_arrays_[vPart])[index].next == nullptr && index > 0)
-      --index;
-
-    maximum_gain_entries_[vPart] = index;
-    maximum_gains_[vPart] = index - maximum_possible_gain_;
-
-#ifdef DEBUG_FM_REFINER
-    assert(index >= 0);
-#endif
-  }
+  buckets_[vPart].remove(v);
 }
 
-void fm_refiner::adjust_maximum_gain_pointer(int dP) {
-  if (number_of_buckets_in_array_[dP] > 0) {
-    int index = maximum_possible_gain_ << 1;
-
-    while ((*bucket_arrays_[dP])[index].next == nullptr) {
-#ifdef DEBUG_FM_REFINER
-      assert(index > 0);
-#endif
-      index--;
-    }
-
-    maximum_gain_entries_[dP] = index;
-    maximum_gains_[dP] = index - maximum_possible_gain_;
-
-#ifdef DEBUG_FM_REFINER
-    assert(index >= 0);
-    assert((*bucketArrays[dP])[index].next);
-#endif
-  }
-}
 
 void fm_refiner::update_gains(int v) {
 #ifdef DEBUG_FM_REFINER
@@ -893,15 +650,7 @@ int fm_refiner::fm_pass() {
 
       if (vGain <= 0)
         ++movesSincePosGain;
-
-#ifdef DEBUG_FM_REFINER
-      for (int ij = 0; ij < 2; ++ij)
-        if (numBucketsInArray[ij] > 0) {
-          int index = maxGainEntries[ij];
-          assert((*bucketArrays[ij])[index].next);
-        }
-#endif
-      remove_from_bucket_array(bestVertex, bestVertexDP, vGain);
+      remove_from_bucket_array(bestVertex, bestVertexDP);
       update_gains(bestVertex);
       loaded_.set(bestVertex);
       move_list_[numMoves++] = bestVertex;
@@ -951,7 +700,7 @@ int fm_refiner::rebalancing_pass(int largePart) {
       vertexGain = vertex_gains_[bestVertex];
       gain += vertexGain;
 
-      remove_from_bucket_array(bestVertex, 0x1, vertexGain);
+      remove_from_bucket_array(bestVertex, 0x1);
       update_gains_1_to_0(bestVertex);
     }
 
@@ -968,7 +717,7 @@ int fm_refiner::rebalancing_pass(int largePart) {
       vertexGain = vertex_gains_[bestVertex];
       gain += vertexGain;
 
-      remove_from_bucket_array(bestVertex, 0, vertexGain);
+      remove_from_bucket_array(bestVertex, 0);
       update_gains_0_to_1(bestVertex);
     }
 
@@ -984,63 +733,33 @@ int fm_refiner::choose_maximum_gain_vertex() {
   int _0to1Gain = -maximum_possible_gain_;
   int _1to0Gain = -maximum_possible_gain_;
 
-  int index;
   int v;
 
-  bucket *bucket;
-
-  if (number_of_buckets_in_array_[0] > 0) {
-    index = maximum_gain_entries_[0];
-
-#ifdef DEBUG_FM_REFINER
-    assert((*bucketArrays[0])[index].next);
-#endif
-
-    bucket = (*bucket_arrays_[0])[index].next;
-    v = bucket->vertex_id;
+  // ###
+  // only the highest gain bucket of each part is
+  // searched for a vertex that may move
+  // ###
 
-    while (part_weights_[1] + vWeight[v] > maximum_part_weight_) {
-      bucket = bucket->next;
+  if (!buckets_[0].empty()) {
+    v = buckets_[0].top();
 
-      if (!bucket)
-        break;
-      else
-        v = bucket->vertex_id;
-    }
+    while (v != -1 && part_weights_[1] + vWeight[v] > maximum_part_weight_)
+      v = buckets_[0].next(v);
 
-    if (bucket) {
-#ifdef DEBUG_FM_REFINER
-      assert(v != -1);
-#endif
-      _0to1Gain = maximum_gains_[0];
+    if (v != -1) {
+      _0to1Gain = buckets_[0].top_key();
       _0to1V = v;
     }
   }
 
-  if (number_of_buckets_in_array_[1] > 0) {
-    index = maximum_gain_entries_[1];
+  if (!buckets_[1].empty()) {
+    v = buckets_[1].top();
 
-#ifdef DEBUG_FM_REFINER
-    assert((*bucketArrays[1])[index].next);
-#endif
-
-    bucket = (*bucket_arrays_[1])[index].next;
-    v = bucket->vertex_id;
-
-    while (part_weights_[0] + vWeight[v] > maximum_part_weight_) {
-      bucket = bucket->next;
+    while (v != -1 && part_weights_[0] + vWeight[v] > maximum_part_weight_)
+      v = buckets_[1].next(v);
 
-      if (!bucket)
-        break;
-      else
-        v = bucket->vertex_id;
-    }
-
-    if (bucket) {
-#ifdef DEBUG_FM_REFINER
-      assert(v != -1);
-#endif
-      _1to0Gain = maximum_gains_[1];
+    if (v != -1) {
+      _1to0Gain = buckets_[1].top_key();
       _1to0V = v;
     }
   }
@@ -1069,86 +788,32 @@ int fm_refiner::choose_maximum_gain_vertex() {
 }
 
 int fm_refiner::choose_legal_move(int sP) {
-#ifdef DEBUG_FM_REFINER
-  assert(numBucketsInArray[sP] > 0);
-#endif
+  const ds::gain_bucket_queue &buckets = buckets_[sP];
+  int dP = sP ^ 0x1;
 
+  int gain;
   int v;
-  int index;
-
-  bucket *b;
-
-  if (sP & 0x1) {
-    index = maximum_gain_entries_[1];
-
-#ifdef DEBUG_FM_REFINER
-    assert((*bucketArrays[1])[index].next);
-#endif
-
-    b = (*bucket_arrays_[1])[index].next;
-    v = b->vertex_id;
-
-#ifdef DEBUG_FM_REFINER
-    assert(v >= 0 && v < numVertices);
-#endif
-
-    while (part_weights_[0] + vWeight[v] > maximum_part_weight_) {
-      b = b->next;
-
-      while (!b && index > 0) {
-        --index;
-#ifdef DEBUG_FM_REFINER
-        assert(index >= 0);
-#endif
-        b = (*bucket_arrays_[1])[index].next;
-      }
-
-      if (!b)
-        return -1;
 
-      v = b->vertex_id;
-
-#ifdef DEBUG_FM_REFINER
-      assert(v >= 0 && v < numVertices);
-#endif
-    }
-  } else {
-    index = maximum_gain_entries_[0];
-
-#ifdef DEBUG_FM_REFINER
-    assert((*bucketArrays[0])[index].next);
-#endif
-
-    b = (*bucket_arrays_[0])[index].next;
-    v = b->vertex_id;
-
-#ifdef DEBUG_FM_REFINER
-    assert(v >= 0 && v < numVertices);
-#endif
-
-    while (part_weights_[1] + vWeight[v] > maximum_part_weight_) {
-      b = b->next;
-
-      while (!b && index > 0) {
-        --index;
-#ifdef DEBUG_FM_REFINER
-        assert(index >= 0);
-#endif
-        b = (*bucket_arrays_[0])[index].next;
-      }
-
-      if (!b)
-        return -1;
+  // ###
+  // the highest gain vertex that fits in the other
+  // part, going down the non-empty buckets in turn
+  // ###
 
-      v = b->vertex_id;
+  if (buckets.empty())
+    return -1;
 
+  for (gain = buckets.top_key(); gain != ds::gain_bucket_queue::no_key;
+       gain = buckets.next_key_below(gain)) {
+    for (v = buckets.first(gain); v != -1; v = buckets.next(v)) {
 #ifdef DEBUG_FM_REFINER
       assert(v >= 0 && v < numVertices);
 #endif
+      if (part_weights_[dP] + vWeight[v] <= maximum_part_weight_)
+        return v;
     }
   }
 
-  return v;
+  return -1;
 }
 
 }  // namespace serial
@@ -7,6 +7,7 @@
 // 30/11/2004: Last Modified
 //
 // ###
+#include <algorithm>
 #include "refiners/serial/greedy_k_way_refiner.hpp"
 #include "utility/logging.hpp"
 
@@ -19,14 +20,13 @@ greedy_k_way_refiner::greedy_k_way_refiner(int max, int nparts, double ave,
   number_of_parts_ = nparts;
   average_part_weight_ = ave;
   limit_ = lim;
+  cache_gains_ = false;
   number_of_non_positive_moves_ = 0;
   part_weights_.resize(number_of_parts_);
 
   number_of_neighboring_parts_.resize(0);
   neighbors_of_vertex_.resize(0);
   neighbors_of_vertex_offsets_.resize(0);
-  hyperedge_vertices_in_part_.resize(0);
-  hyperedge_vertices_in_part_offsets_.resize(0);
   vertices_.resize(0);
   vertex_seen_.resize(0);
   seen_vertices_.resize(0);
@@ -40,7 +40,7 @@ greedy_k_way_refiner::greedy_k_way_refiner(int max, int nparts, double ave,
 greedy_k_way_refiner::~greedy_k_way_refiner() {}
 
 void greedy_k_way_refiner::display_options() const {
-  info("|- GKWAY: lim = %.2f\n|\n", limit_);
+  info("|- GKWAY: lim = %.2f cache = %d\n|\n", limit_, cache_gains_);
 }
 
 void greedy_k_way_refiner::build_data_structures() {
@@ -54,19 +54,11 @@ void greedy_k_way_refiner::build_data_structures() {
   neighbors_of_vertex_offsets_.resize(numVertices + 1);
   neighbors_of_vertex_.resize(numVertices * number_of_parts_);
 
-  hyperedge_vertices_in_part_offsets_.resize(numHedges + 1);
-  hyperedge_vertices_in_part_.resize(numHedges * number_of_parts_);
-
   neighbors_of_vertex_offsets_[0] = 0;
-  hyperedge_vertices_in_part_offsets_[0] = 0;
 
   for (i = 1; i <= numVertices; ++i)
     neighbors_of_vertex_offsets_[i] = neighbors_of_vertex_offsets_[i - 1] +
                                       number_of_parts_;
-
-  for (i = 1; i <= numHedges; ++i)
-    hyperedge_vertices_in_part_offsets_[i] = hyperedge_vertices_in_part_offsets_[i - 1] +
-                                             number_of_parts_;
 }
 
 void greedy_k_way_refiner::destroy_data_structures() {
@@ -78,8 +70,10 @@ void greedy_k_way_refiner::destroy_data_structures() {
   neighbors_of_vertex_offsets_.resize(0);
   neighbors_of_vertex_.resize(0);
 
-  hyperedge_vertices_in_part_offsets_.resize(0);
-  hyperedge_vertices_in_part_.resize(0);
+  hyperedge_vertices_in_part_.clear_and_shrink();
+  part_gains_.clear_and_shrink();
+  cached_gains_.clear_and_shrink();
+  cached_part_gains_.clear_and_shrink();
 }
 
 int greedy_k_way_refiner::initialize_data_structures() {
@@ -90,7 +84,6 @@ int greedy_k_way_refiner::initialize_data_structures() {
   int v;
   int endIndex;
   int vertOffset;
-  int partOffset;
   int numPartsSpanned;
   int vPart;
   int k_1cut = 0;
@@ -112,10 +105,16 @@ int greedy_k_way_refiner::initialize_data_structures() {
   for (i = 0; i < endIndex; ++i)
     neighbors_of_vertex_[i] = 0;
 
-  endIndex = hyperedge_vertices_in_part_offsets_[numHedges];
+  hyperedge_vertices_in_part_.reset(numHedges, number_of_parts_);
+  part_gains_.resize(hyperedge_vertices_in_part_.stride());
 
-  for (i = 0; i < endIndex; ++i)
-    hyperedge_vertices_in_part_[i] = 0;
+  if (cache_gains_) {
+    gains_cached_.reserve(numVertices);
+    gains_cached_.unset();
+    cached_gains_.resize(numVertices);
+    cached_part_gains_.resize(static_cast<long>(numVertices) *
+                              hyperedge_vertices_in_part_.stride());
+  }
 
   // ###
   // initialise the hyperedge structures
@@ -132,13 +131,10 @@ int greedy_k_way_refiner::initialize_data_structures() {
 
     for (j = hEdgeOffsets[i]; j < endIndex; ++j) {
       vPart = partition_vector_[pinList[j]];
-      partOffset = hyperedge_vertices_in_part_offsets_[i] + vPart;
 
-      if (hyperedge_vertices_in_part_[partOffset] == 0) {
+      if (hyperedge_vertices_in_part_.add(i, vPart) == 1) {
         parts_spanned_[numPartsSpanned++] = vPart;
       }
-
-      ++hyperedge_vertices_in_part_[partOffset];
     }
 
     // ###
@@ -214,7 +210,7 @@ void greedy_k_way_refiner::update_adjacent_vertex_stats(int v, int sP,
           for (i = vOffsets[vert]; i < othVOffset; ++i) {
             othHedge = vToHedges[i];
 
-            if (hyperedge_vertices_in_part_[hyperedge_vertices_in_part_offsets_[othHedge] + sP] > 0) {
+            if (!hyperedge_vertices_in_part_.empty(othHedge, sP)) {
               neighbors_of_vertex_[neighOfVOffset + sP] = 1;
               break;
             }
@@ -224,6 +220,9 @@ void greedy_k_way_refiner::update_adjacent_vertex_stats(int v, int sP,
             --number_of_neighboring_parts_[vert];
         }
 
+        if (cache_gains_)
+          gains_cached_.unset(vert);
+
         vertex_seen_[vert] = 1;
         seen_vertices_[numVerticesSeen] = vert;
         ++numVerticesSeen;
@@ -239,6 +238,84 @@ void greedy_k_way_refiner::update_adjacent_vertex_stats(int v, int sP,
     vertex_seen_[seen_vertices_[j]] = -1;
 }
 
+int greedy_k_way_refiner::move_gain(int v, int sP, int to) const {
+  int hEdge;
+  int posGain = 0;
+  int vertOffset = vOffsets[v + 1];
+
+  for (int ij = vOffsets[v]; ij < vertOffset; ++ij) {
+    hEdge = vToHedges[ij];
+
+    if (hyperedge_vertices_in_part_.single(hEdge, sP))
+      posGain += hEdgeWeight[hEdge];
+
+    if (hyperedge_vertices_in_part_.empty(hEdge, to))
+      posGain -= hEdgeWeight[hEdge];
+  }
+
+  return posGain;
+}
+
+int greedy_k_way_refiner::sweep_gains(int v, int sP, int *gains) {
+  // ###
+  // computes the gain of moving v out of sP into every part
+  // at once. The gain of the move to part p is the returned
+  // value plus gains[p]: moving to a part costs the weight
+  // of every hyperedge with no pins there, i.e. the total
+  // weight less the weight of those present
+  // ###
+
+  int hEdge;
+  int gainFromSP = 0;
+  int vertOffset = vOffsets[v + 1];
+
+  std::fill(gains, gains + hyperedge_vertices_in_part_.stride(), 0);
+
+  for (int ij = vOffsets[v]; ij < vertOffset; ++ij) {
+    hEdge = vToHedges[ij];
+
+    if (hyperedge_vertices_in_part_.single(hEdge, sP))
+      gainFromSP += hEdgeWeight[hEdge];
+
+    gainFromSP -= hEdgeWeight[hEdge];
+    hyperedge_vertices_in_part_.add_where_present(hEdge, hEdgeWeight[hEdge],
+                                                  gains);
+  }
+
+  return gainFromSP;
+}
+
+const int *greedy_k_way_refiner::cached_sweep_gains(int v, int sP,
+                                                    int &gainFromSP) {
+  // ###
+  // as sweep_gains, but only sweeps v's hyperedges if one of
+  // them has changed since v's gains were last computed
+  // ###
+
+  int *gains = cached_part_gains_.data() +
+               static_cast<long>(v) * hyperedge_vertices_in_part_.stride();
+
+  if (!gains_cached_(v)) {
+    cached_gains_[v] = sweep_gains(v, sP, gains);
+    gains_cached_.set(v);
+  }
+
+  gainFromSP = cached_gains_[v];
+  return gains;
+}
+
+bool greedy_k_way_refiner::use_sweep(int candidates) const {
+  // ###
+  // sweeping a hyperedge's row costs about as much as
+  // testing six candidate parts one at a time for every
+  // SIMD width of parts in the row
+  // ###
+
+  int stride = hyperedge_vertices_in_part_.stride();
+  return stride >= ds::part_pin_counts::simd_width &&
+         candidates * ds::part_pin_counts::simd_width >= 6 * stride;
+}
+
 void greedy_k_way_refiner::refine(serial::hypergraph &h) {
   int totalGain = 0;
   int gain;
@@ -299,7 +376,6 @@ void greedy_k_way_refiner::rebalance(serial::hypergraph &h) {
 int greedy_k_way_refiner::greedy_pass() {
   int i;
   int j;
-  int ij;
   int v;
   int sP;
   int gain;
@@ -311,10 +387,13 @@ int greedy_k_way_refiner::greedy_pass() {
   int vertexWt;
   int vertOffset;
   int vNeighOffset;
-  int hEdgeOffset;
   int neighOfVOffset;
+  int sweepGain = 0;
   int numNonPos = 0;
 
+  bool sweep;
+  const int *partGains = part_gains_.data();
+
   double currImbalance = 0;
   double bestImbalance;
   double posImbalance;
@@ -342,22 +421,23 @@ int greedy_k_way_refiner::greedy_pass() {
     if (number_of_neighboring_parts_[v] > 1) {
       vNeighOffset = neighbors_of_vertex_offsets_[v];
 
+      if (cache_gains_) {
+        sweep = true;
+        partGains = cached_sweep_gains(v, sP, sweepGain);
+      } else {
+        sweep = use_sweep(number_of_neighboring_parts_[v] - 1);
+
+        if (sweep)
+          sweepGain = sweep_gains(v, sP, part_gains_.data());
+      }
+
       for (j = 0; j < number_of_parts_; ++j) {
         if (j != sP && neighbors_of_vertex_[vNeighOffset + j] > 0) {
           if (part_weights_[j] + vertexWt <= maximum_part_weight_) {
-            posGain = 0;
-            vertOffset = vOffsets[v + 1];
-
-            for (ij = vOffsets[v]; ij < vertOffset; ++ij) {
-              hEdge = vToHedges[ij];
-              hEdgeOffset = hyperedge_vertices_in_part_offsets_[hEdge];
-
-              if (hyperedge_vertices_in_part_[hEdgeOffset + sP] == 1)
-                posGain += hEdgeWeight[hEdge];
-
-              if (hyperedge_vertices_in_part_[hEdgeOffset + j] == 0)
-                posGain -= hEdgeWeight[hEdge];
-            }
+            if (sweep)
+              posGain = sweepGain + partGains[j];
+            else
+              posGain = move_gain(v, sP, j);
 
             posImbalance =
                 currImbalance + fabs(part_weights_[sP] - (vertexWt +
@@ -392,18 +472,19 @@ int greedy_k_way_refiner::greedy_pass() {
         neighbors_of_vertex_[neighOfVOffset + bestMove] = 1;
         neighbors_of_vertex_[neighOfVOffset + sP] = 0;
 
+        if (cache_gains_)
+          gains_cached_.unset(v);
+
         for (j = vOffsets[v]; j < vertOffset; ++j) {
           // ###
           // update the hyperedge stats: (vInPart etc.)
           // ###
 
           hEdge = vToHedges[j];
-          hEdgeOffset = hyperedge_vertices_in_part_offsets_[hEdge];
 
-          --hyperedge_vertices_in_part_[hEdgeOffset + sP];
-          ++hyperedge_vertices_in_part_[hEdgeOffset + bestMove];
+          hyperedge_vertices_in_part_.add(hEdge, bestMove);
 
-          if (hyperedge_vertices_in_part_[hEdgeOffset + sP] > 0)
+          if (hyperedge_vertices_in_part_.remove(hEdge, sP) > 0)
             neighbors_of_vertex_[neighOfVOffset + sP] = 1;
         }
 
@@ -453,7 +534,6 @@ int greedy_k_way_refiner::greedy_pass() {
 
 int greedy_k_way_refiner::rebalancing_pass() {
   int i;
-  int j;
 
   int part;
   int numOverWeight = 0;
@@ -481,8 +561,11 @@ int greedy_k_way_refiner::rebalancing_pass() {
   int bestMove;
   int vertexWt;
   int vertOffset;
-  int hEdgeOffset;
   int neighOfVOffset;
+  int sweepGain = 0;
+
+  bool sweep;
+  const int *partGains = part_gains_.data();
 
   VNodePtr nodePtr;
 
@@ -530,22 +613,23 @@ int greedy_k_way_refiner::rebalancing_pass() {
     assert(partitionVector[vertex] == part);
 #endif
 
+    if (cache_gains_) {
+      sweep = true;
+      partGains = cached_sweep_gains(vertex, part, sweepGain);
+    } else {
+      sweep = use_sweep(number_of_parts_ - numOverWeight);
+
+      if (sweep)
+        sweepGain = sweep_gains(vertex, part, part_gains_.data());
+    }
+
     for (i = 0; i < number_of_parts_; ++i) {
       if (i != part && overWeight[i] == 0) {
         if (part_weights_[i] + vertexWt <= maximum_part_weight_) {
-          posGain = 0;
-          vertOffset = vOffsets[vertex + 1];
-
-          for (j = vOffsets[vertex]; j < vertOffset; ++j) {
-            hEdge = vToHedges[j];
-            hEdgeOffset = hyperedge_vertices_in_part_offsets_[hEdge];
-
-            if (hyperedge_vertices_in_part_[hEdgeOffset + part] == 1)
-              posGain += hEdgeWeight[hEdge];
-
-            if (hyperedge_vertices_in_part_[hEdgeOffset + i] == 0)
-              posGain -= hEdgeWeight[hEdge];
-          }
+          if (sweep)
+            posGain = sweepGain + partGains[i];
+          else
+            posGain = move_gain(vertex, part, i);
 
           if (posGain > vGain) {
             vGain = posGain;
@@ -572,18 +656,19 @@ int greedy_k_way_refiner::rebalancing_pass() {
     neighbors_of_vertex_[neighOfVOffset + bestMove] = 1;
     neighbors_of_vertex_[neighOfVOffset + part] = 0;
 
+    if (cache_gains_)
+      gains_cached_.unset(vertex);
+
     for (i = vOffsets[vertex]; i < vertOffset; ++i) {
       // ###
       // update the hyperedge stats: (vInPart etc.)
       // ###
 
       hEdge = vToHedges[i];
-      hEdgeOffset = hyperedge_vertices_in_part_offsets_[hEdge];
 
-      --hyperedge_vertices_in_part_[hEdgeOffset + part];
-      ++hyperedge_vertices_in_part_[hEdgeOffset + bestMove];
+      hyperedge_vertices_in_part_.add(hEdge, bestMove);
 
-      if (hyperedge_vertices_in_part_[hEdgeOffset + part] > 0)
+      if (hyperedge_vertices_in_part_.remove(hEdge, part) > 0)
         neighbors_of_vertex_[neighOfVOffset + part] = 1;
     }
 
@@ -35,9 +35,13 @@ parallel::coarsener *build_parallel_coarsener(
   int num_parts = options.get<int>("number-of-parts");
   parallel::coarsener *c = nullptr;
   if (options.get<std::string>("coarsening.type") == "first-choice") {
-    c = new parallel::first_choice_coarsener(
-        rank, num_proc, num_parts, vertexVisitOrder, matchReqVisitOrder,
-        divByCluWt, divByHedgeLen);
+    parallel::first_choice_coarsener *fc =
+        new parallel::first_choice_coarsener(
+            rank, num_proc, num_parts, vertexVisitOrder, matchReqVisitOrder,
+            divByCluWt, divByHedgeLen);
+    fc->set_match_request_batch(
+        options.get<int>("coarsening.match-request-batch"));
+    c = fc;
   } else if (options.get<std::string>("coarsening.type") == "model-2d") {
     c = new parallel::model_coarsener_2d(
         rank, num_proc, num_parts, vertexVisitOrder, matchReqVisitOrder,
@@ -51,6 +55,10 @@ parallel::coarsener *build_parallel_coarsener(
     c->set_minimum_number_of_nodes(min_nodes * num_parts);
     c->set_balance_constraint(constraint);
     c->set_reduction_ratio(reduction_ratio);
+    c->set_summary_pins(options.get<int>("coarsening.summary-pins"));
+    c->set_threads(options.get<int>("coarsening.threads"));
+    c->set_communication_budget(
+        options.get<long>("coarsening.communication-budget"));
     c->build_auxiliary_structures(numTotPins, aveVertDeg, aveHedgeSize);
     c->display_options();
   }
@@ -90,6 +98,8 @@ parallel::restrictive_coarsening *build_parallel_restrictive_coarsener(
     c->set_minimum_nodes(min_nodes * num_parts);
     c->set_balance_constraint(constraint);
     c->set_reduction_ratio(reduction_ratio);
+    c->set_communication_budget(
+        options.get<long>("coarsening.communication-budget"));
     c->display_options();
   }
 
@@ -110,10 +120,14 @@ parallel::refiner *build_parallel_refiner(
   int earlyExit = options.get<bool>("refinement.enable-early-exit") ||
                   options.get<bool>("refinement.limit-by-length");
 
+  int threads = options.get<int>("refinement.threads");
+  bool gainOrdered = options.get<bool>("refinement.gain-ordered");
+
   int num_proc = options.number_of_processors();
   int num_parts = options.get<int>("number-of-parts");
   parallel::refiner *r = new parallel::k_way_greedy_refiner(
-      rank, num_proc, num_parts, numTotPins / num_proc, earlyExit, eeLimit);
+      rank, num_proc, num_parts, numTotPins / num_proc, earlyExit, eeLimit,
+      threads, gainOrdered);
 
   if (r) {
     r->set_balance_constraint(options.get<double>("balance-constraint"));
@@ -147,33 +161,45 @@ serial::controller *build_sequential_controller(
     int minSeqNodes = MIN_VERT_MULTIPLIER;
     double bRedRatio = DEF_BIS_RATIO;
 
-    serial::bisection_controller *bC = nullptr;
-    if (v_cycle == "all") {
-      bC = new serial::v_cycle_all(
-          numBisectRuns, keepT, redFactor, eeParam, startPercentile, inc);
-      bC->build_coarsener(options);
-    } else if (v_cycle == "final-only") {
-      bC = new serial::v_cycle_final(
-          numBisectRuns, keepT, redFactor, eeParam, startPercentile, inc);
-      bC->build_coarsener(options);
-    } else {
-      startPercentile = 90;
-      bC = new serial::bisection_controller(
-          numBisectRuns, keepT, redFactor, eeParam, startPercentile, inc);
-      bC->build_coarsener(options);
-    }
-
-    // ###
-    // build the seq initial partitioner
-    // ###
     int numInitRuns = options.get<int>(
         "recursive-bisection.number-of-initial-partitioning-runs");
-    bC->build_initial_bisector(numInitRuns);
+    int numThreads = options.get<int>("recursive-bisection.threads");
+
+    if (v_cycle != "all" && v_cycle != "final-only")
+      startPercentile = 90;
+
+    auto build_bisector = [&]() {
+      serial::bisection_controller *b = nullptr;
+      if (v_cycle == "all") {
+        b = new serial::v_cycle_all(
+            numBisectRuns, keepT, redFactor, eeParam, startPercentile, inc);
+      } else if (v_cycle == "final-only") {
+        b = new serial::v_cycle_final(
+            numBisectRuns, keepT, redFactor, eeParam, startPercentile, inc);
+      } else {
+        b = new serial::bisection_controller(
+            numBisectRuns, keepT, redFactor, eeParam, startPercentile, inc);
+      }
+      b->build_coarsener(options);
+
+      // ###
+      // build the seq initial partitioner
+      // ###
+      b->build_initial_bisector(numInitRuns);
+
+      // ###
+      // build the seq refiner (FM refiner)
+      // ###
+      b->build_refiner(LIFO);
+      return b;
+    };
 
     // ###
-    // build the seq refiner (FM refiner)
+    // each extra thread gets its own bisector
     // ###
-    bC->build_refiner(LIFO);
+    serial::bisection_controller *bC = build_bisector();
+    for (int t = 1; t < numThreads; ++t)
+      bC->add_worker(build_bisector());
 
     // ###
     // build the seq GreedyKwayRefiner
@@ -181,6 +207,8 @@ serial::controller *build_sequential_controller(
     double kWayLimit = DEF_SEQ_KWAY_LIM;
     serial::greedy_k_way_refiner *k =
         new serial::greedy_k_way_refiner(-1, num_parts, -1, kWayLimit);
+    k->set_cache_gains(
+        options.get<bool>("serial-partitioning.cache-k-way-gains"));
 
     // ###
     // build the seq controller
@@ -188,12 +216,18 @@ serial::controller *build_sequential_controller(
     double paraKeepT = DEF_KEEP_THRESHOLD;
     int num_proc = options.number_of_processors();
     int num_parts = options.get<int>("number-of-parts");
-    seqC = new recursive_bisection_contoller(bC, k, rank, num_proc,
-                                             num_parts, numBisectRuns);
+    recursive_bisection_contoller *rbC = new recursive_bisection_contoller(
+        bC, k, rank, num_proc, num_parts, numBisectRuns);
+    rbC->set_work_stealing(
+        options.get<bool>("recursive-bisection.work-stealing"));
+    seqC = rbC;
 
     seqC->set_accept_proportion(paraKeepT);
     seqC->set_number_of_runs(numSeqRuns);
     seqC->set_k_way_constraint(options.get<double>("balance-constraint"));
+    seqC->set_replicas(options.get<int>("serial-partitioning.replicas"));
+    seqC->set_shared_replica(
+        options.get<bool>("serial-partitioning.shared-replica"));
   }
 
 #ifdef PARKWAY_LINK_HMETIS
@@ -0,0 +1,82 @@
+#include "utility/thread_pool.hpp"
+
+namespace parkway {
+namespace utility {
+
+thread_pool::thread_pool(int threads)
+    : work_(nullptr),
+      tasks_(0),
+      next_task_(0),
+      busy_workers_(0),
+      generation_(0),
+      stopping_(false) {
+  for (int i = 1; i < threads; ++i) {
+    workers_.emplace_back(&thread_pool::work_loop, this, i);
+  }
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void thread_pool::run(int tasks, const work_type &work) {
+  if (workers_.empty() || tasks <= 1) {
+    for (int i = 0; i < tasks; ++i) {
+      work(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    work_ = &work;
+    tasks_ = tasks;
+    next_task_ = 0;
+    busy_workers_ = static_cast<int>(workers_.size());
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  take_tasks(0);
+
+  std::unique_lock<std::mutex> guard(lock_);
+  finished_.wait(guard, [this] { return busy_workers_ == 0; });
+  work_ = nullptr;
+}
+
+void thread_pool::work_loop(int thread) {
+  unsigned long seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      wake_.wait(guard, [&] { return stopping_ || generation_ != seen; });
+      if (stopping_) {
+        return;
+      }
+      seen = generation_;
+    }
+
+    take_tasks(thread);
+
+    std::lock_guard<std::mutex> guard(lock_);
+    if (--busy_workers_ == 0) {
+      finished_.notify_one();
+    }
+  }
+}
+
+void thread_pool::take_tasks(int thread) {
+  for (int task = next_task_++; task < tasks_; task = next_task_++) {
+    (*work_)(task, thread);
+  }
+}
+
+}  // namespace utility
+}  // namespace parkway
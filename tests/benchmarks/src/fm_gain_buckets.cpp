@@ -0,0 +1,295 @@
+// Compares the FM refiner's gain buckets, now two gain_bucket_queues, against
+// the previous pointer-linked bucket_node arrays, whose highest non-empty
+// bucket was found by scanning down from the last maximum.
+//
+// A synthetic FM pass is replayed on both: vertices with random weights and
+// gains are bucketed by part, then the highest gain vertex that keeps the
+// bisection balanced is moved repeatedly, as choose_maximum_gain_vertex does,
+// and the gains of its free neighbours are changed and the neighbours
+// rebucketed. Gains are spread over the full range so that emptying the top
+// bucket is followed by a long scan in the linked arrays. Both structures
+// must pick the same vertices.
+//
+// Usage: parkway_benchmark_fm_gain_buckets [vertices] [max gain] [degree]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "data_structures/gain_bucket_queue.hpp"
+
+namespace {
+
+namespace ds = parkway::data_structures;
+
+struct workload {
+  int max_gain;
+  int max_part_weight;
+  std::vector<int> weights;
+  std::vector<int> parts;
+  std::vector<int> gains;
+  std::vector<std::vector<int> > neighbours;
+  std::vector<std::vector<int> > deltas;
+};
+
+workload generate(int vertices, int max_gain, int degree) {
+  std::mt19937 generator(117);
+  std::uniform_int_distribution<int> vertex(0, vertices - 1);
+  std::uniform_int_distribution<int> gain(-max_gain, max_gain);
+  std::uniform_int_distribution<int> weight(1, 4);
+  std::uniform_int_distribution<int> delta(-max_gain / 8, max_gain / 8);
+
+  workload w;
+  w.max_gain = max_gain;
+  w.weights.resize(vertices);
+  w.parts.resize(vertices);
+  w.gains.resize(vertices);
+  w.neighbours.resize(vertices);
+  w.deltas.resize(vertices);
+
+  long total = 0;
+  for (int v = 0; v < vertices; ++v) {
+    w.weights[v] = weight(generator);
+    w.parts[v] = v & 1;
+    w.gains[v] = gain(generator);
+    total += w.weights[v];
+    for (int i = 0; i < degree; ++i) {
+      w.neighbours[v].push_back(vertex(generator));
+      w.deltas[v].push_back(delta(generator));
+    }
+  }
+  w.max_part_weight = static_cast<int>(total / 2 + total / 100);
+  return w;
+}
+
+// The previous buckets, as kept by fm_refiner in LIFO mode.
+class legacy_buckets {
+ public:
+  struct node {
+    int vertex_id;
+    node *previous;
+    node *next;
+  };
+
+  legacy_buckets(int vertices, int max_gain)
+      : max_gain_(max_gain), nodes_(vertices) {
+    for (int i = 0; i < vertices; ++i) {
+      nodes_[i].vertex_id = i;
+      nodes_[i].previous = nullptr;
+      nodes_[i].next = nullptr;
+    }
+    for (int p = 0; p < 2; ++p) {
+      arrays_[p].assign(2 * max_gain + 1, node{-1, nullptr, nullptr});
+      maximum_gains_[p] = -max_gain;
+      maximum_entries_[p] = 0;
+      sizes_[p] = 0;
+    }
+  }
+
+  bool empty(int part) const {
+    return sizes_[part] == 0;
+  }
+
+  void insert(int part, int gain, int v) {
+    move(part, gain, v);
+    ++sizes_[part];
+  }
+
+  void move(int part, int gain, int v) {
+    int index = gain + max_gain_;
+    node *b = &nodes_[v];
+
+    if (b->previous) {
+      b->previous->next = b->next;
+      if (b->next) {
+        b->next->previous = b->previous;
+      }
+    }
+
+    if (gain > maximum_gains_[part]) {
+      maximum_entries_[part] = index;
+      maximum_gains_[part] = gain;
+    }
+
+    node *bucket = &arrays_[part][index];
+    b->next = bucket->next;
+    b->previous = bucket;
+    bucket->next = b;
+    if (b->next) {
+      b->next->previous = b;
+    }
+
+    if (maximum_gains_[part] > gain) {
+      int i = maximum_entries_[part];
+      while (arrays_[part][i].next == nullptr) {
+        --i;
+      }
+      maximum_entries_[part] = i;
+      maximum_gains_[part] = i - max_gain_;
+    }
+  }
+
+  void remove(int part, int gain, int v) {
+    node *b = &nodes_[v];
+    b->previous->next = b->next;
+    if (b->next) {
+      b->next->previous = b->previous;
+    }
+    b->previous = nullptr;
+    b->next = nullptr;
+    --sizes_[part];
+
+    if (maximum_gains_[part] == gain) {
+      int i = gain + max_gain_;
+      while (arrays_[part][i].next == nullptr && i > 0) {
+        --i;
+      }
+      maximum_entries_[part] = i;
+      maximum_gains_[part] = i - max_gain_;
+    }
+  }
+
+  // The first vertex of the highest bucket that 'fits', or -1.
+  template <typename Fits> int choose(int part, int &gain, Fits fits) const {
+    node *b = arrays_[part][maximum_entries_[part]].next;
+    while (b && !fits(b->vertex_id)) {
+      b = b->next;
+    }
+    gain = maximum_gains_[part];
+    return b ? b->vertex_id : -1;
+  }
+
+ private:
+  int max_gain_;
+  std::vector<node> nodes_;
+  std::vector<node> arrays_[2];
+  int maximum_gains_[2];
+  int maximum_entries_[2];
+  int sizes_[2];
+};
+
+class queue_buckets {
+ public:
+  queue_buckets(int vertices, int max_gain) {
+    queues_[0].reset(vertices, max_gain);
+    queues_[1].reset(vertices, max_gain);
+  }
+
+  bool empty(int part) const {
+    return queues_[part].empty();
+  }
+
+  void insert(int part, int gain, int v) {
+    queues_[part].insert(v, gain);
+  }
+
+  void move(int part, int gain, int v) {
+    queues_[part].remove(v);
+    queues_[part].insert(v, gain);
+  }
+
+  void remove(int part, int, int v) {
+    queues_[part].remove(v);
+  }
+
+  template <typename Fits> int choose(int part, int &gain, Fits fits) const {
+    int v = queues_[part].top();
+    while (v != -1 && !fits(v)) {
+      v = queues_[part].next(v);
+    }
+    gain = queues_[part].top_key();
+    return v;
+  }
+
+ private:
+  ds::gain_bucket_queue queues_[2];
+};
+
+// Replays the pass and returns a checksum of the vertices moved.
+template <typename Buckets> unsigned long replay(const workload &w, double &ms) {
+  int vertices = static_cast<int>(w.weights.size());
+  std::vector<int> gains = w.gains;
+  std::vector<int> parts = w.parts;
+  std::vector<char> locked(vertices, 0);
+  long part_weights[2] = {0, 0};
+  unsigned long checksum = 0;
+
+  for (int v = 0; v < vertices; ++v) {
+    part_weights[parts[v]] += w.weights[v];
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  Buckets buckets(vertices, w.max_gain);
+
+  for (int v = 0; v < vertices; ++v) {
+    buckets.insert(parts[v], gains[v], v);
+  }
+
+  for (int moves = 0; moves < vertices; ++moves) {
+    int best = -1;
+    int best_gain = -w.max_gain - 1;
+
+    for (int p = 0; p < 2; ++p) {
+      if (buckets.empty(p)) {
+        continue;
+      }
+      long to = part_weights[p ^ 1];
+      int gain;
+      int v = buckets.choose(p, gain, [&](int u) {
+        return to + w.weights[u] <= w.max_part_weight;
+      });
+      if (v != -1 && gain > best_gain) {
+        best = v;
+        best_gain = gain;
+      }
+    }
+
+    if (best == -1) {
+      break;
+    }
+
+    int from = parts[best];
+    buckets.remove(from, gains[best], best);
+    locked[best] = 1;
+    parts[best] = from ^ 1;
+    part_weights[from] -= w.weights[best];
+    part_weights[from ^ 1] += w.weights[best];
+    checksum = checksum * 31 + best;
+
+    for (std::size_t i = 0; i < w.neighbours[best].size(); ++i) {
+      int u = w.neighbours[best][i];
+      if (locked[u]) {
+        continue;
+      }
+      gains[u] = std::max(-w.max_gain,
+                          std::min(w.max_gain, gains[u] + w.deltas[best][i]));
+      buckets.move(parts[u], gains[u], u);
+    }
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  ms = std::chrono::duration<double, std::milli>(end - start).count();
+  return checksum;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int vertices = argc > 1 ? std::atoi(argv[1]) : 200000;
+  int max_gain = argc > 2 ? std::atoi(argv[2]) : 20000;
+  int degree = argc > 3 ? std::atoi(argv[3]) : 8;
+
+  workload w = generate(vertices, max_gain, degree);
+
+  std::printf("%d vertices, gains in [-%d, %d], %d neighbours per move\n\n",
+              vertices, max_gain, max_gain, degree);
+  std::printf("%-16s %12s %20s\n", "buckets", "pass (ms)", "checksum");
+
+  double ms;
+  unsigned long checksum = replay<legacy_buckets>(w, ms);
+  std::printf("%-16s %12.2f %20lu\n", "legacy linked", ms, checksum);
+  checksum = replay<queue_buckets>(w, ms);
+  std::printf("%-16s %12.2f %20lu\n", "flat + bitmap", ms, checksum);
+  return 0;
+}
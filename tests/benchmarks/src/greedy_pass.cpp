@@ -0,0 +1,234 @@
+// Times the gain computation at the heart of k_way_greedy_refiner::greedy_pass
+// with the refiner's arrays held in dynamic_array, as they used to be, in
+// buffer/span, and with the per-hyperedge part counts in part_pin_counts, as
+// they are now.
+//
+// For every vertex of a synthetic hypergraph, and each of 'candidates' parts
+// the vertex could move to, the gain of the move is summed over the vertex's
+// hyperedges from the per-hyperedge part counts. The int array loop is
+// identical for every array type; any difference comes from dynamic_array's
+// bounds check and grow in operator[] and from its extra indirection. The
+// part_pin_counts rows compute the same gains from the byte counts, either one
+// candidate at a time or for all parts in one sweep of each hyperedge's row.
+//
+// Usage: parkway_benchmark_greedy_pass [vertices] [parts] [passes] [candidates]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "data_structures/buffer.hpp"
+#include "data_structures/dynamic_array.hpp"
+#include "data_structures/part_pin_counts.hpp"
+
+namespace ds = parkway::data_structures;
+
+namespace {
+
+struct instance {
+  int vertices;
+  int hyperedges;
+  int parts;
+  int candidates;
+  std::vector<int> vertex_to_hyperedges_offset;
+  std::vector<int> vertex_to_hyperedges;
+  std::vector<int> hyperedge_weights;
+  std::vector<int> hyperedge_vertices_in_part;
+  std::vector<int> partition;
+};
+
+instance generate(int vertices, int parts, int candidates) {
+  std::mt19937 generator(117);
+  std::uniform_int_distribution<int> part(0, parts - 1);
+  std::uniform_int_distribution<int> degree(1, 8);
+  std::uniform_int_distribution<int> weight(1, 4);
+
+  instance g;
+  g.vertices = vertices;
+  g.hyperedges = vertices;
+  g.parts = parts;
+  g.candidates = candidates;
+  std::uniform_int_distribution<int> hyperedge(0, g.hyperedges - 1);
+
+  g.partition.resize(vertices);
+  g.vertex_to_hyperedges_offset.push_back(0);
+  g.hyperedge_vertices_in_part.assign(g.hyperedges * parts, 0);
+  for (int v = 0; v < vertices; ++v) {
+    g.partition[v] = part(generator);
+    int d = degree(generator);
+    for (int i = 0; i < d; ++i) {
+      int e = hyperedge(generator);
+      g.vertex_to_hyperedges.push_back(e);
+      ++g.hyperedge_vertices_in_part[e * parts + g.partition[v]];
+    }
+    g.vertex_to_hyperedges_offset.push_back(g.vertex_to_hyperedges.size());
+  }
+
+  g.hyperedge_weights.resize(g.hyperedges);
+  for (auto &w : g.hyperedge_weights) {
+    w = weight(generator);
+  }
+  return g;
+}
+
+template <typename Array>
+long long gains(const instance &g, Array &offsets, Array &incidence,
+                Array &weights, Array &in_part, Array &partition) {
+  long long total = 0;
+  for (int v = 0; v < g.vertices; ++v) {
+    int from = partition[v];
+    for (int c = 1; c <= g.candidates; ++c) {
+      int to = (from + c) % g.parts;
+      int gain = 0;
+      int end = offsets[v + 1];
+      for (int i = offsets[v]; i < end; ++i) {
+        int e = incidence[i];
+        int offset = e * g.parts;
+        if (in_part[offset + from] == 1) {
+          gain += weights[e];
+        }
+        if (in_part[offset + to] == 0) {
+          gain -= weights[e];
+        }
+      }
+      total += gain;
+    }
+  }
+  return total;
+}
+
+long long pin_count_gains(const instance &g,
+                          const ds::part_pin_counts &in_part, bool sweep,
+                          int *part_gains) {
+  const int *offsets = g.vertex_to_hyperedges_offset.data();
+  const int *incidence = g.vertex_to_hyperedges.data();
+  const int *weights = g.hyperedge_weights.data();
+
+  long long total = 0;
+  for (int v = 0; v < g.vertices; ++v) {
+    int from = g.partition[v];
+    int end = offsets[v + 1];
+
+    if (sweep) {
+      int from_gain = 0;
+      std::fill(part_gains, part_gains + in_part.stride(), 0);
+      for (int i = offsets[v]; i < end; ++i) {
+        int e = incidence[i];
+        if (in_part.single(e, from)) {
+          from_gain += weights[e];
+        }
+        from_gain -= weights[e];
+        in_part.add_where_present(e, weights[e], part_gains);
+      }
+      for (int c = 1; c <= g.candidates; ++c) {
+        total += from_gain + part_gains[(from + c) % g.parts];
+      }
+      continue;
+    }
+
+    for (int c = 1; c <= g.candidates; ++c) {
+      int to = (from + c) % g.parts;
+      int gain = 0;
+      for (int i = offsets[v]; i < end; ++i) {
+        int e = incidence[i];
+        if (in_part.single(e, from)) {
+          gain += weights[e];
+        }
+        if (in_part.empty(e, to)) {
+          gain -= weights[e];
+        }
+      }
+      total += gain;
+    }
+  }
+  return total;
+}
+
+template <typename Array>
+Array copy_into(const std::vector<int> &values) {
+  Array array(values.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    array[i] = values[i];
+  }
+  return array;
+}
+
+template <typename Array, typename View>
+void run(const char *name, const instance &g, int passes, View view) {
+  Array offsets = copy_into<Array>(g.vertex_to_hyperedges_offset);
+  Array incidence = copy_into<Array>(g.vertex_to_hyperedges);
+  Array weights = copy_into<Array>(g.hyperedge_weights);
+  Array in_part = copy_into<Array>(g.hyperedge_vertices_in_part);
+  Array partition = copy_into<Array>(g.partition);
+
+  auto &&o = view(offsets);
+  auto &&i = view(incidence);
+  auto &&w = view(weights);
+  auto &&p = view(in_part);
+  auto &&v = view(partition);
+
+  long long check = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; ++pass) {
+    check += gains(g, o, i, w, p, v);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  std::printf("%-14s %12.3f %16.1f %16lld\n", name, seconds * 1e3 / passes,
+              g.vertices * g.candidates / (seconds / passes) / 1e6, check);
+}
+
+void run_pin_counts(const char *name, const instance &g, int passes,
+                    bool sweep) {
+  ds::part_pin_counts in_part;
+  in_part.reset(g.hyperedges, g.parts);
+  for (int v = 0; v < g.vertices; ++v) {
+    for (int i = g.vertex_to_hyperedges_offset[v];
+         i < g.vertex_to_hyperedges_offset[v + 1]; ++i) {
+      in_part.add(g.vertex_to_hyperedges[i], g.partition[v]);
+    }
+  }
+  std::vector<int> part_gains(in_part.stride());
+
+  long long check = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; ++pass) {
+    check += pin_count_gains(g, in_part, sweep, part_gains.data());
+  }
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  std::printf("%-14s %12.3f %16.1f %16lld\n", name, seconds * 1e3 / passes,
+              g.vertices * g.candidates / (seconds / passes) / 1e6, check);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int vertices = argc > 1 ? std::atoi(argv[1]) : 500000;
+  int parts = argc > 2 ? std::atoi(argv[2]) : 8;
+  int passes = argc > 3 ? std::atoi(argv[3]) : 5;
+  int candidates = argc > 4 ? std::atoi(argv[4]) : parts - 1;
+
+  instance g = generate(vertices, parts, std::min(candidates, parts - 1));
+  std::printf("%d vertices, %d hyperedges, %zu incidences, %d parts, "
+              "%d candidates\n\n", g.vertices, g.hyperedges,
+              g.vertex_to_hyperedges.size(), g.parts, g.candidates);
+  std::printf("%-14s %12s %16s %16s\n", "arrays", "ms / pass",
+              "Mmoves/s", "checksum");
+
+  run<ds::dynamic_array<int> >("dynamic_array", g, passes,
+                               [](ds::dynamic_array<int> &a)
+                                   -> ds::dynamic_array<int> & { return a; });
+  run<ds::buffer<int> >("buffer", g, passes,
+                        [](ds::buffer<int> &a) -> ds::buffer<int> & {
+                          return a;
+                        });
+  run<ds::buffer<int> >("span", g, passes,
+                        [](ds::buffer<int> &a) { return a.view(); });
+  run_pin_counts("pin_counts", g, passes, false);
+  run_pin_counts("sweep", g, passes, true);
+  return 0;
+}
@@ -0,0 +1,249 @@
+// Compares the open addressed, power of two map_to_pos_int against the
+// previous tables, which were sized from a fixed list of primes, probed by
+// double hashing (a division per probe) and kept keys and values in separate
+// arrays.
+//
+// The int map is filled with scattered vertex keys and then queried for
+// every key, as the coarseners do with their matchInfoLoc maps. Duplicate
+// hyperedges are found among hash keys, a tenth of them duplicates, first by
+// filling the previous hyperedge table and looking up each key, and then as
+// process_new_hyperedges does: radix sorting the keys with their indices and
+// pointing each run of equal keys at its first index.
+//
+// Usage: parkway_benchmark_hash_tables [entries] [rounds]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Macros.h"
+#include "data_structures/map_to_pos_int.hpp"
+#include "data_structures/internal/table_utils.hpp"
+#include "utility/sorting.hpp"
+
+namespace {
+
+namespace ds = parkway::data_structures;
+using ds::internal::table_utils;
+
+// The previous capacities: the smallest listed prime whose minimum does not
+// exceed the requested size. The list ended at 64M slots.
+int legacy_table_size(int n) {
+  static const int sizes[16] = {
+    1091, 2113, 4133, 9067, 17093, 37097, 70099, 145109, 300149, 610217,
+    1290151, 2600177, 6000109, 12500197, 26000111, 64000147
+  };
+  static const int mins[16] = {
+    0, 256, 512, 1024, 2056, 4112, 8224, 16448, 35000, 70000, 140000,
+    300000, 700000, 1800000, 4000000, 12500000
+  };
+  int i = 15;
+  while (i > 0 && mins[i] > n) {
+    --i;
+  }
+  return sizes[i];
+}
+
+template <typename Key> int legacy_primary(Key key, int capacity) {
+  return static_cast<int>(key % capacity);
+}
+
+template <typename Key> int legacy_secondary(Key key, int capacity) {
+  return static_cast<int>(1 + key % (capacity - 1));
+}
+
+// Records the slots it fills, as map_to_pos_int does.
+class legacy_int_map {
+ public:
+  explicit legacy_int_map(int n)
+      : size_(0), capacity_(legacy_table_size(n)), keys_(capacity_, -1),
+        values_(capacity_, -1) {
+    entries_.resize(2048);
+  }
+
+  void insert(int key, int value) {
+    int k = table_utils::scatter_key(key);
+    int slot = legacy_primary(k, capacity_);
+    while (keys_[slot] != -1 && keys_[slot] != k) {
+      slot = (slot + legacy_secondary(k, capacity_)) % capacity_;
+    }
+    if (keys_[slot] == -1) {
+      entries_[size_++] = slot;
+    }
+    keys_[slot] = k;
+    values_[slot] = value;
+  }
+
+  int get(int key) const {
+    int k = table_utils::scatter_key(key);
+    int slot = legacy_primary(k, capacity_);
+    while (keys_[slot] != k) {
+      slot = (slot + legacy_secondary(k, capacity_)) % capacity_;
+    }
+    return values_[slot];
+  }
+
+ private:
+  int size_;
+  int capacity_;
+  std::vector<int> keys_;
+  std::vector<int> values_;
+  ds::dynamic_array<int> entries_;
+};
+
+class legacy_hyperedge_table {
+ public:
+  explicit legacy_hyperedge_table(int n)
+      : capacity_(legacy_table_size(n)), keys_(capacity_),
+        indices_(capacity_, -1), next_(capacity_, -1) {
+  }
+
+  void insert(HashKey key, int index) {
+    int slot = legacy_primary(key, capacity_);
+    int last = -1;
+    while (indices_[slot] != -1) {
+      if (keys_[slot] == key) {
+        last = slot;
+      }
+      slot = (slot + legacy_secondary(key, capacity_)) % capacity_;
+    }
+    indices_[slot] = index;
+    keys_[slot] = key;
+    if (last >= 0) {
+      next_[last] = slot;
+    }
+  }
+
+  int get(HashKey key) const {
+    int slot = legacy_primary(key, capacity_);
+    while (indices_[slot] != -1) {
+      if (keys_[slot] == key) {
+        return indices_[slot];
+      }
+      slot = (slot + legacy_secondary(key, capacity_)) % capacity_;
+    }
+    return -1;
+  }
+
+ private:
+  int capacity_;
+  std::vector<HashKey> keys_;
+  std::vector<int> indices_;
+  std::vector<int> next_;
+};
+
+template <typename Function> double time_ms(Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int entries = argc > 1 ? std::atoi(argv[1]) : 2000000;
+  int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  std::mt19937_64 generator(117);
+  int vertices = 8 * entries;
+  table_utils::set_scatter_key(vertices);
+
+  std::vector<int> vertex_keys(vertices);
+  std::iota(vertex_keys.begin(), vertex_keys.end(), 0);
+  std::shuffle(vertex_keys.begin(), vertex_keys.end(), generator);
+  vertex_keys.resize(entries);
+
+  std::vector<HashKey> hyperedge_keys(entries);
+  for (int i = 0; i < entries; ++i) {
+    hyperedge_keys[i] = i > 0 && generator() % 10 == 0
+                            ? hyperedge_keys[generator() % i]
+                            : static_cast<HashKey>(generator());
+  }
+
+  std::printf("%d entries, %d rounds\n\n", entries, rounds);
+  std::printf("%-16s %12s %12s %12s\n", "table", "slots", "fill (ms)",
+              "lookup (ms)");
+
+  long checksum = 0;
+  double fill = 0.0;
+  double lookup = 0.0;
+
+  for (int r = 0; r < rounds; ++r) {
+    legacy_int_map map(entries);
+    fill += time_ms([&] {
+      for (int i = 0; i < entries; ++i) map.insert(vertex_keys[i], i);
+    });
+    lookup += time_ms([&] {
+      for (int i = 0; i < entries; ++i) checksum += map.get(vertex_keys[i]);
+    });
+  }
+  std::printf("%-16s %12d %12.2f %12.2f\n", "legacy int map",
+              legacy_table_size(entries), fill / rounds, lookup / rounds);
+
+  fill = lookup = 0.0;
+  for (int r = 0; r < rounds; ++r) {
+    ds::map_to_pos_int map(entries, true);
+    fill += time_ms([&] {
+      for (int i = 0; i < entries; ++i) map.insert(vertex_keys[i], i);
+    });
+    lookup += time_ms([&] {
+      for (int i = 0; i < entries; ++i) checksum += map.get(vertex_keys[i]);
+    });
+  }
+  std::printf("%-16s %12d %12.2f %12.2f\n", "map_to_pos_int",
+              table_utils::table_size(entries), fill / rounds,
+              lookup / rounds);
+
+  fill = lookup = 0.0;
+  for (int r = 0; r < rounds; ++r) {
+    legacy_hyperedge_table table(entries);
+    fill += time_ms([&] {
+      for (int i = 0; i < entries; ++i) table.insert(hyperedge_keys[i], i);
+    });
+    lookup += time_ms([&] {
+      for (int i = 0; i < entries; ++i) checksum += table.get(hyperedge_keys[i]);
+    });
+  }
+  std::printf("%-16s %12d %12.2f %12.2f\n", "legacy hyperedge",
+              legacy_table_size(entries), fill / rounds, lookup / rounds);
+
+  typedef std::pair<HashKey, int> keyed_hyperedge;
+  std::vector<keyed_hyperedge> keys(entries);
+  std::vector<keyed_hyperedge> scratch(entries);
+  std::vector<int> first_copy(entries);
+
+  fill = lookup = 0.0;
+  for (int r = 0; r < rounds; ++r) {
+    for (int i = 0; i < entries; ++i) {
+      keys[i] = keyed_hyperedge(hyperedge_keys[i], i);
+    }
+    fill += time_ms([&] {
+      parkway::utility::radix_sort(
+          keys.data(), scratch.data(), entries,
+          [](const keyed_hyperedge &h) { return h.first; });
+    });
+    lookup += time_ms([&] {
+      int run = 0;
+      while (run < entries) {
+        int run_end = run + 1;
+        while (run_end < entries && keys[run_end].first == keys[run].first) {
+          ++run_end;
+        }
+        for (int k = run; k < run_end; ++k) {
+          first_copy[keys[k].second] = keys[run].second;
+        }
+        run = run_end;
+      }
+      for (int i = 0; i < entries; ++i) checksum += first_copy[i];
+    });
+  }
+  std::printf("%-16s %12d %12.2f %12.2f\n", "radix sorted", entries,
+              fill / rounds, lookup / rounds);
+
+  std::printf("\n(checksum %ld)\n", checksum);
+  return 0;
+}
@@ -0,0 +1,152 @@
+// Compares Funct::computeHash against the previous hyperedge hash, which
+// padded every hyperedge out to the longest hyperedge in the hypergraph.
+//
+// A synthetic set of sorted hyperedges is generated with mostly 2 and 3 pin
+// hyperedges, a tail of longer ones and a few very long hyperedges, and a
+// known fraction of exact duplicates. For each hash the throughput and the
+// number of colliding keys between distinct hyperedges is reported.
+//
+// Usage: parkway_benchmark_hyperedge_hash [hyperedges] [longest hyperedge]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Funct.hpp"
+
+namespace {
+
+// The hash used before the key was made independent of the maximum length.
+unsigned int legacy_hash(const int *vs, int len, int max_length) {
+  const unsigned int key_size = sizeof(unsigned int);
+  auto rotate_left = [key_size](unsigned int a, unsigned int b) {
+    return b > key_size ? 0 : ((a >> (key_size - b)) | (a << b));
+  };
+
+  unsigned int key = 0;
+  unsigned int slide1 = 0;
+  unsigned int slide2 = 16;
+  int sum = 0;
+
+  for (int i = 0; i < max_length; ++i) {
+    if (i < len) {
+      sum += vs[i];
+      key ^= rotate_left(vs[i], slide1);
+    } else {
+      sum += 1;
+      key ^= rotate_left(1, slide1);
+    }
+    key ^= rotate_left(sum, slide2);
+    slide1 = (slide1 + 7) % key_size;
+    slide2 = (slide2 + 13) % key_size;
+  }
+  return key;
+}
+
+struct hyperedges {
+  std::vector<int> offsets;
+  std::vector<int> pins;
+  // Index of the first identical hyperedge (itself if it is unique).
+  std::vector<int> original;
+};
+
+hyperedges generate(int number, int longest, int vertices) {
+  std::mt19937 generator(117);
+  std::uniform_int_distribution<int> vertex(0, vertices - 1);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  hyperedges h;
+  h.offsets.push_back(0);
+  for (int i = 0; i < number; ++i) {
+    double u = unit(generator);
+    if (i > 0 && u < 0.1) {
+      // Duplicate an earlier hyperedge.
+      int j = std::uniform_int_distribution<int>(0, i - 1)(generator);
+      h.pins.insert(h.pins.end(), h.pins.begin() + h.offsets[j],
+                    h.pins.begin() + h.offsets[j + 1]);
+      h.original.push_back(h.original[j]);
+    } else {
+      int length = 2;
+      if (u < 0.5) {
+        length = 3;
+      } else if (u < 0.55) {
+        length = 4 + static_cast<int>(unit(generator) * 60);
+      }
+      if (i % (number / 4 + 1) == 0) {
+        length = longest;
+      }
+      std::vector<int> edge(length);
+      for (auto &pin : edge) {
+        pin = vertex(generator);
+      }
+      std::sort(edge.begin(), edge.end());
+      edge.erase(std::unique(edge.begin(), edge.end()), edge.end());
+      h.pins.insert(h.pins.end(), edge.begin(), edge.end());
+      h.original.push_back(i);
+    }
+    h.offsets.push_back(h.pins.size());
+  }
+  return h;
+}
+
+template <typename Key>
+int count_collisions(const std::vector<Key> &keys, const hyperedges &h) {
+  std::vector<std::pair<Key, int> > sorted;
+  sorted.reserve(keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    sorted.push_back(std::make_pair(keys[i], h.original[i]));
+  }
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+  int collisions = 0;
+  for (std::size_t i = 1; i < sorted.size(); ++i) {
+    if (sorted[i].first == sorted[i - 1].first) {
+      ++collisions;
+    }
+  }
+  return collisions;
+}
+
+template <typename Key, typename Hash>
+void run(const char *name, const hyperedges &h, Hash hash) {
+  int number = h.offsets.size() - 1;
+  std::vector<Key> keys(number);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < number; ++i) {
+    keys[i] = hash(&h.pins[h.offsets[i]], h.offsets[i + 1] - h.offsets[i]);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  std::printf("%-10s %12.3f %16.1f %12d\n", name, seconds * 1e3,
+              number / seconds / 1e6, count_collisions(keys, h));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int number = argc > 1 ? std::atoi(argv[1]) : 200000;
+  int longest = argc > 2 ? std::atoi(argv[2]) : 5000;
+
+  hyperedges h = generate(number, longest, 4 * number);
+  int max_length = 0;
+  for (int i = 0; i < number; ++i) {
+    max_length = std::max(max_length, h.offsets[i + 1] - h.offsets[i]);
+  }
+
+  std::printf("%d hyperedges, %zu pins, longest %d\n\n", number,
+              h.pins.size(), max_length);
+  std::printf("%-10s %12s %16s %12s\n", "hash", "time (ms)",
+              "Mhyperedges/s", "collisions");
+
+  run<HashKey>("current", h, [](const int *vs, int len) {
+    return Funct::computeHash(vs, len);
+  });
+  run<unsigned int>("legacy", h, [max_length](const int *vs, int len) {
+    return legacy_hash(vs, len, max_length);
+  });
+  return 0;
+}
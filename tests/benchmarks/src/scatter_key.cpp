@@ -0,0 +1,125 @@
+// Compares the computed scatter key permutation (table_utils::scatter_key)
+// against the previous scatter array, a random permutation of every global
+// vertex stored on each processor, and against no scattering at all.
+//
+// The keys inserted into a table mirror the tables' uses: a random subset of
+// the vertices, a contiguous block of vertex indices (the vertices of one
+// processor) and every p-th vertex. Keys are probed exactly as
+// map_to_pos_int and map_from_pos_int do: linear probing into a table sized
+// by table_utils::table_size. For each scattering the setup time, the memory
+// it takes, the time taken to fill the tables and the mean and longest probe
+// sequences of each workload are reported.
+//
+// Usage: parkway_benchmark_scatter_key [vertices] [keys per table]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "data_structures/internal/table_utils.hpp"
+
+namespace {
+
+using parkway::data_structures::internal::table_utils;
+namespace hashes = parkway::data_structures::internal::hashes;
+
+struct probes {
+  double mean;
+  int longest;
+};
+
+probes insert_all(const std::vector<int> &keys,
+                  const std::function<int(int)> &scatter) {
+  int capacity = table_utils::table_size(keys.size());
+  std::vector<int> table(capacity, -1);
+  long total = 0;
+  int longest = 0;
+
+  for (int key : keys) {
+    int k = scatter(key);
+    int slot = hashes::home(k, capacity);
+    int length = 1;
+    while (table[slot] != -1 && table[slot] != k) {
+      slot = hashes::next(slot, capacity);
+      ++length;
+    }
+    table[slot] = k;
+    total += length;
+    longest = std::max(longest, length);
+  }
+
+  probes p = {static_cast<double>(total) / keys.size(), longest};
+  return p;
+}
+
+void report(const char *name, double setup_ms, double megabytes,
+            const std::vector<std::vector<int> > &workloads,
+            const std::function<int(int)> &scatter) {
+  std::vector<probes> results;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &keys : workloads) {
+    results.push_back(insert_all(keys, scatter));
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  std::printf("%-10s %11.2f %11.1f %11.2f", name, setup_ms, megabytes,
+              std::chrono::duration<double, std::milli>(end - start).count());
+  for (const auto &p : results) {
+    std::printf(" %8.3f %5d", p.mean, p.longest);
+  }
+  std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int vertices = argc > 1 ? std::atoi(argv[1]) : 20000000;
+  int keys = argc > 2 ? std::atoi(argv[2]) : 1000000;
+  keys = std::min(keys, vertices);
+
+  std::mt19937 generator(117);
+  std::vector<std::vector<int> > workloads(3);
+
+  std::vector<int> all(vertices);
+  std::iota(all.begin(), all.end(), 0);
+  std::shuffle(all.begin(), all.end(), generator);
+  workloads[0].assign(all.begin(), all.begin() + keys);
+
+  int first = vertices / 3;
+  for (int i = 0; i < keys; ++i) {
+    workloads[1].push_back(first + i);
+  }
+
+  int stride = std::max(1, vertices / keys);
+  for (int i = 0; i < keys; ++i) {
+    workloads[2].push_back(static_cast<int>(static_cast<long>(i) * stride));
+  }
+
+  std::printf("%d vertices, %d keys per table\n\n", vertices, keys);
+  std::printf("%-10s %11s %11s %11s %14s %14s %14s\n", "scatter",
+              "setup (ms)", "memory (MB)", "fill (ms)", "random", "block",
+              "strided");
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<int> array(vertices);
+  std::iota(array.begin(), array.end(), 0);
+  std::shuffle(array.begin(), array.end(), generator);
+  auto end = std::chrono::steady_clock::now();
+  report("array", std::chrono::duration<double, std::milli>(end - start)
+                      .count(),
+         vertices * sizeof(int) / 1e6, workloads,
+         [&array](int key) { return array[key]; });
+
+  start = std::chrono::steady_clock::now();
+  table_utils::set_scatter_key(vertices);
+  end = std::chrono::steady_clock::now();
+  report("computed", std::chrono::duration<double, std::milli>(end - start)
+                         .count(),
+         0.0, workloads, [](int key) { return table_utils::scatter_key(key); });
+
+  report("identity", 0.0, 0.0, workloads, [](int key) { return key; });
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "data_structures/buffer.hpp"
+
+using parkway::data_structures::buffer;
+
+TEST(buffer, construction) {
+  buffer<int> buf1;
+  ASSERT_EQ(buf1.size(), 0);
+  ASSERT_EQ(buf1.data(), nullptr);
+
+  buffer<int> buf2(5);
+  ASSERT_EQ(buf2.size(), 5);
+  ASSERT_EQ(buf2.capacity(), 5);
+
+  buffer<int> buf3(3, 7);
+  ASSERT_EQ(buf3.size(), 3);
+  for (std::size_t i = 0; i < buf3.size(); ++i) {
+    ASSERT_EQ(buf3[i], 7);
+  }
+}
+
+TEST(buffer, move_transfers_ownership) {
+  buffer<int> buf1(4, 2);
+  const int *data = buf1.data();
+
+  buffer<int> buf2(std::move(buf1));
+  ASSERT_EQ(buf2.data(), data);
+  ASSERT_EQ(buf2.size(), 4);
+  ASSERT_EQ(buf1.size(), 0);
+  ASSERT_EQ(buf1.data(), nullptr);
+
+  buffer<int> buf3;
+  buf3 = std::move(buf2);
+  ASSERT_EQ(buf3.data(), data);
+  ASSERT_EQ(buf2.size(), 0);
+}
+
+TEST(buffer, resize_keeps_contents) {
+  buffer<int> buf;
+  buf.assign(3, 1);
+  buf[1] = 5;
+
+  buf.resize(10);
+  ASSERT_EQ(buf.size(), 10);
+  ASSERT_EQ(buf[0], 1);
+  ASSERT_EQ(buf[1], 5);
+  ASSERT_EQ(buf[2], 1);
+}
+
+TEST(buffer, shrinking_does_not_reallocate) {
+  buffer<int> buf(10);
+  const int *data = buf.data();
+
+  buf.resize(2);
+  ASSERT_EQ(buf.size(), 2);
+  ASSERT_EQ(buf.capacity(), 10);
+  ASSERT_EQ(buf.data(), data);
+
+  buf.resize(8);
+  ASSERT_EQ(buf.data(), data);
+}
+
+TEST(buffer, clear_and_shrink_releases_memory) {
+  buffer<int> buf(10, 0);
+  buf.clear_and_shrink();
+  ASSERT_EQ(buf.size(), 0);
+  ASSERT_EQ(buf.capacity(), 0);
+  ASSERT_EQ(buf.data(), nullptr);
+}
+
+TEST(buffer, view_covers_contents) {
+  buffer<int> buf(4, 3);
+  auto view = buf.view();
+  ASSERT_EQ(view.data(), buf.data());
+  ASSERT_EQ(view.size(), buf.size());
+
+  view[2] = 9;
+  ASSERT_EQ(buf[2], 9);
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+#include "data_structures/gain_bucket_queue.hpp"
+
+using parkway::data_structures::gain_bucket_queue;
+
+TEST(gain_bucket_queue, pops_in_order_of_decreasing_gain) {
+  gain_bucket_queue queue;
+  queue.reset(6, 10);
+  ASSERT_TRUE(queue.empty());
+
+  queue.insert(0, -3);
+  queue.insert(1, 7);
+  queue.insert(2, 0);
+  queue.insert(3, 10);
+  queue.insert(4, -10);
+  ASSERT_EQ(queue.size(), 5);
+  ASSERT_FALSE(queue.contains(5));
+  ASSERT_TRUE(queue.contains(4));
+
+  ASSERT_EQ(queue.top_key(), 10);
+  ASSERT_EQ(queue.pop(), 3);
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_EQ(queue.pop(), 0);
+  ASSERT_EQ(queue.pop(), 4);
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.contains(3));
+}
+
+TEST(gain_bucket_queue, equal_gains_are_last_in_first_out) {
+  gain_bucket_queue queue;
+  queue.reset(3, 4);
+
+  queue.insert(0, 2);
+  queue.insert(1, 2);
+  queue.insert(2, 2);
+
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_EQ(queue.pop(), 0);
+}
+
+TEST(gain_bucket_queue, update_and_remove) {
+  gain_bucket_queue queue;
+  queue.reset(4, 5);
+
+  queue.insert(0, 5);
+  queue.insert(1, 1);
+  queue.update(2, 3);
+  ASSERT_EQ(queue.key(2), 3);
+
+  queue.update(0, -2);
+  ASSERT_EQ(queue.key(0), -2);
+  ASSERT_EQ(queue.top(), 2);
+
+  queue.remove(2);
+  ASSERT_FALSE(queue.contains(2));
+  ASSERT_EQ(queue.top_key(), 1);
+  ASSERT_EQ(queue.size(), 2);
+
+  queue.clear();
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.contains(0));
+  ASSERT_FALSE(queue.contains(1));
+
+  queue.insert(1, 4);
+  ASSERT_EQ(queue.top(), 1);
+}
+
+TEST(gain_bucket_queue, insert_back_is_first_in_first_out) {
+  gain_bucket_queue queue;
+  queue.reset(4, 4);
+
+  queue.insert_back(0, 1);
+  queue.insert_back(1, 1);
+  queue.insert(2, 1);
+  queue.insert_back(3, 1);
+
+  ASSERT_EQ(queue.first(1), 2);
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_EQ(queue.pop(), 0);
+
+  queue.remove(3);
+  queue.insert_back(3, 1);
+  queue.insert_back(0, 1);
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_EQ(queue.pop(), 3);
+  ASSERT_EQ(queue.pop(), 0);
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(gain_bucket_queue, walks_buckets_in_order_of_decreasing_gain) {
+  // Wide enough for the bitmap to need more than one summary word.
+  const int max_gain = 5000;
+  gain_bucket_queue queue;
+  queue.reset(5, max_gain);
+
+  queue.insert(0, max_gain);
+  queue.insert(1, 63);
+  queue.insert(2, 63);
+  queue.insert(3, -64);
+  queue.insert(4, -max_gain);
+
+  int gain = queue.top_key();
+  ASSERT_EQ(gain, max_gain);
+  ASSERT_EQ(queue.first(gain), 0);
+  ASSERT_EQ(queue.next(0), -1);
+
+  gain = queue.next_key_below(gain);
+  ASSERT_EQ(gain, 63);
+  ASSERT_EQ(queue.first(gain), 2);
+  ASSERT_EQ(queue.next(2), 1);
+
+  gain = queue.next_key_below(gain);
+  ASSERT_EQ(gain, -64);
+  gain = queue.next_key_below(gain);
+  ASSERT_EQ(gain, -max_gain);
+  ASSERT_EQ(queue.next_key_below(gain), gain_bucket_queue::no_key);
+  ASSERT_EQ(queue.first(0), -1);
+
+  // Emptying the top bucket finds the next one down through the bitmap.
+  queue.remove(0);
+  ASSERT_EQ(queue.top_key(), 63);
+  queue.remove(1);
+  queue.remove(2);
+  ASSERT_EQ(queue.top_key(), -64);
+  ASSERT_EQ(queue.pop(), 3);
+  ASSERT_EQ(queue.top(), 4);
+  ASSERT_EQ(queue.pop(), 4);
+  ASSERT_TRUE(queue.empty());
+
+  queue.insert(1, -3);
+  ASSERT_EQ(queue.top_key(), -3);
+}
@@ -28,7 +28,7 @@ TEST(MapFromPosInt, Create) {
 
 TEST(MapFromPosInt, Insert) {
   map_from_pos_int<char> map_(10);
-  table_utils::set_scatter_array(10);
+  table_utils::set_scatter_key(10);
 
   ASSERT_EQ(map_.size(), 0);
   ASSERT_FALSE(map_.insert(0, 'a'));
@@ -41,12 +41,12 @@ TEST(MapFromPosInt, Insert) {
   ASSERT_EQ(map_.size(), 2);
 
   // Unset scatter key, other tests rely on it being unset.
-  table_utils::set_scatter_array(table_utils::SCATTER_ARRAY_NOT_SET);
+  table_utils::set_scatter_key(table_utils::SCATTER_KEY_NOT_SET);
 }
 
 TEST(MapFromPosInt, Get) {
   map_from_pos_int<char> map_(10);
-  table_utils::set_scatter_array(10);
+  table_utils::set_scatter_key(10);
 
   ASSERT_EQ(map_.size(), 0);
   ASSERT_FALSE(map_.insert(0, 'a'));
@@ -58,13 +58,13 @@ TEST(MapFromPosInt, Get) {
   ASSERT_EQ(map_[5], 'c');
 
   // Unset scatter key, other tests rely on it being unset.
-  table_utils::set_scatter_array(table_utils::SCATTER_ARRAY_NOT_SET);
+  table_utils::set_scatter_key(table_utils::SCATTER_KEY_NOT_SET);
 }
 
 
 TEST(MapFromPosInt, Destroy) {
   map_from_pos_int<float> map_;
-  table_utils::set_scatter_array(map_.capacity());
+  table_utils::set_scatter_key(map_.capacity());
 
   ASSERT_FALSE(map_.insert(0, 1.23));
   ASSERT_FALSE(map_.insert(1, 4.56));
@@ -75,5 +75,5 @@ TEST(MapFromPosInt, Destroy) {
   ASSERT_EQ(map_.size(), 0);
 
   // Unset scatter key, other tests rely on it being unset.
-  table_utils::set_scatter_array(table_utils::SCATTER_ARRAY_NOT_SET);
+  table_utils::set_scatter_key(table_utils::SCATTER_KEY_NOT_SET);
 }
@@ -46,7 +46,7 @@ TEST(MapToPosInt, InsertHash) {
   ASSERT_TRUE(int_map.insert(0, 4));
   ASSERT_EQ(int_map.get(0), 4);
 
-  parkway::data_structures::internal::table_utils::set_scatter_array(1);
+  parkway::data_structures::internal::table_utils::set_scatter_key(1);
   // Scatter is size 1 so the only item is index 0 -- overwrites index 0.
   ASSERT_TRUE(int_map.insert(0, 7));
   ASSERT_EQ(int_map.get(0), 7);
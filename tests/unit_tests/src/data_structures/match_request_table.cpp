@@ -8,3 +8,15 @@ TEST(MatchRequestTable, Construction) {
   ASSERT_EQ(table_.size(), 0);
   ASSERT_EQ(table_.capacity(), 10);
 }
+
+TEST(MatchRequestTable, Requested) {
+  match_request_table table_(10);
+  ASSERT_FALSE(table_.requested(42));
+
+  table_.add_local(42, 3, 1, 1);
+  ASSERT_FALSE(table_.requested(42));
+
+  table_.get_entry(42)->set_requested();
+  ASSERT_TRUE(table_.requested(42));
+  ASSERT_FALSE(table_.requested(52));
+}
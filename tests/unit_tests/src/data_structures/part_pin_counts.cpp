@@ -0,0 +1,126 @@
+#include <vector>
+#include "gtest/gtest.h"
+#include "data_structures/part_pin_counts.hpp"
+
+using parkway::data_structures::part_pin_counts;
+
+TEST(part_pin_counts, reset_pads_rows) {
+  part_pin_counts counts;
+  counts.reset(3, 2);
+  ASSERT_EQ(counts.parts(), 2);
+  ASSERT_EQ(counts.stride(), 4);
+
+  counts.reset(3, 37);
+  ASSERT_EQ(counts.stride(), 48);
+
+  for (int e = 0; e < 3; ++e) {
+    for (int p = 0; p < 37; ++p) {
+      ASSERT_TRUE(counts.empty(e, p));
+      ASSERT_EQ(counts(e, p), 0);
+    }
+  }
+}
+
+TEST(part_pin_counts, add_and_remove) {
+  part_pin_counts counts;
+  counts.reset(2, 4);
+
+  ASSERT_EQ(counts.add(1, 3), 1);
+  ASSERT_TRUE(counts.single(1, 3));
+  ASSERT_EQ(counts.add(1, 3), 2);
+  ASSERT_FALSE(counts.single(1, 3));
+  ASSERT_EQ(counts.remove(1, 3), 1);
+  ASSERT_EQ(counts.remove(1, 3), 0);
+  ASSERT_TRUE(counts.empty(1, 3));
+  ASSERT_TRUE(counts.empty(0, 3));
+}
+
+TEST(part_pin_counts, counts_beyond_a_byte_are_exact) {
+  part_pin_counts counts;
+  counts.reset(2, 4);
+
+  for (int i = 1; i <= 1000; ++i) {
+    ASSERT_EQ(counts.add(0, 1), i);
+  }
+  ASSERT_EQ(counts(0, 1), 1000);
+  ASSERT_FALSE(counts.empty(0, 1));
+  ASSERT_FALSE(counts.single(0, 1));
+
+  for (int i = 999; i >= 0; --i) {
+    ASSERT_EQ(counts.remove(0, 1), i);
+    ASSERT_EQ(counts(0, 1), i);
+  }
+  ASSERT_TRUE(counts.empty(0, 1));
+  ASSERT_EQ(counts(1, 1), 0);
+}
+
+TEST(part_pin_counts, add_where_present_matches_scalar) {
+  const int parts = 37;
+  part_pin_counts counts;
+  counts.reset(4, parts);
+
+  for (int p = 0; p < parts; p += 3) {
+    counts.add(2, p);
+  }
+  counts.add(2, parts - 1);
+
+  std::vector<int> gains(counts.stride(), 5);
+  counts.add_where_present(2, 7, gains.data());
+
+  for (int p = 0; p < parts; ++p) {
+    ASSERT_EQ(gains[p], counts.empty(2, p) ? 5 : 12);
+  }
+}
+
+TEST(part_pin_counts, sparse_layout_keeps_spanned_parts_sorted) {
+  const int capacities[] = {3, 2};
+  part_pin_counts counts;
+  counts.reset(2, 4096, capacities);
+  ASSERT_TRUE(counts.sparse());
+
+  ASSERT_EQ(counts.add(0, 900), 1);
+  ASSERT_EQ(counts.add(0, 7), 1);
+  ASSERT_EQ(counts.add(0, 900), 2);
+  ASSERT_EQ(counts.add(0, 4000), 1);
+  ASSERT_EQ(counts.add(1, 3), 1);
+
+  auto parts = counts.spanned_parts(0);
+  ASSERT_EQ(parts.size(), 3);
+  ASSERT_EQ(parts[0], 7);
+  ASSERT_EQ(parts[1], 900);
+  ASSERT_EQ(parts[2], 4000);
+
+  ASSERT_EQ(counts(0, 900), 2);
+  ASSERT_TRUE(counts.single(0, 7));
+  ASSERT_TRUE(counts.empty(0, 3));
+  ASSERT_TRUE(counts.single(1, 3));
+
+  ASSERT_EQ(counts.remove(0, 7), 0);
+  ASSERT_TRUE(counts.empty(0, 7));
+  ASSERT_EQ(counts.spanned_parts(0).size(), 2);
+  ASSERT_EQ(counts.spanned_parts(0)[0], 900);
+}
+
+TEST(part_pin_counts, sparse_add_where_present_matches_dense) {
+  const int parts = 300;
+  const int capacities[] = {20};
+  part_pin_counts dense;
+  part_pin_counts sparse;
+  dense.reset(1, parts);
+  sparse.reset(1, parts, capacities);
+
+  for (int p = 5; p < parts; p += 17) {
+    dense.add(0, p);
+    sparse.add(0, p);
+  }
+  ASSERT_EQ(dense.stride(), sparse.stride());
+
+  std::vector<int> dense_gains(dense.stride(), 0);
+  std::vector<int> sparse_gains(sparse.stride(), 0);
+  dense.add_where_present(0, 3, dense_gains.data());
+  sparse.add_where_present(0, 3, sparse_gains.data());
+
+  for (int p = 0; p < parts; ++p) {
+    ASSERT_EQ(dense_gains[p], sparse_gains[p]);
+  }
+}
@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+#include "data_structures/part_set_table.hpp"
+
+using parkway::data_structures::part_set_table;
+
+TEST(part_set_table, dense_insert_and_erase) {
+  part_set_table sets;
+  sets.reset(3, 8);
+  ASSERT_FALSE(sets.sparse());
+
+  ASSERT_TRUE(sets.insert(1, 5));
+  ASSERT_FALSE(sets.insert(1, 5));
+  ASSERT_TRUE(sets.contains(1, 5));
+  ASSERT_FALSE(sets.contains(0, 5));
+  ASSERT_FALSE(sets.contains(2, 5));
+
+  ASSERT_TRUE(sets.erase(1, 5));
+  ASSERT_FALSE(sets.erase(1, 5));
+  ASSERT_FALSE(sets.contains(1, 5));
+}
+
+TEST(part_set_table, sparse_members_are_sorted) {
+  const int capacities[] = {1, 4, 2};
+  part_set_table sets;
+  sets.reset(3, 1024, capacities);
+  ASSERT_TRUE(sets.sparse());
+
+  ASSERT_TRUE(sets.insert(1, 600));
+  ASSERT_TRUE(sets.insert(1, 2));
+  ASSERT_TRUE(sets.insert(1, 1000));
+  ASSERT_FALSE(sets.insert(1, 2));
+  ASSERT_TRUE(sets.insert(0, 9));
+  ASSERT_TRUE(sets.insert(2, 9));
+
+  auto members = sets.members(1);
+  ASSERT_EQ(members.size(), 3);
+  ASSERT_EQ(members[0], 2);
+  ASSERT_EQ(members[1], 600);
+  ASSERT_EQ(members[2], 1000);
+
+  ASSERT_TRUE(sets.erase(1, 600));
+  ASSERT_FALSE(sets.contains(1, 600));
+  ASSERT_TRUE(sets.contains(1, 1000));
+  ASSERT_TRUE(sets.contains(0, 9));
+  ASSERT_TRUE(sets.contains(2, 9));
+  ASSERT_EQ(sets.members(1).size(), 2);
+}
@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+#include "data_structures/dynamic_array.hpp"
+#include "data_structures/span.hpp"
+
+using parkway::data_structures::dynamic_array;
+using parkway::data_structures::span;
+
+TEST(span, construction) {
+  span<int> empty;
+  ASSERT_TRUE(empty.empty());
+  ASSERT_EQ(empty.data(), nullptr);
+
+  int values[] = {1, 2, 3};
+  span<int> view(values, 3);
+  ASSERT_EQ(view.size(), 3);
+  ASSERT_EQ(view[1], 2);
+}
+
+TEST(span, converts_to_span_of_const) {
+  int values[] = {1, 2, 3};
+  span<int> view(values, 3);
+  span<const int> const_view = view;
+  ASSERT_EQ(const_view.data(), values);
+  ASSERT_EQ(const_view.size(), 3);
+}
+
+TEST(span, iterates_over_contents) {
+  int values[] = {4, 5, 6};
+  int sum = 0;
+  for (int value : span<int>(values, 3)) {
+    sum += value;
+  }
+  ASSERT_EQ(sum, 15);
+}
+
+TEST(span, subspan) {
+  int values[] = {1, 2, 3, 4, 5};
+  span<int> view = span<int>(values, 5).subspan(1, 3);
+  ASSERT_EQ(view.size(), 3);
+  ASSERT_EQ(view[0], 2);
+  ASSERT_EQ(view[2], 4);
+}
+
+TEST(span, dynamic_array_view_shares_data) {
+  dynamic_array<int> arr(3, 1);
+  span<int> view = arr.view();
+  ASSERT_EQ(view.data(), arr.data());
+  ASSERT_EQ(view.size(), arr.size());
+
+  view[0] = 8;
+  ASSERT_EQ(arr[0], 8);
+}
@@ -0,0 +1,46 @@
+#include <vector>
+#include "gtest/gtest.h"
+#include "data_structures/internal/table_utils.hpp"
+
+using parkway::data_structures::internal::table_utils;
+
+TEST(TableUtils, ScatterKeyUnset) {
+  table_utils::set_scatter_key(table_utils::SCATTER_KEY_NOT_SET);
+  ASSERT_EQ(table_utils::scatter_key(0), 0);
+  ASSERT_EQ(table_utils::scatter_key(12345), 0);
+}
+
+TEST(TableUtils, ScatterKeyIsPermutation) {
+  const int sizes[] = {1, 2, 10, 1000, 4096, 4097, 100003};
+
+  for (int size : sizes) {
+    table_utils::set_scatter_key(size);
+    std::vector<bool> seen(size, false);
+
+    for (int i = 0; i < size; ++i) {
+      int key = table_utils::scatter_key(i);
+      ASSERT_GE(key, 0);
+      ASSERT_LT(key, size);
+      ASSERT_FALSE(seen[key]);
+      seen[key] = true;
+    }
+  }
+
+  // Unset scatter key, other tests rely on it being unset.
+  table_utils::set_scatter_key(table_utils::SCATTER_KEY_NOT_SET);
+}
+
+TEST(TableUtils, TableSizeIsPowerOfTwo) {
+  const int sizes[] = {0, 1, 341, 342, 1000, 100000, 70000000};
+
+  for (int n : sizes) {
+    int size = table_utils::table_size(n);
+    ASSERT_EQ(size & (size - 1), 0);
+    ASSERT_GE(size, table_utils::MIN_TABLE_SIZE);
+    ASSERT_GE(static_cast<long>(size), static_cast<long>(n) * 3);
+  }
+
+  ASSERT_EQ(table_utils::table_size(0), table_utils::MIN_TABLE_SIZE);
+  ASSERT_EQ(table_utils::table_size(1000), 4096);
+  ASSERT_EQ(table_utils::table_size(800000000), table_utils::MAX_TABLE_SIZE);
+}
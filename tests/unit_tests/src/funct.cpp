@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+#include "Funct.hpp"
+
+TEST(Funct, ComputeHashIsOrderInvariant) {
+  int pins[] = {3, 17, 42, 1000};
+  int permuted[] = {42, 3, 1000, 17};
+  ASSERT_EQ(Funct::computeHash(pins, 4), Funct::computeHash(permuted, 4));
+}
+
+
+TEST(Funct, ComputeHashDistinguishesPinSets) {
+  int pins[] = {3, 17, 42, 1000};
+  int other[] = {3, 17, 43, 1000};
+  ASSERT_NE(Funct::computeHash(pins, 4), Funct::computeHash(other, 4));
+  // A prefix is a different hyperedge.
+  ASSERT_NE(Funct::computeHash(pins, 4), Funct::computeHash(pins, 3));
+  ASSERT_NE(Funct::computeHash(pins, 1), Funct::computeHash(pins, 0));
+}
+
+
+TEST(Funct, ComputeHashNoCollisionsOnSmallHyperedges) {
+  // All 2-pin hyperedges over 300 vertices.
+  std::vector<HashKey> keys;
+  for (int i = 0; i < 300; ++i) {
+    for (int j = i + 1; j < 300; ++j) {
+      int pins[] = {i, j};
+      keys.push_back(Funct::computeHash(pins, 2));
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  ASSERT_EQ(std::unique(keys.begin(), keys.end()), keys.end());
+}
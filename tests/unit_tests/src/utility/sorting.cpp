@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "utility/sorting.hpp"
+#include "utility/thread_pool.hpp"
+
+namespace util = parkway::utility;
+
+TEST(Sorting, SortShort) {
+  for (int length = 0; length < 40; ++length) {
+    std::vector<int> values(length);
+    for (int i = 0; i < length; ++i) {
+      values[i] = (i * 7919) % 13;
+    }
+
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    util::sort_short(values.data(), length);
+    ASSERT_EQ(values, expected);
+  }
+}
+
+TEST(Sorting, RadixSortIsStable) {
+  typedef std::pair<unsigned long long, int> keyed;
+  auto key = [](const keyed &k) { return k.first; };
+
+  std::vector<keyed> values;
+  for (int i = 0; i < 100000; ++i) {
+    unsigned long long k = static_cast<unsigned long long>(i % 977) << 40 |
+                           static_cast<unsigned long long>(i % 3);
+    values.push_back(keyed(k, i));
+  }
+
+  std::vector<keyed> expected = values;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const keyed &a, const keyed &b) {
+                     return a.first < b.first;
+                   });
+
+  std::vector<keyed> serial = values;
+  std::vector<keyed> scratch(values.size());
+  util::radix_sort(serial.data(), scratch.data(), serial.size(), key);
+  ASSERT_EQ(serial, expected);
+
+  util::thread_pool pool(3);
+  std::vector<keyed> threaded = values;
+  util::radix_sort(threaded.data(), scratch.data(), threaded.size(), key,
+                   &pool);
+  ASSERT_EQ(threaded, expected);
+}
@@ -0,0 +1,47 @@
+#include <atomic>
+#include <vector>
+#include "gtest/gtest.h"
+#include "utility/thread_pool.hpp"
+
+using parkway::utility::thread_pool;
+
+TEST(thread_pool, size_includes_calling_thread) {
+  thread_pool single(1);
+  ASSERT_EQ(single.size(), 1);
+
+  thread_pool several(4);
+  ASSERT_EQ(several.size(), 4);
+}
+
+TEST(thread_pool, runs_every_task_once) {
+  thread_pool pool(4);
+  std::vector<std::atomic<int> > runs(1000);
+  for (auto &r : runs) {
+    r = 0;
+  }
+
+  pool.run(runs.size(), [&](int task, int thread) {
+    ASSERT_GE(thread, 0);
+    ASSERT_LT(thread, 4);
+    ++runs[task];
+  });
+
+  for (auto &r : runs) {
+    ASSERT_EQ(r, 1);
+  }
+}
+
+TEST(thread_pool, can_be_reused) {
+  thread_pool pool(3);
+  std::atomic<int> sum(0);
+
+  for (int i = 0; i < 50; ++i) {
+    pool.run(i, [&](int task, int) { sum += task; });
+  }
+
+  int expected = 0;
+  for (int i = 0; i < 50; ++i) {
+    expected += i * (i - 1) / 2;
+  }
+  ASSERT_EQ(sum, expected);
+}
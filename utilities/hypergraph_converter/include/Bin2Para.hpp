@@ -9,11 +9,17 @@
 //
 // 02/12/2004: Last Modified
 //
+// Splits a binary hypergraph into the numProcessors '<file>-<i>' part files
+// in a single pass over the input, streaming hyperedge chunks to one part
+// file at a time through a bounded buffer.
+//
 // ###
 
 #include <fstream>
 #include <cstdio>
+#include <memory>
 #include "FromBinConverter.hpp"
+#include "ParaFileWriter.hpp"
 
 using namespace std;
 
@@ -21,18 +27,20 @@ class Bin2Para : public FromBinConverter {
 
 protected:
   int numProcessors;
-  int numLocHedges;
-  int numLocVertices;
+  int bufferLength;
+  bool useWriterThreads;
+
+  void checkPinRange(int chunkStart, int chunkEnd);
+  void openPart(unique_ptr<ParaFileWriter> &writer, const char *filename,
+                int part, ParaWriterThreads *writerThreads);
+  void closePart(unique_ptr<ParaFileWriter> &writer, int part);
 
 public:
-  Bin2Para(int numP);
+  Bin2Para(int numP, bool writerThreads = false);
   Bin2Para();
   ~Bin2Para();
 
   void convert(const char *filename);
-  void buildParaFile(ifstream &in_stream, ofstream &out_stream,
-                     const char *p_file, int &inLoc, int &inData,
-                     int minVertIdx);
 };
 
 #endif
@@ -0,0 +1,75 @@
+#ifndef _CHUNKED_TEXT_READER_HPP
+#define _CHUNKED_TEXT_READER_HPP
+
+// ### ChunkedTextReader.hpp ###
+//
+// Reads the integers of a text file a window at a time. The file is mapped
+// into memory and each window is split at line boundaries into one piece per
+// thread. Every thread tokenizes its piece into its own (record offsets,
+// values) arrays and the pieces are then stitched, also in parallel, into one
+// CSR array for the window.
+//
+// A record is a line holding at least one integer; lines without any are
+// skipped and '%' starts a comment running to the end of the line. As with
+// StringUtils, an integer is a maximal run of digits and anything else is a
+// separator, so signs and decimal points are not interpreted. There is no
+// limit on the length of a line.
+//
+// ###
+
+#include <vector>
+
+using namespace std;
+
+class ChunkedTextReader {
+
+protected:
+  int fileDescriptor;
+  const char *fileData;
+  long fileLength;
+  long position;
+
+  int numThreads;
+  long windowLength;
+
+  // stitched records of the current window
+  vector<int> recordOffsets;
+  vector<int> values;
+
+  // per piece records, before stitching
+  vector<vector<int> > pieceOffsets;
+  vector<vector<int> > pieceValues;
+
+  long lineEnd(long from) const;
+  void tokenize(long begin, long end, int maxValuesPerRecord,
+                vector<int> &offsets, vector<int> &vals) const;
+  void stitch(int piece, long recordBase, long valueBase);
+
+public:
+  ChunkedTextReader(int threads = 0);
+  ~ChunkedTextReader();
+
+  // Maps the file and starts reading at byte 'offset', which must be the
+  // start of a line. Returns false if the file cannot be opened.
+  bool open(const char *filename, long offset = 0);
+  void close();
+
+  // Moves back to byte 'offset', the start of a line.
+  inline void seek(long offset) { position = offset; }
+  inline long tell() const { return position; }
+
+  // Tokenizes the next window of the file. Only the first
+  // maxValuesPerRecord integers of each record are kept (all if 0). Returns
+  // false if the end of the file was already reached.
+  bool readWindow(int maxValuesPerRecord = 0);
+
+  inline int getNumRecords() const { return recordOffsets.size() - 1; }
+  inline int getRecordLength(int i) const {
+    return recordOffsets[i + 1] - recordOffsets[i];
+  }
+  inline const int *getRecord(int i) const {
+    return values.data() + recordOffsets[i];
+  }
+};
+
+#endif
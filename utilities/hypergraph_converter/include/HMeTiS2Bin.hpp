@@ -27,9 +27,7 @@ public:
   void readPreamble(ifstream &in);
 
   int processHedgeLine(char *line, int &numP);
-  int countPinsInLine(char *line, int &nP);
   int processVertLine(char *line);
-  int computeNumPins(ifstream &in_stream);
 };
 
 #endif
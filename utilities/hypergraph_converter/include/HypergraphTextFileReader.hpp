@@ -13,6 +13,7 @@
 
 #include "StringUtils.hpp"
 #include "TextFileReader.hpp"
+#include "ChunkedTextReader.hpp"
 
 using namespace std;
 
@@ -25,6 +26,13 @@ protected:
   int wtsOnVertices;
   int wtsOnHedges;
 
+  // Converts the hyperedge and vertex weight lines that follow the preamble,
+  // which ends at byte 'offset' of the file, to the binary format. Pins are
+  // numbered from pinBase in the file. With oneWeightPerLine each vertex
+  // weight line holds a single weight, otherwise weights may share lines.
+  void writeBinary(const char *filename, long offset, int pinBase,
+                   bool oneWeightPerLine, ofstream &out_stream);
+
 public:
   HypergraphTextFileReader();
   ~HypergraphTextFileReader();
@@ -13,6 +13,7 @@
 // ###
 
 #include "TextFileReader.hpp"
+#include "ChunkedTextReader.hpp"
 #include "StringUtils.hpp"
 
 using namespace std;
@@ -32,7 +33,8 @@ public:
 
   void readMatrix(const char *filename);
   void readPreamble(ifstream &in_stream);
-  void readMatrix(ifstream &in_stream);
+  // Reads the entries following the preamble, which ends at byte 'offset'.
+  void readMatrix(const char *filename, long offset);
   void skipComments(ifstream &in_stream);
 };
 
@@ -0,0 +1,76 @@
+#ifndef _PARA_FILE_WRITER_HPP
+#define _PARA_FILE_WRITER_HPP
+
+// ### ParaFileWriter.hpp ###
+//
+// Writes one '<file>-<i>' part file for parkway. Hyperedge data is appended
+// through a bounded buffer and either written by the caller or queued for a
+// shared set of writer threads (ParaWriterThreads). The data length in the
+// part file's header is patched in once all hyperedges have been written.
+//
+// ###
+
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+class ParaFileWriter;
+
+// A fixed number of threads writing the queued buffers of any number of
+// part files. A part file is handled by one thread at a time, so its buffers
+// are written in order.
+class ParaWriterThreads {
+
+protected:
+  vector<thread> workers;
+  mutex readyLock;
+  condition_variable readyChanged;
+  deque<ParaFileWriter *> ready;
+  bool stopping;
+
+  void work();
+
+public:
+  ParaWriterThreads(int threads);
+  ~ParaWriterThreads();
+
+  void schedule(ParaFileWriter *writer);
+};
+
+class ParaFileWriter {
+
+protected:
+  ofstream out_stream;
+  vector<int> buffer;
+  long dataLength;
+  int bufferLength;
+
+  ParaWriterThreads *writerThreads;
+  bool scheduled;
+  mutex queueLock;
+  condition_variable queueChanged;
+  deque<vector<int> > pending;
+
+  void flushBuffer();
+
+public:
+  // With writerThreads, full buffers are written by those threads, otherwise
+  // by the caller.
+  ParaFileWriter(const char *p_file, int numVerts, int numLocVerts,
+                 const int *vertWts, ParaWriterThreads *threads, int bufLen);
+  ~ParaFileWriter();
+
+  inline bool isOpen() const { return out_stream.is_open(); }
+  inline long getDataLength() const { return dataLength; }
+
+  void write(const int *data, int length);
+  void writeQueued();
+  void close();
+};
+
+#endif
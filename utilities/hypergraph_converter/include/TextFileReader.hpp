@@ -13,6 +13,7 @@
 // ###
 
 #include <fstream>
+#include <string>
 #include <cstring>
 #include <cstdio>
 #include "data_structures/dynamic_array.hpp"
@@ -21,12 +22,13 @@ using parkway::data_structures::dynamic_array;
 
 class TextFileReader {
  private:
-  static int maxLength;
   static int maxPinsInChunk;
+  static int numReaderThreads;
 
  protected:
   int length;
   dynamic_array<char> buffer;
+  std::string line;
 
  public:
   TextFileReader();
@@ -34,12 +36,17 @@ class TextFileReader {
 
   void getLine(std::ifstream &input_stream);
 
-  static inline int getMaxLength() { return maxLength; }
   static inline int getMaxPinsInChunk() { return maxPinsInChunk; }
-  static inline void setMaxLength(int max) { maxLength = max; }
   static inline void setMaxPinsInChunk(int max) {
     maxPinsInChunk = max;
   }
+
+  // Threads used to tokenize files read with a ChunkedTextReader; 0 uses
+  // one per hardware thread.
+  static inline int getNumReaderThreads() { return numReaderThreads; }
+  static inline void setNumReaderThreads(int threads) {
+    numReaderThreads = threads;
+  }
 };
 
 #endif
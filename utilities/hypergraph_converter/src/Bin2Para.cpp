@@ -12,35 +12,38 @@
 // ###
 
 #include "Bin2Para.hpp"
+#include <climits>
+#include <memory>
 
-Bin2Para::Bin2Para(int numP) : FromBinConverter() {
+// Number of ints buffered for the open part file before being written out.
+static const int defaultBufferLength = 1 << 20;
+
+Bin2Para::Bin2Para(int numP, bool writerThreads) : FromBinConverter() {
   numProcessors = numP;
+  bufferLength = defaultBufferLength;
+  useWriterThreads = writerThreads;
   numHedges = 0;
-  numLocHedges = 0;
-  numLocVertices = 0;
 }
 
 Bin2Para::Bin2Para() : FromBinConverter() {
   numProcessors = 0;
+  bufferLength = defaultBufferLength;
+  useWriterThreads = false;
   numHedges = 0;
-  numLocHedges = 0;
-  numLocVertices = 0;
 }
 
 Bin2Para::~Bin2Para() {}
 
 void Bin2Para::convert(const char *filename) {
   ifstream in_stream;
-  ofstream out_stream;
-
-  char para_file[512];
 
-  int i;
   int inLoc;
   int inData;
+  int chunkStart;
   int numHedgesPerProc;
-  int numVertsPerProc;
-  int minVertexIndex;
+  int part;
+  long numReadHedges;
+  long partEnd;
 
   in_stream.open(filename, ifstream::in | ifstream::binary);
 
@@ -53,97 +56,141 @@ void Bin2Para::convert(const char *filename) {
   readPreamble(in_stream);
 
   numHedgesPerProc = numHedges / numProcessors;
-  numVertsPerProc = numVerts / numProcessors;
 
   readInVertexWts(in_stream);
 
-  inLoc = in_stream.tellg();
-  inData = 0;
+  // Declared before the writer, so that it outlives its final flush.
+  unique_ptr<ParaWriterThreads> writerThreads;
+
+  if (useWriterThreads)
+    writerThreads.reset(new ParaWriterThreads(1));
 
-  for (i = 0; i < numProcessors; ++i) {
-    sprintf(para_file, "%s-%d", filename, i);
+  // Hyperedges are assigned in contiguous ranges, the last part also taking
+  // the remainder, so the part files are written one after another and only
+  // one of them is open at a time.
+  unique_ptr<ParaFileWriter> writer;
 
-    minVertexIndex = numVertsPerProc * i;
+  part = 0;
+  partEnd = numProcessors == 1 ? numHedges : numHedgesPerProc;
+  numReadHedges = 0;
+
+  openPart(writer, filename, 0, writerThreads.get());
+
+  while (numReadHedges < numHedges) {
+    readInHedgeData(in_stream, inLoc);
 
-    if (i == numProcessors - 1) {
-      numLocVertices = numVertsPerProc + numVerts % numProcessors;
-      numLocHedges = numHedgesPerProc + numHedges % numProcessors;
-    } else {
-      numLocVertices = numVertsPerProc;
-      numLocHedges = numHedgesPerProc;
+    if (dataLength <= 0 || !in_stream.good()) {
+      cout << "error reading hyperedge chunk from " << filename << endl;
+      exit(1);
     }
 
-    buildParaFile(in_stream, out_stream, para_file, inLoc, inData,
-                  minVertexIndex);
-  }
+    const int *data = hEdgeData.data();
+    checkPinRange(0, dataLength);
 
-  in_stream.close();
-}
+    // Write each run of hyperedges belonging to the same part as one block.
+    inData = 0;
+    chunkStart = 0;
 
-void Bin2Para::buildParaFile(ifstream &in_stream, ofstream &out_stream,
-                             const char *p_file, int &inStream, int &inData,
-                             int minVertIdx) {
-  int i;
+    while (inData < dataLength) {
+      if (numReadHedges == partEnd && part < numProcessors - 1) {
+        if (inData > chunkStart)
+          writer->write(data + chunkStart, inData - chunkStart);
 
-  int pin;
-  int chunkLength;
-  int outLen;
-  int numReadHedges;
+        chunkStart = inData;
+        closePart(writer, part);
+        openPart(writer, filename, ++part, writerThreads.get());
+        partEnd = part == numProcessors - 1 ? numHedges
+                                            : partEnd + numHedgesPerProc;
+        continue;
+      }
 
-  dynamic_array<int> outHedgeData;
+      inData += data[inData];
+      ++numReadHedges;
+    }
 
-  out_stream.open(p_file, ofstream::out | ofstream::binary);
+    if (inData > chunkStart)
+      writer->write(data + chunkStart, inData - chunkStart);
+  }
 
-  if (!out_stream.is_open()) {
-    cout << "error opening " << p_file << endl;
-    in_stream.close();
-    exit(1);
+  in_stream.close();
+
+  // Parts left without hyperedges still need their files.
+  closePart(writer, part);
+
+  while (++part < numProcessors) {
+    openPart(writer, filename, part, writerThreads.get());
+    closePart(writer, part);
   }
+}
 
-  out_stream.write((char *)(&numVerts), sizeof(int));
-  out_stream.write((char *)(&numLocVertices), sizeof(int));
+void Bin2Para::openPart(unique_ptr<ParaFileWriter> &writer,
+                        const char *filename, int part,
+                        ParaWriterThreads *writerThreads) {
+  char para_file[512];
+  int numVertsPerProc = numVerts / numProcessors;
+  int numLocVertices = numVertsPerProc;
 
-  numReadHedges = 0;
-  outLen = 0;
+  if (part == numProcessors - 1)
+    numLocVertices += numVerts % numProcessors;
 
-  for (; numReadHedges < numLocHedges;) {
-    if (inData == 0)
-      readInHedgeData(in_stream, inStream);
+  sprintf(para_file, "%s-%d", filename, part);
 
-    for (; inData < dataLength;) {
-      chunkLength = hEdgeData[inData];
+  writer.reset(new ParaFileWriter(para_file, numVerts, numLocVertices,
+                                  &vWeights[numVertsPerProc * part],
+                                  writerThreads, bufferLength));
 
-      outHedgeData.assign(outLen++, chunkLength);
-      outHedgeData.assign(outLen++, hEdgeData[inData + 1]);
+  if (!writer->isOpen()) {
+    cout << "error opening " << para_file << endl;
+    exit(1);
+  }
+}
 
-      for (i = 2; i < chunkLength; ++i) {
-        pin = hEdgeData[inData + i];
+void Bin2Para::closePart(unique_ptr<ParaFileWriter> &writer, int part) {
+  if (writer->getDataLength() > INT_MAX) {
+    cout << "part " << part << " has more than " << INT_MAX
+         << " elements of hyperedge data - use more processors" << endl;
+    exit(1);
+  }
 
-        if (pin < 0 || pin >= numVerts) {
-          cout << "pin = " << pin << ", numVerts = " << numVerts << endl;
-          exit(1);
-        }
+  writer->close();
+  writer.reset();
+}
 
-        outHedgeData.assign(outLen++, pin);
-      }
+void Bin2Para::checkPinRange(int chunkStart, int chunkEnd) {
+  int i;
+  int j;
+  int chunkLength;
+  bool outOfRange = false;
 
-      inData += chunkLength;
-      ++numReadHedges;
+  unsigned int limit = static_cast<unsigned int>(numVerts);
 
-      if (numReadHedges == numLocHedges)
-        break;
+  // Accumulate the range check over whole hyperedges and only look for the
+  // offending pin once a chunk is known to contain one.
+  for (i = chunkStart; i < chunkEnd; i += chunkLength) {
+    chunkLength = hEdgeData[i];
+
+    if (chunkLength < 2 || i + chunkLength > chunkEnd) {
+      cout << "corrupt hyperedge block of length " << chunkLength << endl;
+      exit(1);
     }
 
-    if (inData == dataLength)
-      inData = 0;
+    const int *pins = hEdgeData.data() + i + 2;
+    for (j = 0; j < chunkLength - 2; ++j)
+      outOfRange |= static_cast<unsigned int>(pins[j]) >= limit;
   }
 
-  out_stream.write((char *)(&outLen), sizeof(int));
-  out_stream.write((char *)(&vWeights[minVertIdx]),
-                   sizeof(int) * numLocVertices);
-  out_stream.write((char *)(outHedgeData.data()), sizeof(int) * outLen);
+  if (!outOfRange)
+    return;
 
-  out_stream.close();
+  for (i = chunkStart; i < chunkEnd; i += hEdgeData[i]) {
+    for (j = i + 2; j < i + hEdgeData[i]; ++j) {
+      if (hEdgeData[j] < 0 || hEdgeData[j] >= numVerts) {
+        cout << "pin = " << hEdgeData[j] << ", numVerts = " << numVerts
+             << endl;
+        exit(1);
+      }
+    }
+  }
 }
 
 #endif
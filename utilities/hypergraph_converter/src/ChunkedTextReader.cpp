@@ -0,0 +1,248 @@
+#ifndef _CHUNKED_TEXT_READER_CPP
+#define _CHUNKED_TEXT_READER_CPP
+
+// ### ChunkedTextReader.cpp ###
+//
+// ###
+
+#include "ChunkedTextReader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Bytes of the file tokenized by each thread per window.
+static const long bytesPerThread = 1L << 24;
+
+// Windows shorter than this many bytes per thread use fewer threads.
+static const long minPieceLength = 1L << 20;
+
+ChunkedTextReader::ChunkedTextReader(int threads) {
+  fileDescriptor = -1;
+  fileData = nullptr;
+  fileLength = 0;
+  position = 0;
+
+  numThreads = threads > 0 ? threads : thread::hardware_concurrency();
+  if (numThreads < 1)
+    numThreads = 1;
+
+  windowLength = bytesPerThread * numThreads;
+
+  pieceOffsets.resize(numThreads);
+  pieceValues.resize(numThreads);
+  recordOffsets.push_back(0);
+}
+
+ChunkedTextReader::~ChunkedTextReader() { close(); }
+
+bool ChunkedTextReader::open(const char *filename, long offset) {
+  struct stat info;
+
+  close();
+
+  fileDescriptor = ::open(filename, O_RDONLY);
+
+  if (fileDescriptor < 0)
+    return false;
+
+  if (fstat(fileDescriptor, &info) != 0) {
+    close();
+    return false;
+  }
+
+  fileLength = info.st_size;
+  position = min(offset, fileLength);
+
+  if (fileLength > 0) {
+    void *data =
+        mmap(nullptr, fileLength, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    if (data == MAP_FAILED) {
+      close();
+      return false;
+    }
+
+    madvise(data, fileLength, MADV_SEQUENTIAL);
+    fileData = static_cast<const char *>(data);
+  }
+
+  return true;
+}
+
+void ChunkedTextReader::close() {
+  if (fileData)
+    munmap(const_cast<char *>(fileData), fileLength);
+
+  if (fileDescriptor >= 0)
+    ::close(fileDescriptor);
+
+  fileDescriptor = -1;
+  fileData = nullptr;
+  fileLength = 0;
+  position = 0;
+}
+
+long ChunkedTextReader::lineEnd(long from) const {
+  // ###
+  // the first line boundary at or after 'from': either 'from' follows a
+  // newline or it is moved past the next one
+  // ###
+
+  if (from <= 0 || from >= fileLength)
+    return min(max(from, 0L), fileLength);
+
+  const void *newline =
+      memchr(fileData + from - 1, '\n', fileLength - from + 1);
+
+  return newline ? static_cast<const char *>(newline) - fileData + 1
+                 : fileLength;
+}
+
+void ChunkedTextReader::tokenize(long begin, long end, int maxValuesPerRecord,
+                                 vector<int> &offsets,
+                                 vector<int> &vals) const {
+  const char *p = fileData + begin;
+  const char *last = fileData + end;
+
+  offsets.clear();
+  vals.clear();
+  offsets.push_back(0);
+
+  while (p < last) {
+    int numInRecord = 0;
+
+    while (p < last && *p != '\n') {
+      unsigned int digit = static_cast<unsigned char>(*p) - '0';
+
+      if (digit < 10) {
+        unsigned int number = digit;
+
+        while (++p < last &&
+               (digit = static_cast<unsigned char>(*p) - '0') < 10)
+          number = number * 10 + digit;
+
+        vals.push_back(static_cast<int>(number));
+
+        if (++numInRecord == maxValuesPerRecord)
+          break;
+      } else if (*p == '%') {
+        break;
+      } else {
+        ++p;
+      }
+    }
+
+    if (p < last && *p != '\n') {
+      // a comment or the rest of a record that is not kept
+      const void *newline = memchr(p, '\n', last - p);
+      p = newline ? static_cast<const char *>(newline) : last;
+    }
+
+    if (p < last)
+      ++p;
+
+    if (numInRecord > 0)
+      offsets.push_back(vals.size());
+  }
+}
+
+void ChunkedTextReader::stitch(int piece, long recordBase, long valueBase) {
+  const vector<int> &offsets = pieceOffsets[piece];
+  const vector<int> &vals = pieceValues[piece];
+  int numRecords = offsets.size() - 1;
+
+  for (int i = 1; i <= numRecords; ++i)
+    recordOffsets[recordBase + i] = valueBase + offsets[i];
+
+  copy(vals.begin(), vals.end(), values.begin() + valueBase);
+}
+
+bool ChunkedTextReader::readWindow(int maxValuesPerRecord) {
+  int i;
+  int numPieces;
+
+  long windowEnd;
+  long numRecords;
+  long numValues;
+
+  recordOffsets.resize(1);
+  values.clear();
+
+  if (position >= fileLength)
+    return false;
+
+  windowEnd = lineEnd(min(position + windowLength, fileLength));
+
+  numPieces = (windowEnd - position) / minPieceLength;
+  numPieces = max(1, min(numPieces, numThreads));
+
+  // ###
+  // split the window at line boundaries and tokenize the pieces
+  // ###
+
+  vector<long> bounds(numPieces + 1);
+
+  bounds[0] = position;
+  bounds[numPieces] = windowEnd;
+
+  for (i = 1; i < numPieces; ++i) {
+    long split = position + (windowEnd - position) * i / numPieces;
+    bounds[i] = min(max(lineEnd(split), bounds[i - 1]), windowEnd);
+  }
+
+  vector<thread> workers;
+
+  for (i = 1; i < numPieces; ++i) {
+    workers.push_back(thread([this, i, &bounds, maxValuesPerRecord]() {
+      tokenize(bounds[i], bounds[i + 1], maxValuesPerRecord, pieceOffsets[i],
+               pieceValues[i]);
+    }));
+  }
+
+  tokenize(bounds[0], bounds[1], maxValuesPerRecord, pieceOffsets[0],
+           pieceValues[0]);
+
+  for (auto &worker : workers)
+    worker.join();
+
+  workers.clear();
+
+  // ###
+  // stitch the pieces together
+  // ###
+
+  vector<long> recordBase(numPieces + 1, 0);
+  vector<long> valueBase(numPieces + 1, 0);
+
+  for (i = 0; i < numPieces; ++i) {
+    recordBase[i + 1] = recordBase[i] + pieceOffsets[i].size() - 1;
+    valueBase[i + 1] = valueBase[i] + pieceValues[i].size();
+  }
+
+  numRecords = recordBase[numPieces];
+  numValues = valueBase[numPieces];
+
+  recordOffsets.resize(numRecords + 1);
+  values.resize(numValues);
+
+  for (i = 1; i < numPieces; ++i) {
+    workers.push_back(thread([this, i, &recordBase, &valueBase]() {
+      stitch(i, recordBase[i], valueBase[i]);
+    }));
+  }
+
+  stitch(0, recordBase[0], valueBase[0]);
+
+  for (auto &worker : workers)
+    worker.join();
+
+  position = windowEnd;
+
+  return true;
+}
+
+#endif
@@ -67,6 +67,14 @@ int main(int argc, char **argv) {
            "used by" << endl
         << "\t      <number of processes> processes when running parkway"
         << endl
+        << "\t -threads <1 or 0>" << endl
+        << "\t    - when converting to <number of processes> files, write the "
+           "files" << endl
+        << "\t      from a separate writer thread (default 0)" << endl
+        << "\t -readers <number of threads>" << endl
+        << "\t    - number of threads tokenizing hmetis, patoh and "
+           "MatrixMarket files" << endl
+        << "\t      (default 0, one per hardware thread)" << endl
         << "\t -matrix <1 or 0>" << endl
         << "\t    - signifies if the file represents a matrix or not. If it "
            "does not" << endl
@@ -88,6 +96,8 @@ int main(int argc, char **argv) {
   int code;
   int numP;
   int mtx;
+  int threads;
+  int readers;
 
   code = StringUtils::getParameterAsInteger(argc, argv, "-form");
   mtx = StringUtils::getParameterAsInteger(argc, argv, "-matrix");
@@ -104,6 +114,10 @@ int main(int argc, char **argv) {
   }
 
   numP = StringUtils::getParameterAsInteger(argc, argv, "-np");
+  threads = StringUtils::getParameterAsInteger(argc, argv, "-threads", 0);
+  readers = StringUtils::getParameterAsInteger(argc, argv, "-readers", 0);
+
+  TextFileReader::setNumReaderThreads(readers);
 
   if (code == 1) {
     HMeTiS2Bin converter;
@@ -153,7 +167,7 @@ int main(int argc, char **argv) {
       exit(1);
     }
 
-    Bin2Para converter(numP);
+    Bin2Para converter(numP, threads == 1);
     converter.convert(argv[argc - 1]);
   }
 
@@ -20,10 +20,7 @@ HMeTiS2Bin::~HMeTiS2Bin() {}
 void HMeTiS2Bin::convert(const char *filename) {
   char bin_file[512];
 
-  int maxPinsRead = TextFileReader::getMaxPinsInChunk();
-  int numHedgesRead;
-  int numPinsRead;
-  int binPreAmble[3];
+  long preambleEnd;
 
   ifstream in_stream;
   ofstream out_stream;
@@ -35,73 +32,26 @@ void HMeTiS2Bin::convert(const char *filename) {
     exit(1);
   }
 
+  readPreamble(in_stream);
+
+  // ###
+  // the rest of the file is tokenized in parallel from the end of the
+  // preamble
+  // ###
+
+  preambleEnd = in_stream.tellg();
+  in_stream.close();
+
   sprintf(bin_file, "%s.bin", filename);
   out_stream.open(bin_file, ofstream::out | ofstream::binary);
 
   if (!out_stream.is_open()) {
     cout << "error opening " << bin_file << endl;
-    in_stream.close();
     exit(1);
   }
 
-  readPreamble(in_stream);
-
-  numPins = computeNumPins(in_stream);
-
-  binPreAmble[0] = numVertices;
-  binPreAmble[1] = numHedges;
-  binPreAmble[2] = numPins;
+  writeBinary(filename, preambleEnd, 1, true, out_stream);
 
-  out_stream.write((char *)(&binPreAmble), sizeof(int) * 3);
-
-  numPinsRead = 0;
-  numHedgesRead = 0;
-
-  while (!in_stream.eof() && numHedgesRead < numHedges) {
-    if (numPinsRead == 0) {
-      resetConverterParameters();
-      addLengthParameter();
-    }
-
-    getLine(in_stream);
-    numHedgesRead += processHedgeLine(buffer.data(), numPinsRead);
-
-    if (numPinsRead > maxPinsRead || numHedgesRead == numHedges) {
-      setLengthParameter();
-      out_stream.write((char *)(hEdgeData.data()),
-                       sizeof(int) * dataLength);
-      numPinsRead = 0;
-    }
-  }
-
-  if (numHedgesRead < numHedges)
-    cout << "warning - could not read " << numHedges << " hyperedges" << endl;
-
-  if (wtsOnVertices) {
-    resetConverterParameters();
-
-    while (!in_stream.eof() && numVerts < numVertices) {
-      getLine(in_stream);
-      processVertLine(buffer.data());
-    }
-
-    if (numVerts < numVertices) {
-      cout << "warning - do not have all vertex weights" << endl;
-      in_stream.close();
-      out_stream.close();
-      exit(1);
-    }
-  } else {
-    vWeights.reserve(numVertices);
-    numVerts = numVertices;
-
-    for (int i = 0; i < numVertices; ++i)
-      vWeights[i] = 1;
-  }
-
-  out_stream.write((char *)(vWeights.data()), sizeof(int) * numVertices);
-
-  in_stream.close();
   out_stream.close();
 }
 
@@ -203,26 +153,6 @@ int HMeTiS2Bin::processHedgeLine(char *line, int &numP) {
     return 0;
 }
 
-int HMeTiS2Bin::countPinsInLine(char *line, int &nP) {
-  StringUtils::skipNonDigits(line, '%');
-
-  if (*line) {
-    if (wtsOnHedges) {
-      StringUtils::skipDigits(line);
-      StringUtils::skipNonDigits(line, '%');
-    }
-
-    while (*line) {
-      StringUtils::skipDigits(line);
-      StringUtils::skipNonDigits(line, '%');
-      ++nP;
-    }
-
-    return 1;
-  } else
-    return 0;
-}
-
 int HMeTiS2Bin::processVertLine(char *line) {
   StringUtils::skipNonDigits(line, '%');
 
@@ -233,19 +163,4 @@ int HMeTiS2Bin::processVertLine(char *line) {
     return 0;
 }
 
-int HMeTiS2Bin::computeNumPins(ifstream &in_stream) {
-  int loc = in_stream.tellg();
-  int numPins = 0;
-  int numHedgesRead = 0;
-
-  while (!in_stream.eof() && numHedgesRead < numHedges) {
-    getLine(in_stream);
-    numHedgesRead += countPinsInLine(buffer.data(), numPins);
-  }
-
-  in_stream.seekg(loc, ios::beg);
-
-  return numPins;
-}
-
 #endif
@@ -23,4 +23,136 @@ HypergraphTextFileReader::HypergraphTextFileReader() : TextFileReader() {
 
 HypergraphTextFileReader::~HypergraphTextFileReader() {}
 
+void HypergraphTextFileReader::writeBinary(const char *filename, long offset,
+                                           int pinBase, bool oneWeightPerLine,
+                                           ofstream &out_stream) {
+  int maxPinsRead = TextFileReader::getMaxPinsInChunk();
+  int numHedgesRead = 0;
+  int numPinsRead = 0;
+  int numRecords;
+  int recordLength;
+  int hEdgeWeight;
+  int binPreAmble[3];
+  int pin;
+  int i;
+  int j;
+
+  const int *record;
+  long preambleLoc;
+
+  vector<int> hEdgeChunk(1, -1);
+  vector<int> vertWts;
+
+  ChunkedTextReader reader(TextFileReader::getNumReaderThreads());
+
+  if (!reader.open(filename, offset)) {
+    cout << "error opening " << filename << endl;
+    out_stream.close();
+    exit(1);
+  }
+
+  // ###
+  // the number of pins is only known once all hyperedges have been read,
+  // it is patched into the preamble at the end
+  // ###
+
+  numPins = 0;
+  binPreAmble[0] = numVertices;
+  binPreAmble[1] = numHedges;
+  binPreAmble[2] = numPins;
+
+  preambleLoc = out_stream.tellp();
+  out_stream.write((char *)(&binPreAmble), sizeof(int) * 3);
+
+  while ((numHedgesRead < numHedges ||
+          (wtsOnVertices && static_cast<int>(vertWts.size()) < numVertices)) &&
+         reader.readWindow()) {
+    numRecords = reader.getNumRecords();
+
+    for (i = 0; i < numRecords && numHedgesRead < numHedges; ++i) {
+      record = reader.getRecord(i);
+      recordLength = reader.getRecordLength(i);
+      hEdgeWeight = 1;
+
+      if (wtsOnHedges) {
+        hEdgeWeight = *record++;
+        --recordLength;
+      }
+
+      if (recordLength == 0)
+        cout << "warning - hyperedge with no vertices" << endl;
+
+      hEdgeChunk.push_back(recordLength + 2);
+      hEdgeChunk.push_back(hEdgeWeight);
+
+      for (j = 0; j < recordLength; ++j) {
+        pin = record[j] - pinBase;
+
+        if (pin < 0 || pin >= numVertices) {
+          cout << "pin = " << pin << ", numVertices = " << numVertices << endl;
+          exit(1);
+        }
+
+        hEdgeChunk.push_back(pin);
+      }
+
+      numPinsRead += recordLength;
+      ++numHedgesRead;
+
+      if (numPinsRead > maxPinsRead || numHedgesRead == numHedges) {
+        hEdgeChunk[0] = hEdgeChunk.size() - 1;
+        out_stream.write((char *)(hEdgeChunk.data()),
+                         sizeof(int) * hEdgeChunk.size());
+        hEdgeChunk.resize(1);
+        numPins += numPinsRead;
+        numPinsRead = 0;
+      }
+    }
+
+    // ###
+    // the records after the hyperedges are vertex weights
+    // ###
+
+    for (; i < numRecords && wtsOnVertices &&
+           static_cast<int>(vertWts.size()) < numVertices;
+         ++i) {
+      record = reader.getRecord(i);
+      recordLength = oneWeightPerLine ? 1 : reader.getRecordLength(i);
+
+      for (j = 0; j < recordLength &&
+                  static_cast<int>(vertWts.size()) < numVertices;
+           ++j)
+        vertWts.push_back(record[j]);
+    }
+  }
+
+  if (numHedgesRead < numHedges) {
+    cout << "warning - could not read " << numHedges << " hyperedges" << endl;
+
+    if (hEdgeChunk.size() > 1) {
+      hEdgeChunk[0] = hEdgeChunk.size() - 1;
+      out_stream.write((char *)(hEdgeChunk.data()),
+                       sizeof(int) * hEdgeChunk.size());
+      numPins += numPinsRead;
+    }
+  }
+
+  if (wtsOnVertices) {
+    if (static_cast<int>(vertWts.size()) < numVertices) {
+      cout << "warning - do not have all vertex weights" << endl;
+      out_stream.close();
+      exit(1);
+    }
+  } else {
+    vertWts.assign(numVertices, 1);
+  }
+
+  out_stream.write((char *)(vertWts.data()), sizeof(int) * numVertices);
+
+  binPreAmble[2] = numPins;
+  out_stream.seekp(preambleLoc + 2 * sizeof(int), ofstream::beg);
+  out_stream.write((char *)(&binPreAmble[2]), sizeof(int));
+  out_stream.seekp(0, ofstream::end);
+}
+
 #endif
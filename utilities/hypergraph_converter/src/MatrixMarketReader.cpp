@@ -27,6 +27,7 @@ MatrixMarketReader::~MatrixMarketReader() {}
 
 void MatrixMarketReader::readMatrix(const char *filename) {
   ifstream in_stream;
+  long preambleEnd;
 
   in_stream.open(filename, ifstream::in);
 
@@ -36,9 +37,11 @@ void MatrixMarketReader::readMatrix(const char *filename) {
   }
 
   readPreamble(in_stream);
-  readMatrix(in_stream);
 
+  preambleEnd = in_stream.tellg();
   in_stream.close();
+
+  readMatrix(filename, preambleEnd);
 }
 
 void MatrixMarketReader::readPreamble(ifstream &in_stream) {
@@ -58,55 +61,77 @@ void MatrixMarketReader::readPreamble(ifstream &in_stream) {
   numPins = StringUtils::stringToDigit(data);
 }
 
-void MatrixMarketReader::readMatrix(ifstream &in_stream) {
+void MatrixMarketReader::readMatrix(const char *filename, long offset) {
   int i;
   int j;
 
-  char *data;
   int hEdge;
   int vertex;
-  int pointInFile;
+  int numRecords;
+  int numPinsRead;
+
+  const int *record;
 
   dynamic_array<int> hEdgeLens(numHyperedges);
 
-  pinList.reserve(numPins);
-  hEdgeOffsets.reserve(numHyperedges + 1);
+  ChunkedTextReader reader(TextFileReader::getNumReaderThreads());
+
+  if (!reader.open(filename, offset)) {
+    cout << "error opening " << filename << endl;
+    exit(1);
+  }
 
-  pointInFile = in_stream.tellg();
+  pinList.resize(numPins);
+  hEdgeOffsets.resize(numHyperedges + 1);
 
   for (i = 0; i < numHyperedges; ++i)
     hEdgeLens[i] = 0;
 
-  for (i = 0; i < numPins; ++i) {
-    getLine(in_stream);
-    data = buffer.data();
+  // ###
+  // two passes over the entries, only the row and column of each are
+  // tokenized: the first counts the length of each column, the second
+  // places the rows
+  // ###
 
-    StringUtils::skipNonDigits(data);
-    vertex = StringUtils::stringToDigit(data) - 1;
+  numPinsRead = 0;
 
-    if (vertex < 0 || vertex >= numVertices) {
-      cout << "read vertex = " << vertex << ", numVertices = " << numVertices
-           << endl;
+  while (numPinsRead < numPins && reader.readWindow(2)) {
+    numRecords = reader.getNumRecords();
 
-      in_stream.close();
-      exit(1);
-    }
+    for (i = 0; i < numRecords && numPinsRead < numPins; ++i) {
+      record = reader.getRecord(i);
 
-    StringUtils::skipNonDigits(data);
-    hEdge = StringUtils::stringToDigit(data) - 1;
+      if (reader.getRecordLength(i) < 2) {
+        cout << "entry " << numPinsRead << " does not have a column" << endl;
+        exit(1);
+      }
 
-    if (hEdge < 0 || hEdge >= numHyperedges) {
-      cout << "read hyperedge = " << hEdge
-           << ", numHyperedges = " << numHyperedges << endl;
+      vertex = record[0] - 1;
 
-      in_stream.close();
-      exit(1);
-    }
+      if (vertex < 0 || vertex >= numVertices) {
+        cout << "read vertex = " << vertex << ", numVertices = " << numVertices
+             << endl;
+        exit(1);
+      }
+
+      hEdge = record[1] - 1;
 
-    ++hEdgeLens[hEdge];
+      if (hEdge < 0 || hEdge >= numHyperedges) {
+        cout << "read hyperedge = " << hEdge
+             << ", numHyperedges = " << numHyperedges << endl;
+        exit(1);
+      }
+
+      ++hEdgeLens[hEdge];
+      ++numPinsRead;
+    }
   }
 
-  in_stream.seekg(pointInFile, ios::beg);
+  if (numPinsRead < numPins) {
+    cout << "could only read " << numPinsRead << " of " << numPins
+         << " entries" << endl;
+    exit(1);
+  }
 
   i = 0;
   j = 0;
@@ -119,18 +144,21 @@ void MatrixMarketReader::readMatrix(ifstream &in_stream) {
 
   hEdgeOffsets[i] = j;
 
-  for (i = 0; i < numPins; ++i) {
-    getLine(in_stream);
-    data = buffer.data();
+  reader.seek(offset);
+  numPinsRead = 0;
 
-    StringUtils::skipNonDigits(data);
-    vertex = StringUtils::stringToDigit(data) - 1;
+  while (numPinsRead < numPins && reader.readWindow(2)) {
+    numRecords = reader.getNumRecords();
 
-    StringUtils::skipNonDigits(data);
-    hEdge = StringUtils::stringToDigit(data) - 1;
+    for (i = 0; i < numRecords && numPinsRead < numPins; ++i) {
+      record = reader.getRecord(i);
+      vertex = record[0] - 1;
+      hEdge = record[1] - 1;
 
-    pinList[hEdgeOffsets[hEdge] + hEdgeLens[hEdge]] = vertex;
-    ++hEdgeLens[hEdge];
+      pinList[hEdgeOffsets[hEdge] + hEdgeLens[hEdge]] = vertex;
+      ++hEdgeLens[hEdge];
+      ++numPinsRead;
+    }
   }
 }
 
@@ -23,10 +23,7 @@ PaToH2Bin::~PaToH2Bin() {}
 void PaToH2Bin::convert(const char *filename) {
   char bin_file[512];
 
-  int maxPinsRead = TextFileReader::getMaxPinsInChunk();
-  int numHedgesRead;
-  int numPinsRead;
-  int binPreAmble[3];
+  long preambleEnd;
 
   ifstream in_stream;
   ofstream out_stream;
@@ -38,78 +35,32 @@ void PaToH2Bin::convert(const char *filename) {
     exit(1);
   }
 
-  sprintf(bin_file, "%s.bin", filename);
-  out_stream.open(bin_file, ofstream::out | ofstream::binary);
-
-  if (!out_stream.is_open()) {
-    cout << "error opening " << bin_file << endl;
-    in_stream.close();
-    exit(1);
-  }
-
   readPreamble(in_stream);
 
   if (constraints != 1) {
     cout << "cannot deal with multiple vertex weight constraints" << endl;
-    out_stream.close();
     in_stream.close();
     exit(1);
   }
 
-  binPreAmble[0] = numVertices;
-  binPreAmble[1] = numHedges;
-  binPreAmble[2] = numPins;
-
-  out_stream.write((char *)(&binPreAmble), sizeof(int) * 3);
-
-  numPinsRead = 0;
-  numHedgesRead = 0;
-
-  while (!in_stream.eof() && numHedgesRead < numHedges) {
-    if (numPinsRead == 0) {
-      resetConverterParameters();
-      addLengthParameter();
-    }
-
-    getLine(in_stream);
-    numHedgesRead += processHedgeLine(buffer.data(), numPinsRead);
-
-    if (numPinsRead > maxPinsRead || numHedgesRead == numHedges) {
-      setLengthParameter();
-      out_stream.write((char *)(hEdgeData.data()),
-                       sizeof(int) * dataLength);
-      numPinsRead = 0;
-    }
-  }
-
-  if (numHedgesRead < numHedges)
-    cout << "warning - could not read " << numHedges << " hyperedges" << endl;
-
-  if (wtsOnVertices) {
-    resetConverterParameters();
+  // ###
+  // the rest of the file is tokenized in parallel from the end of the
+  // preamble
+  // ###
 
-    while (!in_stream.eof() && numVerts < numVertices) {
-      getLine(in_stream);
-      processVertLine(buffer.data());
-    }
+  preambleEnd = in_stream.tellg();
+  in_stream.close();
 
-    if (numVerts < numVertices) {
-      cout << "warning - do not have all vertex weights" << endl;
-      in_stream.close();
-      out_stream.close();
-      exit(1);
-    }
-  } else {
-    vWeights.reserve(numVertices);
-    numVerts = numVertices;
+  sprintf(bin_file, "%s.bin", filename);
+  out_stream.open(bin_file, ofstream::out | ofstream::binary);
 
-    for (int i = 0; i < numVertices; ++i)
-      vWeights[i] = 1;
+  if (!out_stream.is_open()) {
+    cout << "error opening " << bin_file << endl;
+    exit(1);
   }
 
-  out_stream.write((char *)(vWeights.data()), sizeof(int) * numVertices);
+  writeBinary(filename, preambleEnd, numScheme, false, out_stream);
 
-  in_stream.close();
   out_stream.close();
 }
 
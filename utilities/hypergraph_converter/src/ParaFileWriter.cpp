@@ -0,0 +1,160 @@
+#ifndef _PARA_FILE_WRITER_CPP
+#define _PARA_FILE_WRITER_CPP
+
+// ### ParaFileWriter.cpp ###
+//
+// ###
+
+#include "ParaFileWriter.hpp"
+
+// At most this many full buffers are queued for the writer threads before the
+// reader blocks, bounding the memory used per part file.
+static const unsigned int maxQueuedBuffers = 2;
+
+ParaWriterThreads::ParaWriterThreads(int threads) {
+  stopping = false;
+
+  for (int i = 0; i < threads; ++i)
+    workers.push_back(thread(&ParaWriterThreads::work, this));
+}
+
+ParaWriterThreads::~ParaWriterThreads() {
+  {
+    lock_guard<mutex> lock(readyLock);
+    stopping = true;
+  }
+  readyChanged.notify_all();
+
+  for (auto &worker : workers)
+    worker.join();
+}
+
+void ParaWriterThreads::schedule(ParaFileWriter *writer) {
+  {
+    lock_guard<mutex> lock(readyLock);
+    ready.push_back(writer);
+  }
+  readyChanged.notify_one();
+}
+
+void ParaWriterThreads::work() {
+  unique_lock<mutex> lock(readyLock);
+
+  while (true) {
+    readyChanged.wait(lock, [this] { return stopping || !ready.empty(); });
+
+    if (ready.empty())
+      return;
+
+    ParaFileWriter *writer = ready.front();
+    ready.pop_front();
+
+    lock.unlock();
+    writer->writeQueued();
+    lock.lock();
+  }
+}
+
+ParaFileWriter::ParaFileWriter(const char *p_file, int numVerts,
+                               int numLocVerts, const int *vertWts,
+                               ParaWriterThreads *threads, int bufLen) {
+  dataLength = 0;
+  bufferLength = bufLen;
+  writerThreads = threads;
+  scheduled = false;
+
+  out_stream.open(p_file, ofstream::out | ofstream::binary);
+
+  if (!out_stream.is_open())
+    return;
+
+  // The data length is not known until the end -- write a placeholder.
+  int header[3] = {numVerts, numLocVerts, 0};
+  out_stream.write((char *)(&header[0]), sizeof(int) * 3);
+  out_stream.write((char *)(vertWts), sizeof(int) * numLocVerts);
+
+  buffer.reserve(bufferLength);
+}
+
+ParaFileWriter::~ParaFileWriter() { close(); }
+
+void ParaFileWriter::write(const int *data, int length) {
+  if (buffer.size() + length > static_cast<size_t>(bufferLength))
+    flushBuffer();
+
+  if (length > bufferLength) {
+    // Oversized hyperedge: write it through rather than growing the buffer.
+    buffer.assign(data, data + length);
+    flushBuffer();
+  } else {
+    buffer.insert(buffer.end(), data, data + length);
+  }
+
+  dataLength += length;
+}
+
+void ParaFileWriter::flushBuffer() {
+  if (buffer.empty())
+    return;
+
+  if (!writerThreads) {
+    out_stream.write((char *)(buffer.data()), sizeof(int) * buffer.size());
+    buffer.clear();
+    return;
+  }
+
+  vector<int> full;
+  full.reserve(bufferLength);
+  full.swap(buffer);
+
+  bool schedule;
+  {
+    unique_lock<mutex> lock(queueLock);
+    queueChanged.wait(lock,
+                      [this] { return pending.size() < maxQueuedBuffers; });
+    pending.push_back(std::move(full));
+
+    // Only one writer thread at a time takes this file's buffers.
+    schedule = !scheduled;
+    scheduled = true;
+  }
+
+  if (schedule)
+    writerThreads->schedule(this);
+}
+
+void ParaFileWriter::writeQueued() {
+  unique_lock<mutex> lock(queueLock);
+
+  while (!pending.empty()) {
+    vector<int> data(std::move(pending.front()));
+    pending.pop_front();
+    queueChanged.notify_all();
+
+    lock.unlock();
+    out_stream.write((char *)(data.data()), sizeof(int) * data.size());
+    lock.lock();
+  }
+
+  scheduled = false;
+  queueChanged.notify_all();
+}
+
+void ParaFileWriter::close() {
+  if (!out_stream.is_open())
+    return;
+
+  flushBuffer();
+
+  if (writerThreads) {
+    unique_lock<mutex> lock(queueLock);
+    queueChanged.wait(lock, [this] { return !scheduled; });
+  }
+
+  int length = static_cast<int>(dataLength);
+  out_stream.seekp(sizeof(int) * 2, ofstream::beg);
+  out_stream.write((char *)(&length), sizeof(int));
+  out_stream.close();
+}
+
+#endif
@@ -14,19 +14,28 @@
 
 #include "TextFileReader.hpp"
 
-int TextFileReader::maxLength = 10000000;
 int TextFileReader::maxPinsInChunk = 10000000;
+int TextFileReader::numReaderThreads = 0;
 
 TextFileReader::TextFileReader() {
-  buffer.reserve(maxLength);
+  buffer.resize(1);
   length = 0;
 }
 
 TextFileReader::~TextFileReader() {}
 
 void TextFileReader::getLine(std::ifstream &input_stream) {
-  input_stream.getline(buffer.data(), maxLength);
-  length = strlen(buffer.data());
+  // ###
+  // lines are not limited in length, the buffer grows to fit the longest
+  // ###
+
+  std::getline(input_stream, line);
+  length = line.size();
+
+  if (buffer.size() <= static_cast<size_t>(length))
+    buffer.resize(length + 1);
+
+  memcpy(buffer.data(), line.c_str(), length + 1);
 }
 
 #endif